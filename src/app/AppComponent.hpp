@@ -8,14 +8,19 @@
 #include "utils/ConfigManager.hpp"
 #include "controllers/JobController.hpp"
 #include "controllers/EncodingTemplateController.hpp"
+#include "controllers/MetadataController.hpp"
 #include "PluginManager.hpp"
 #include "encoding/FFmpegEncodingService.hpp"
 #include "repositories/EncodingTemplateRepository.hpp"
 #include "repositories/JobRepository.hpp"
+#include "repositories/JobStatusWriter.hpp"
 #include "managers/EncodingTemplateManager.hpp"
 #include "managers/JobManager.hpp"
+#include "managers/MetadataManager.hpp"
 #include "interfaces/IEncodingService.hpp"
 #include "encoding/JobProcessor.hpp"
+#include "metadata/MetadataMerger.hpp"
+#include "repositories/MetadataCacheRepository.hpp"
 
 class AppComponent {
 public:
@@ -99,13 +104,65 @@ public:
         return std::make_shared<JobRepository>(database);
     }());
 
+    /**
+     *  JobStatusWriter component, buffering worker status updates in front of the jobs table
+     */
+    OATPP_CREATE_COMPONENT(std::shared_ptr<JobStatusWriter>, jobStatusWriter)([] {
+        OATPP_COMPONENT(std::shared_ptr<JobRepository>, jobRepository);
+        const auto settings = JobStatusWriter::loadSettings(ConfigManager::getInstance());
+        return std::make_shared<JobStatusWriter>(jobRepository, settings);
+    }());
+
+    /**
+     *  MetadataCache component, an in-memory LRU in front of the metadata_cache table
+     */
+    OATPP_CREATE_COMPONENT(std::shared_ptr<MetadataCache>, metadataCache)([] {
+        OATPP_COMPONENT(std::shared_ptr<PluginManager>, pluginManager);
+        const auto& config = ConfigManager::getInstance();
+        const auto capacity = config.get<std::size_t>("metadata.cache.capacity", 1024);
+        const auto maxAge = std::chrono::hours(24) * config.get<int>("metadata.cache.max_age_days", 30);
+        std::shared_ptr<MetadataCacheRepository> repository;
+        if (config.get<bool>("metadata.cache.persistent", true)) {
+            repository = std::make_shared<MetadataCacheRepository>(pluginManager->getDatabase());
+        }
+        return std::make_shared<MetadataCache>(capacity, repository, maxAge);
+    }());
+
+    /**
+     *  MetadataMerger component
+     */
+    OATPP_CREATE_COMPONENT(std::shared_ptr<MetadataMerger>, metadataMerger)([] {
+        OATPP_COMPONENT(std::shared_ptr<MetadataCache>, metadataCache);
+        const auto settings = MetadataMerger::loadSettings(ConfigManager::getInstance());
+        // Redirect targets of remote probes must pass the same allow-list as submitted inputs
+        auto checkRedirect = [allowList = Validation::InputAllowList::fromConfig()](const std::string& url) {
+            allowList.check(url);
+        };
+        return std::make_shared<MetadataMerger>(metadataCache, settings, checkRedirect);
+    }());
+
+    /**
+     *  MetadataManager component, probing batches on its own bounded thread pool
+     */
+    OATPP_CREATE_COMPONENT(std::shared_ptr<MetadataManager>, metadataManager)([] {
+        OATPP_COMPONENT(std::shared_ptr<MetadataMerger>, metadataMerger);
+        const auto& config = ConfigManager::getInstance();
+        const auto threads = config.get<std::size_t>("metadata.batch.threads", 8);
+        const auto maxItems = config.get<std::size_t>("metadata.batch.max_items", 1000);
+        return std::make_shared<MetadataManager>(metadataMerger, threads, maxItems,
+                                                 Validation::InputAllowList::fromConfig());
+    }());
+
     /**
      *  JobProcessor component
      */
     OATPP_CREATE_COMPONENT(std::shared_ptr<JobProcessor>, jobProcessor)([] {
         OATPP_COMPONENT(std::shared_ptr<IEncodingService>, encodingService);
         OATPP_COMPONENT(std::shared_ptr<JobRepository>, jobRepository);
-        return std::make_shared<JobProcessor>(encodingService, jobRepository);
+        OATPP_COMPONENT(std::shared_ptr<JobStatusWriter>, jobStatusWriter);
+        OATPP_COMPONENT(std::shared_ptr<MetadataMerger>, metadataMerger);
+        const auto settings = JobProcessor::loadSettings(ConfigManager::getInstance());
+        return std::make_shared<JobProcessor>(encodingService, jobRepository, jobStatusWriter, settings, metadataMerger);
     }());
 
     /**
@@ -115,7 +172,11 @@ public:
         OATPP_COMPONENT(std::shared_ptr<JobRepository>, jobRepository);
         OATPP_COMPONENT(std::shared_ptr<IEncodingService>, encodingService);
         OATPP_COMPONENT(std::shared_ptr<JobProcessor>, jobProcessor);
-        return std::make_shared<JobManager>(jobRepository, encodingService, jobProcessor);
+        auto jobManager = std::make_shared<JobManager>(jobRepository, encodingService, jobProcessor);
+        if (ConfigManager::getInstance().get<bool>("jobs.recover_on_start", true)) {
+            jobManager->recoverJobs();
+        }
+        return jobManager;
     }());
 
     /**
@@ -134,5 +195,10 @@ public:
         OATPP_COMPONENT(std::shared_ptr<EncodingTemplateManager>, encodingTemplateManager);
         const auto encodingTemplateController = std::make_shared<EncodingTemplateController>(encodingTemplateManager, apiObjectMapper);
         router->addController(encodingTemplateController);
+
+        // Create and register MetadataController
+        OATPP_COMPONENT(std::shared_ptr<MetadataManager>, metadataManager);
+        const auto metadataController = std::make_shared<MetadataController>(metadataManager, apiObjectMapper);
+        router->addController(metadataController);
     }
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "database/sqlite/SQLiteDatabase.hpp"
 #include "database/mariadb/MariaDBDatabase.hpp"
 #include "database/postgresql/PostgreSQLDatabase.hpp"
+#include "database/SchemaMigrator.hpp"
 #include "providers/AWSS3Provider.hpp"
 #include "encoding/FFmpegEncodingService.hpp"
 
@@ -31,6 +32,9 @@ void PluginManager::initialize() {
 
     if (database) {
         database->connect();
+        if (config.get<bool>("database.migrate_on_start", true)) {
+            SchemaMigrator(database).migrate();
+        }
     }
 
     LOG_INFO("PluginManager initialization complete.");
@@ -59,7 +63,16 @@ void PluginManager::loadDatabase(const std::string& databaseType) {
     const auto& config = ConfigManager::getInstance();
 
     if (databaseType == "sqlite") {
-        database = std::make_shared<SQLiteDatabase>(config.get<std::string>("database.sqlite.path", "default.db"));
+        SQLiteDatabase::Settings settings;
+        settings.statementCacheSize = config.get<size_t>("database.sqlite.statement_cache_size", settings.statementCacheSize);
+        settings.readConnections = config.get<size_t>("database.sqlite.read_connections", settings.readConnections);
+        settings.busyTimeout = std::chrono::milliseconds(
+            config.get<int>("database.sqlite.busy_timeout_ms", static_cast<int>(settings.busyTimeout.count())));
+        settings.readerAcquireTimeout = std::chrono::milliseconds(config.get<int>(
+            "database.sqlite.reader_acquire_timeout_ms", static_cast<int>(settings.readerAcquireTimeout.count())));
+        settings.checkpointInterval = std::chrono::milliseconds(
+            config.get<int>("database.sqlite.checkpoint_interval_ms", static_cast<int>(settings.checkpointInterval.count())));
+        database = std::make_shared<SQLiteDatabase>(config.get<std::string>("database.sqlite.path", "default.db"), settings);
     } else if (databaseType == "mariadb") {
         database = setupMariaDB(config);
     } else if (databaseType == "postgresql") {
@@ -70,19 +83,35 @@ void PluginManager::loadDatabase(const std::string& databaseType) {
 }
 
  std::shared_ptr<IDatabase> PluginManager::setupMariaDB(const ConfigManager& config) {
-    auto poolSize = config.get<size_t>("database.mariadb.pool_size", 10);
+    auto poolOptions = loadPoolOptions(config, "database.mariadb");
+    // mysql_ping costs a round trip, so only check connections that sat idle for a while.
+    poolOptions.validateAfterIdle = std::chrono::milliseconds(
+        config.get<int>("database.mariadb.pool.validate_after_idle_ms", 5000));
     auto host = config.get<std::string>("database.mariadb.host", "localhost");
     auto user = config.get<std::string>("database.mariadb.user", "root");
     auto password = config.get<std::string>("database.mariadb.password", "");
     auto dbname = config.get<std::string>("database.mariadb.database", "mydb");
     auto port = config.get<unsigned int>("database.mariadb.port", 3306);
 
-    return std::make_shared<MariaDBDatabase>(host, user, password, dbname, port, poolSize);
+    return std::make_shared<MariaDBDatabase>(host, user, password, dbname, port, poolOptions);
 }
 
  std::shared_ptr<IDatabase> PluginManager::setupPostgreSQL(const ConfigManager& config) {
-    auto poolSize = config.get<size_t>("database.postgresql.pool_size", 10);
+    auto poolOptions = loadPoolOptions(config, "database.postgresql");
     auto connInfo = config.get<std::string>("database.postgresql.conninfo", "dbname=mydb");
 
-    return std::make_shared<PostgreSQLDatabase>(connInfo, poolSize);
+    return std::make_shared<PostgreSQLDatabase>(connInfo, poolOptions);
+}
+
+ConnectionPoolOptions PluginManager::loadPoolOptions(const ConfigManager& config, const std::string& section) {
+    ConnectionPoolOptions options;
+    options.maxSize = config.get<size_t>(section + ".pool.max_size", config.get<size_t>(section + ".pool_size", options.maxSize));
+    options.minSize = config.get<size_t>(section + ".pool.min_size", options.minSize);
+    options.acquireTimeout = std::chrono::milliseconds(
+        config.get<int>(section + ".pool.acquire_timeout_ms", static_cast<int>(options.acquireTimeout.count())));
+    options.idleTimeout = std::chrono::milliseconds(
+        config.get<int>(section + ".pool.idle_timeout_ms", static_cast<int>(options.idleTimeout.count())));
+    options.validateAfterIdle = std::chrono::milliseconds(
+        config.get<int>(section + ".pool.validate_after_idle_ms", static_cast<int>(options.validateAfterIdle.count())));
+    return options;
 }
\ No newline at end of file
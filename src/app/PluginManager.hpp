@@ -2,6 +2,7 @@
 
 #include "interfaces/IEncodingService.hpp"
 #include "database/interfaces/IDatabase.hpp"
+#include "database/ConnectionPool.hpp"
 #include "utils/ConfigManager.hpp"
 
 /**
@@ -22,7 +23,9 @@ public:
      * @brief Initializes all plugins based on configuration.
      *
      * Loads each configured service (encoding, database) and establishes connections if needed.
-     * @throws std::runtime_error if any plugin fails to initialize.
+     * The database schema is then brought up to date with SchemaMigrator, unless
+     * "database.migrate_on_start" is false.
+     * @throws std::runtime_error if any plugin fails to initialize or a schema migration fails.
      */
     void initialize();
 
@@ -85,6 +88,15 @@ private:
      */
     static std::shared_ptr<IDatabase> setupPostgreSQL(const ConfigManager& config);
 
+    /**
+     * @brief Reads connection pool sizing and timeouts from a database section.
+     *
+     * @param config Reference to the ConfigManager instance.
+     * @param section Section such as "database.postgresql"; its legacy "pool_size" key sets the maximum size.
+     * @return ConnectionPoolOptions - Options for the backend's connection pool.
+     */
+    static ConnectionPoolOptions loadPoolOptions(const ConfigManager& config, const std::string& section);
+
     std::shared_ptr<IEncodingService> encodingService;  ///< Pointer to the encoding service instance.
     std::shared_ptr<IDatabase> database;                ///< Pointer to the database instance.
 };
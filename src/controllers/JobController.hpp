@@ -1,11 +1,76 @@
 #pragma once
 
 #include "managers/JobManager.hpp"
+#include "dto/DatabasePoolMetricsDto.hpp"
+#include "dto/JobBatchDto.hpp"
 #include "dto/JobDto.hpp"
+#include "dto/JobPageDto.hpp"
+#include "dto/SchedulerMetricsDto.hpp"
+#include "scheduling/TenantResolver.hpp"
+#include "utils/Logger.hpp"
 #include "oatpp/web/server/api/ApiController.hpp"
+#include "oatpp/web/protocol/http/outgoing/StreamingBody.hpp"
 #include "oatpp/core/macro/component.hpp"
 #include "oatpp/core/macro/codegen.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Serializes jobs from a JobRepository::PageCursor into a chunked HTTP response, one JSON line per job.
+ *
+ * Jobs are pulled from the cursor only when the previous line has been written out, so the response
+ * streams in memory bounded by one page however large the job table is.
+ */
+class JobExportReadCallback final : public oatpp::data::stream::ReadCallback {
+public:
+    JobExportReadCallback(std::unique_ptr<JobRepository::PageCursor> cursor,
+                          std::shared_ptr<oatpp::data::mapping::ObjectMapper> objectMapper)
+        : m_cursor(std::move(cursor)), m_objectMapper(std::move(objectMapper)) {}
+
+    oatpp::v_io_size read(void* buffer, const v_buff_size count, oatpp::async::Action& /*action*/) override {
+        while (m_offset == m_pending.size()) {
+            if (!m_cursor) {
+                return 0;  // All jobs sent
+            }
+            std::shared_ptr<JobDto> job;
+            try {
+                job = m_cursor->next();
+            } catch (const std::exception& e) {
+                // Headers are already sent; ending the body early is the only way left to report it
+                Logger::getInstance().error("Job export aborted: " + std::string(e.what()));
+                m_cursor.reset();
+                return 0;
+            }
+            if (!job) {
+                m_cursor.reset();
+                return 0;
+            }
+            m_pending = *m_objectMapper->writeToString(oatpp::Object<JobDto>(job));
+            m_pending.push_back('\n');
+            m_offset = 0;
+        }
+
+        const auto size = std::min<std::size_t>(static_cast<std::size_t>(count), m_pending.size() - m_offset);
+        std::memcpy(buffer, m_pending.data() + m_offset, size);
+        m_offset += size;
+        return static_cast<oatpp::v_io_size>(size);
+    }
+
+private:
+    std::unique_ptr<JobRepository::PageCursor> m_cursor;
+    std::shared_ptr<oatpp::data::mapping::ObjectMapper> m_objectMapper;
+    std::string m_pending;
+    std::size_t m_offset = 0;
+};
+
 #include OATPP_CODEGEN_BEGIN(ApiController) ///< Begin code-generation region
 
 class JobController final : public oatpp::web::server::api::ApiController {
@@ -13,20 +78,79 @@ public:
     explicit JobController(const std::shared_ptr<JobManager>& jobManager, const std::shared_ptr<ObjectMapper>& objectMapper)
         : ApiController(objectMapper)
         , m_jobManager(jobManager)
+        , m_tenantResolver(TenantResolver::fromConfig())
     {}
 
 private:
     std::shared_ptr<JobManager> m_jobManager;
+    TenantResolver m_tenantResolver;  ///< Maps API keys to tenant names, so keys never reach the scheduler.
+
+    /**
+     * @brief Returns the submitting tenant: the tenant of the `X-API-Key` header, falling back to `X-Client-Id`.
+     */
+    std::string tenantOf(const std::shared_ptr<IncomingRequest>& request) const {
+        const auto apiKey = request->getHeader("X-API-Key");
+        const auto clientId = request->getHeader("X-Client-Id");
+        return m_tenantResolver.resolve(apiKey ? *apiKey : std::string(), clientId ? *clientId : std::string());
+    }
+
+    /**
+     * @brief Converts an optional JobDto deadline, in seconds since the Unix epoch, to a time point.
+     */
+    static std::optional<std::chrono::system_clock::time_point> deadlineOf(const oatpp::Object<JobDto>& dto) {
+        if (!dto->deadline) {
+            return std::nullopt;
+        }
+        return std::chrono::system_clock::time_point(std::chrono::seconds(*dto->deadline));
+    }
+
+    /**
+     * @brief Parses an optional query parameter holding seconds since the Unix epoch.
+     * @throws std::invalid_argument if the value is not an integer.
+     */
+    static std::optional<int64_t> parseEpochSeconds(const oatpp::String& value, const char* name) {
+        if (!value || value->empty()) {
+            return std::nullopt;
+        }
+        size_t consumed = 0;
+        int64_t seconds = 0;
+        try {
+            seconds = std::stoll(*value, &consumed);
+        } catch (const std::exception&) {
+            consumed = 0;
+        }
+        if (consumed != value->size()) {
+            throw std::invalid_argument(std::string(name) + " must be seconds since the Unix epoch");
+        }
+        return seconds;
+    }
+
+    /**
+     * @brief Splits a comma-separated field list, skipping empty entries.
+     */
+    static std::vector<std::string> splitFields(const std::string& list) {
+        std::vector<std::string> fields;
+        std::istringstream stream(list);
+        for (std::string field; std::getline(stream, field, ',');) {
+            if (!field.empty()) {
+                fields.push_back(field);
+            }
+        }
+        return fields;
+    }
 
     /**
      * @brief Endpoint to create a new job.
      *
-     * Accepts a `JobDto` JSON payload and creates a job using `JobManager`.
+     * Accepts a `JobDto` JSON payload and creates a job using `JobManager`. The submitting tenant is
+     * derived from the `X-API-Key` header, falling back to `X-Client-Id`, for fair-share scheduling.
      *
+     * @param request - Incoming request, used to read the tenant headers.
      * @param dto - Parsed `JobDto` from the incoming request body.
      * @return `oatpp::web::protocol::http::outgoing::Response` indicating success or failure.
      */
     ENDPOINT("POST", "/jobs", createJob,
+             REQUEST(std::shared_ptr<IncomingRequest>, request),
              BODY_DTO(oatpp::Object<JobDto>, dto)) {
 
         // Inject JobManager component to handle job logic.
@@ -37,12 +161,178 @@ private:
         }
 
         // Attempt to create the job using the JobManager.
+        try {
+            if (int jobId = jobManager->createJob(dto->inputFile, dto->outputFile, dto->options, deadlineOf(dto),
+                                                  tenantOf(request),
+                                                  dto->templateId ? *dto->templateId : std::string()); jobId > 0) {
+                return createResponse(Status::CODE_201, "Job created with ID: " + std::to_string(jobId));
+            }
+        } catch (const JobRejectedException& e) {
+            return createResponse(Status::CODE_422, e.what());
+        }
+        return createResponse(Status::CODE_500, "Failed to create job");
+    }
 
-        if (int jobId = jobManager->createJob(dto->inputFile, dto->outputFile, dto->options); jobId > 0) {
-            return createResponse(Status::CODE_201, "Job created with ID: " + std::to_string(jobId));
-        } else {
-            return createResponse(Status::CODE_500, "Failed to create job");
+    /**
+     * @brief Endpoint to create many jobs at once.
+     *
+     * All jobs are stored with one bulk insert, so a large submission costs a few statements and a single
+     * commit. Each job is then queued; jobs the processor refuses are returned with status FAILED.
+     *
+     * @param request - Incoming request, used to read the tenant headers.
+     * @param dto - `JobBatchRequestDto` listing the jobs, at most `jobs.batch.max_items`.
+     * @return `JobBatchResponseDto` with the created jobs in request order, or 400 for an empty or oversized batch.
+     */
+    ENDPOINT("POST", "/jobs:batch", createJobs,
+             REQUEST(std::shared_ptr<IncomingRequest>, request),
+             BODY_DTO(oatpp::Object<JobBatchRequestDto>, dto)) {
+        std::vector<JobSubmission> submissions;
+        if (dto && dto->jobs) {
+            submissions.reserve(dto->jobs->size());
+            for (const auto& job : *dto->jobs) {
+                if (!job || !job->inputFile || !job->outputFile) {
+                    return createResponse(Status::CODE_400, "Every job needs an inputFile and an outputFile");
+                }
+                JobSubmission submission;
+                submission.job.inputFile = *job->inputFile;
+                submission.job.outputFile = *job->outputFile;
+                submission.job.options = job->options ? *job->options : std::string();
+                submission.job.templateId = job->templateId ? *job->templateId : std::string();
+                submission.job.deadline = deadlineOf(job);
+                submissions.push_back(std::move(submission));
+            }
+        }
+
+        std::vector<std::shared_ptr<JobDto>> jobs;
+        try {
+            jobs = m_jobManager->createJobs(submissions, tenantOf(request));
+        } catch (const std::invalid_argument& e) {
+            return createResponse(Status::CODE_400, e.what());
+        } catch (const std::runtime_error& e) {
+            return createResponse(Status::CODE_500, e.what());
+        }
+
+        auto response = JobBatchResponseDto::createShared();
+        response->jobs = oatpp::List<oatpp::Object<JobDto>>::createShared();
+        for (const auto& job : jobs) {
+            response->jobs->push_back(oatpp::Object<JobDto>(job));
+        }
+        return createDtoResponse(Status::CODE_201, response);
+    }
+
+    /**
+     * @brief Endpoint listing jobs one page at a time, in ascending ID order.
+     *
+     * Pages are addressed by keyset: pass the `nextAfterId` of a page as `after_id` to get the next one.
+     *
+     * @param request - Incoming request, used to read the optional creation time bounds
+     *                  `created_from` (inclusive) and `created_until` (exclusive), in seconds since the Unix epoch.
+     * @param afterId - Only jobs with a greater ID are listed.
+     * @param limit - Maximum number of jobs in the page, capped at `jobs.max_page_size`.
+     * @param status - Optional status filter.
+     * @param templateId - Optional encoding template filter.
+     * @param fields - Optional comma-separated list of `JobDto` fields to return; the ID is always returned.
+     * @return `JobPageDto` with the jobs and the `after_id` of the next page, or 400 for an invalid request.
+     */
+    ENDPOINT("GET", "/jobs", listJobs,
+             REQUEST(std::shared_ptr<IncomingRequest>, request),
+             QUERY(Int64, afterId, "after_id", 0),
+             QUERY(UInt32, limit, "limit", 100),
+             QUERY(String, status, "status", ""),
+             QUERY(String, templateId, "template", ""),
+             QUERY(String, fields, "fields", "")) {
+        JobPageRequest pageRequest;
+        pageRequest.afterId = afterId ? *afterId : 0;
+        pageRequest.limit = limit ? *limit : 100;
+        pageRequest.status = status ? *status : std::string();
+        pageRequest.templateId = templateId ? *templateId : std::string();
+        pageRequest.fields = splitFields(fields ? *fields : std::string());
+
+        JobPage page;
+        try {
+            pageRequest.createdFrom = parseEpochSeconds(request->getQueryParameter("created_from"), "created_from");
+            pageRequest.createdUntil = parseEpochSeconds(request->getQueryParameter("created_until"), "created_until");
+            page = m_jobManager->listJobs(pageRequest);
+        } catch (const std::invalid_argument& e) {
+            return createResponse(Status::CODE_400, e.what());
         }
+
+        auto dto = JobPageDto::createShared();
+        dto->jobs = oatpp::List<oatpp::Object<JobDto>>::createShared();
+        for (const auto& job : page.jobs) {
+            dto->jobs->push_back(oatpp::Object<JobDto>(job));
+        }
+        if (page.nextAfterId) {
+            dto->nextAfterId = *page.nextAfterId;
+        }
+        return createDtoResponse(Status::CODE_200, dto);
+    }
+
+    /**
+     * @brief Endpoint streaming every job as newline-delimited JSON.
+     *
+     * Jobs are read in keyset pages and written as they are serialized, so memory use does not grow
+     * with the number of jobs and no database connection is held while the client reads. If a page
+     * cannot be read the error is logged and the stream ends early.
+     *
+     * @param status - Optional status filter.
+     * @return Chunked `application/x-ndjson` response, one `JobDto` per line, ordered by ID.
+     */
+    ENDPOINT("GET", "/jobs/export", exportJobs,
+             QUERY(String, status, "status", "")) {
+        auto cursor = m_jobManager->exportJobs(status ? *status : std::string());
+        const auto body = std::make_shared<oatpp::web::protocol::http::outgoing::StreamingBody>(
+            std::make_shared<JobExportReadCallback>(std::move(cursor), getDefaultObjectMapper()));
+        auto response = OutgoingResponse::createShared(Status::CODE_200, body);
+        response->putHeader(Header::CONTENT_TYPE, "application/x-ndjson");
+        return response;
+    }
+
+    /**
+     * @brief Endpoint exposing the scheduler counters, including deadline misses and fast lane usage.
+     *
+     * @return `SchedulerMetricsDto` with the current JobProcessor metrics.
+     */
+    ENDPOINT("GET", "/metrics/scheduler", getSchedulerMetrics) {
+        const auto metrics = m_jobManager->getSchedulerMetrics();
+
+        auto dto = SchedulerMetricsDto::createShared();
+        dto->jobsAdmitted = metrics.jobsAdmitted;
+        dto->jobsRejected = metrics.jobsRejected;
+        dto->deadlinesMet = metrics.deadlinesMet;
+        dto->deadlinesMissed = metrics.deadlinesMissed;
+        dto->queuedJobs = metrics.queuedJobs;
+        dto->fastLaneJobs = metrics.fastLaneJobs;
+        dto->fastLaneQueuedJobs = metrics.fastLaneQueuedJobs;
+        return createDtoResponse(Status::CODE_200, dto);
+    }
+
+    /**
+     * @brief Endpoint exposing the connection pool counters of the job database: wait times and utilization.
+     *
+     * @return `DatabasePoolMetricsDto` with the current pool counters, or 404 if the backend has no pool (SQLite).
+     */
+    ENDPOINT("GET", "/metrics/database", getDatabasePoolMetrics) {
+        const auto metrics = m_jobManager->getDatabasePoolMetrics();
+        if (!metrics) {
+            return createResponse(Status::CODE_404, R"({"error":"Not Found","message":"The database backend has no connection pool"})");
+        }
+
+        auto dto = DatabasePoolMetricsDto::createShared();
+        dto->connections = metrics->total;
+        dto->idleConnections = metrics->idle;
+        dto->connectionsInUse = metrics->inUse;
+        dto->peakConnectionsInUse = metrics->peakInUse;
+        dto->waiters = metrics->waiters;
+        dto->acquires = metrics->acquires;
+        dto->acquireTimeouts = metrics->timeouts;
+        dto->connectionsCreated = metrics->created;
+        dto->connectionsEvicted = metrics->evicted;
+        dto->connectionsDiscarded = metrics->discarded;
+        dto->averageWaitMicros = metrics->averageWaitMicros();
+        dto->maxWaitMicros = metrics->maxWaitMicros;
+        dto->utilization = metrics->utilization;
+        return createDtoResponse(Status::CODE_200, dto);
     }
 };
 
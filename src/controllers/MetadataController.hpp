@@ -0,0 +1,106 @@
+#ifndef METADATACONTROLLER_HPP
+#define METADATACONTROLLER_HPP
+
+#include "dto/MetadataBatchDto.hpp"
+#include "managers/MetadataManager.hpp"
+#include "oatpp/web/server/api/ApiController.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+#include "oatpp/web/protocol/http/outgoing/StreamingBody.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/core/macro/component.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Feeds MetadataBatch result lines into a chunked HTTP response as they become available.
+ */
+class MetadataBatchReadCallback final : public oatpp::data::stream::ReadCallback {
+public:
+    explicit MetadataBatchReadCallback(std::shared_ptr<MetadataBatch> batch) : m_batch(std::move(batch)) {}
+
+    // The response is dropped early if the client disconnects; skip the items not yet started
+    ~MetadataBatchReadCallback() override { m_batch->cancel(); }
+
+    oatpp::v_io_size read(void* buffer, const v_buff_size count, oatpp::async::Action& /*action*/) override {
+        while (m_offset == m_pending.size()) {
+            auto line = m_batch->next();
+            if (!line) {
+                return 0;  // All results sent
+            }
+            m_pending = std::move(*line);
+            m_offset = 0;
+        }
+
+        const auto size = std::min<std::size_t>(static_cast<std::size_t>(count), m_pending.size() - m_offset);
+        std::memcpy(buffer, m_pending.data() + m_offset, size);
+        m_offset += size;
+        return static_cast<oatpp::v_io_size>(size);
+    }
+
+private:
+    std::shared_ptr<MetadataBatch> m_batch;
+    std::string m_pending;
+    std::size_t m_offset = 0;
+};
+
+#include OATPP_CODEGEN_BEGIN(ApiController) //<-- Begin Codegen
+
+/**
+ * @brief Controller for media metadata probing.
+ */
+class MetadataController final : public oatpp::web::server::api::ApiController {
+public:
+    MetadataController(const std::shared_ptr<MetadataManager>& metadataManager,
+                       const std::shared_ptr<ObjectMapper>& objectMapper)
+        : oatpp::web::server::api::ApiController(objectMapper)
+        , m_metadataManager(metadataManager)
+    {}
+
+private:
+    std::shared_ptr<MetadataManager> m_metadataManager;
+
+public:
+    /**
+     * @brief Endpoint to probe many files at once.
+     *
+     * Responds with newline-delimited JSON, one `{"path": ..., "metadata": {...}}` or
+     * `{"path": ..., "error": "..."}` object per file, in the order the probes finish.
+     */
+    ENDPOINT_INFO(probeBatch) {
+        info->summary = "Probe metadata for a batch of files";
+        info->addConsumes<Object<MetadataBatchRequestDto>>("application/json");
+        info->addResponse<String>(Status::CODE_200, "application/x-ndjson");
+        info->addResponse<String>(Status::CODE_400, "application/json");
+    }
+    ENDPOINT("POST", "/metadata:batch", probeBatch,
+             BODY_DTO(Object<MetadataBatchRequestDto>, dto)) {
+        std::vector<std::string> paths;
+        if (dto->paths) {
+            paths.reserve(dto->paths->size());
+            for (const auto& path : *dto->paths) {
+                if (path) {
+                    paths.emplace_back(*path);
+                }
+            }
+        }
+
+        try {
+            const auto batch = m_metadataManager->probeBatch(paths);
+            const auto body = std::make_shared<oatpp::web::protocol::http::outgoing::StreamingBody>(
+                std::make_shared<MetadataBatchReadCallback>(batch));
+            auto response = OutgoingResponse::createShared(Status::CODE_200, body);
+            response->putHeader(Header::CONTENT_TYPE, "application/x-ndjson");
+            return response;
+        } catch (const InvalidBatchException& e) {
+            return createResponse(Status::CODE_400, R"({"error":"Bad Request","message":")" + std::string(e.what()) + "\"}");
+        }
+    }
+};
+
+#include OATPP_CODEGEN_END(ApiController) //<-- End Codegen
+
+#endif // METADATACONTROLLER_HPP
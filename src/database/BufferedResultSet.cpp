@@ -0,0 +1,52 @@
+#include "BufferedResultSet.hpp"
+
+#include <stdexcept>
+
+void BufferedResultSet::addColumn(std::string name) {
+    if (!m_cells.empty()) {
+        throw std::logic_error("BufferedResultSet: columns must be declared before rows");
+    }
+    m_columns.push_back(std::move(name));
+}
+
+void BufferedResultSet::beginRow() {
+    if (m_columns.empty() || m_cells.size() % m_columns.size() != 0) {
+        throw std::logic_error("BufferedResultSet: previous row is incomplete");
+    }
+    m_cells.reserve(m_cells.size() + m_columns.size());
+}
+
+void BufferedResultSet::appendCell(std::string_view text) {
+    if (m_buffer.size() + text.size() >= kNull) {
+        throw std::length_error("BufferedResultSet: result exceeds 4 GiB");
+    }
+    m_cells.push_back({static_cast<uint32_t>(m_buffer.size()), static_cast<uint32_t>(text.size())});
+    m_buffer.append(text);
+}
+
+void BufferedResultSet::appendNull() {
+    m_cells.push_back({static_cast<uint32_t>(m_buffer.size()), kNull});
+}
+
+size_t BufferedResultSet::rowCount() const {
+    return m_columns.empty() ? 0 : m_cells.size() / m_columns.size();
+}
+
+std::string_view BufferedResultSet::value(size_t row, size_t column) const {
+    const auto& c = cell(row, column);
+    if (c.length == kNull) {
+        return {};
+    }
+    return std::string_view(m_buffer).substr(c.offset, c.length);
+}
+
+bool BufferedResultSet::isNull(size_t row, size_t column) const {
+    return cell(row, column).length == kNull;
+}
+
+const BufferedResultSet::Cell& BufferedResultSet::cell(size_t row, size_t column) const {
+    if (column >= m_columns.size()) {
+        throw std::out_of_range("BufferedResultSet: column " + std::to_string(column) + " out of range");
+    }
+    return m_cells.at(row * m_columns.size() + column);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "database/ResultSet.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class BufferedResultSet
+ * @brief ResultSet that packs every cell of a result into one contiguous buffer.
+ *
+ * Used by drivers that only expose the current row (sqlite3_stmt, MYSQL_BIND): each row is appended
+ * as it is stepped, costing one buffer append per cell instead of one std::string per cell.
+ */
+class BufferedResultSet final : public ResultSet {
+public:
+    /**
+     * @brief Declares the next column. All columns must be added before the first row.
+     */
+    void addColumn(std::string name);
+
+    /**
+     * @brief Starts a new row; cells are appended to it in column order.
+     */
+    void beginRow();
+    void appendCell(std::string_view text);
+    void appendNull();
+
+    [[nodiscard]] size_t rowCount() const override;
+    [[nodiscard]] size_t columnCount() const override { return m_columns.size(); }
+    [[nodiscard]] std::string_view columnName(size_t column) const override { return m_columns.at(column); }
+    [[nodiscard]] std::string_view value(size_t row, size_t column) const override;
+    [[nodiscard]] bool isNull(size_t row, size_t column) const override;
+
+private:
+    struct Cell {
+        uint32_t offset;  ///< Start of the cell text in m_buffer.
+        uint32_t length;  ///< Text length; kNull marks a NULL cell.
+    };
+    static constexpr uint32_t kNull = UINT32_MAX;
+
+    [[nodiscard]] const Cell& cell(size_t row, size_t column) const;
+
+    std::vector<std::string> m_columns;  ///< Column names.
+    std::vector<Cell> m_cells;           ///< Row-major cells.
+    std::string m_buffer;                ///< Text of all cells, back to back.
+};
@@ -1,60 +1,334 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
-#include <memory>
-#include "DatabaseConnection.hpp"
+#include "database/ConnectionPoolMetrics.hpp"
+
+/**
+ * @brief Sizing and timeouts of a ConnectionPool.
+ */
+struct ConnectionPoolOptions {
+    size_t minSize = 1;                               ///< Connections opened eagerly and never evicted.
+    size_t maxSize = 10;                              ///< Upper bound on open connections; more are opened lazily.
+    std::chrono::milliseconds acquireTimeout{5000};   ///< How long acquire() waits for a free connection.
+    std::chrono::milliseconds idleTimeout{60000};     ///< Idle connections above minSize are closed after this.
+    std::chrono::milliseconds validateAfterIdle{0};   ///< Health check borrowed connections idle at least this long; 0 checks every borrow.
+};
+
+/**
+ * @brief Thrown when acquire() cannot get a connection within the acquire timeout.
+ */
+class ConnectionPoolTimeout : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
 
 /**
  * @class ConnectionPool
- * @brief Manages a pool of database connections, providing acquisition and release mechanisms.
+ * @brief Thread-safe pool of driver connection handles (PGconn, MYSQL, ...) handed out as RAII leases.
+ *
+ * Connections are opened through a factory, closed through a closer and optionally health checked on borrow.
+ * The pool grows lazily from minSize to maxSize and closes connections that sit idle above minSize.
+ * The pool must outlive every lease taken from it.
+ *
+ * @tparam Connection Driver connection type; the pool stores Connection*.
  */
+template <typename Connection>
 class ConnectionPool {
 public:
- /**
-  * @brief Constructs the ConnectionPool with a specified size and initializes connections.
-  *
-  * @param poolSize The number of connections to maintain in the pool.
-  * @param connectionString The database connection string.
-  */
- ConnectionPool(size_t poolSize, std::string  connectionString);
-
- /**
-  * @brief Acquires a connection from the pool, reconnecting if necessary.
-  *
-  * @return A shared pointer to an active DatabaseConnection.
-  */
- std::shared_ptr<DatabaseConnection> acquire();
-
- /**
-  * @brief Releases a connection back to the pool.
-  *
-  * @param conn A shared pointer to the DatabaseConnection to release.
-  */
- void release(const std::shared_ptr<DatabaseConnection>& conn);
-
- /**
-  * @brief Destructor. Cleans up all remaining connections in the pool.
-  */
- ~ConnectionPool();
+    using Factory = std::function<Connection*()>;         ///< Opens a connection or throws.
+    using Closer = std::function<void(Connection*)>;      ///< Closes a connection.
+    using Validator = std::function<bool(Connection*)>;   ///< Returns false for a connection that must be replaced.
+
+    /**
+     * @brief A borrowed connection, returned to the pool when the lease is destroyed.
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(ConnectionPool* pool, Connection* connection) : m_pool(pool), m_connection(connection) {}
+        Lease(Lease&& other) noexcept
+            : m_pool(std::exchange(other.m_pool, nullptr)),
+              m_connection(std::exchange(other.m_connection, nullptr)),
+              m_broken(other.m_broken) {}
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_pool = std::exchange(other.m_pool, nullptr);
+                m_connection = std::exchange(other.m_connection, nullptr);
+                m_broken = other.m_broken;
+            }
+            return *this;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { reset(); }
+
+        [[nodiscard]] Connection* get() const { return m_connection; }
+        Connection* operator->() const { return m_connection; }
+        explicit operator bool() const { return m_connection != nullptr; }
+
+        /**
+         * @brief Marks the connection as unusable so it is closed instead of returned to the pool.
+         */
+        void markBroken() { m_broken = true; }
+        [[nodiscard]] bool isBroken() const { return m_broken; }
+
+        /**
+         * @brief Returns the connection to the pool early.
+         */
+        void reset() {
+            if (m_pool && m_connection) {
+                m_pool->release(m_connection, m_broken);
+            }
+            m_pool = nullptr;
+            m_connection = nullptr;
+            m_broken = false;
+        }
+
+    private:
+        ConnectionPool* m_pool = nullptr;
+        Connection* m_connection = nullptr;
+        bool m_broken = false;
+    };
+
+    /**
+     * @brief Creates a pool; no connection is opened until start().
+     * @param name Name used in error messages.
+     * @param options Sizing and timeouts.
+     * @param factory Opens a connection or throws std::runtime_error.
+     * @param closer Closes a connection.
+     * @param validator Optional health check run on borrow.
+     */
+    ConnectionPool(std::string name, ConnectionPoolOptions options, Factory factory, Closer closer,
+                   Validator validator = nullptr)
+        : m_name(std::move(name)), m_options(options), m_factory(std::move(factory)),
+          m_closer(std::move(closer)), m_validator(std::move(validator)) {
+        m_options.maxSize = std::max<size_t>(m_options.maxSize, 1);
+        m_options.minSize = std::min(m_options.minSize, m_options.maxSize);
+    }
+
+    ~ConnectionPool() { shutdown(); }
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    /**
+     * @brief Opens minSize connections and starts handing out leases.
+     * @throws std::runtime_error if a connection cannot be opened; nothing stays open in that case.
+     */
+    void start() {
+        std::vector<Connection*> opened;
+        try {
+            for (size_t i = 0; i < m_options.minSize; ++i) {
+                opened.push_back(m_factory());
+            }
+        } catch (...) {
+            for (auto* connection : opened) {
+                m_closer(connection);
+            }
+            throw;
+        }
+
+        std::lock_guard lock(m_mutex);
+        auto now = Clock::now();
+        for (auto* connection : opened) {
+            m_idle.push_back({connection, now});
+        }
+        m_metrics.total += opened.size();
+        m_metrics.created += opened.size();
+        m_open = true;
+    }
+
+    /**
+     * @brief Closes idle connections and stops handing out leases; leased connections are closed on return.
+     */
+    void shutdown() {
+        std::deque<Idle> idle;
+        {
+            std::lock_guard lock(m_mutex);
+            m_open = false;
+            idle.swap(m_idle);
+            m_metrics.total -= idle.size();
+        }
+        m_available.notify_all();
+        for (auto& entry : idle) {
+            m_closer(entry.connection);
+        }
+    }
+
+    /**
+     * @brief Borrows a connection, opening a new one if none is idle and the pool is below maxSize.
+     * @return Lease that returns the connection to the pool when destroyed.
+     * @throws ConnectionPoolTimeout if no connection frees up within the acquire timeout.
+     * @throws std::runtime_error if the pool is shut down or a new connection cannot be opened.
+     */
+    Lease acquire() {
+        const auto start = Clock::now();
+        const auto deadline = start + m_options.acquireTimeout;
+
+        std::unique_lock lock(m_mutex);
+        evictIdle(lock, start);
+
+        while (true) {
+            if (!m_open) {
+                throw std::runtime_error(m_name + " connection pool is not running.");
+            }
+
+            if (!m_idle.empty()) {
+                Idle entry = m_idle.back();  // Most recently used first, so older connections age out.
+                m_idle.pop_back();
+                markLeased();
+                lock.unlock();
+
+                if (needsValidation(entry) && !m_validator(entry.connection)) {
+                    m_closer(entry.connection);
+                    lock.lock();
+                    --m_metrics.inUse;
+                    --m_metrics.total;
+                    ++m_metrics.discarded;
+                    continue;
+                }
+                lock.lock();
+                recordWait(start);
+                return Lease(this, entry.connection);
+            }
+
+            if (m_metrics.total < m_options.maxSize) {
+                ++m_metrics.total;
+                markLeased();
+                lock.unlock();
+
+                Connection* connection = nullptr;
+                try {
+                    connection = m_factory();
+                } catch (...) {
+                    lock.lock();
+                    --m_metrics.total;
+                    --m_metrics.inUse;
+                    lock.unlock();
+                    m_available.notify_one();
+                    throw;
+                }
+                lock.lock();
+                ++m_metrics.created;
+                recordWait(start);
+                return Lease(this, connection);
+            }
+
+            ++m_metrics.waiters;
+            bool ready = m_available.wait_until(lock, deadline, [this] {
+                return !m_open || !m_idle.empty() || m_metrics.total < m_options.maxSize;
+            });
+            --m_metrics.waiters;
+            if (!ready) {
+                ++m_metrics.timeouts;
+                throw ConnectionPoolTimeout(m_name + " connection pool: no connection available within " +
+                                            std::to_string(m_options.acquireTimeout.count()) + " ms.");
+            }
+        }
+    }
+
+    /**
+     * @brief Returns a snapshot of the pool counters.
+     */
+    [[nodiscard]] ConnectionPoolMetrics metrics() const {
+        std::lock_guard lock(m_mutex);
+        ConnectionPoolMetrics metrics = m_metrics;
+        metrics.idle = m_idle.size();
+        metrics.utilization = static_cast<double>(metrics.inUse) / static_cast<double>(m_options.maxSize);
+        return metrics;
+    }
+
+    [[nodiscard]] const ConnectionPoolOptions& options() const { return m_options; }
 
 private:
- size_t m_poolSize; ///< Number of connections in the pool.
- std::string m_connectionString; ///< Database connection string.
- std::queue<std::shared_ptr<DatabaseConnection>> m_connections; ///< Pool of connections.
- std::mutex m_mutex; ///< Mutex to synchronize access to the pool.
- std::condition_variable m_condition; ///< Condition variable for connection availability.
-
- /**
-  * @brief Initializes the pool with the specified number of connections.
-  */
- void initializePool();
-
- /**
-  * @brief Cleans up all connections in the pool, closing each one.
-  */
- void cleanupPool();
-};
\ No newline at end of file
+    using Clock = std::chrono::steady_clock;
+
+    struct Idle {
+        Connection* connection;
+        Clock::time_point since;  ///< When the connection was returned.
+    };
+
+    void release(Connection* connection, bool broken) {
+        bool close;
+        {
+            std::lock_guard lock(m_mutex);
+            --m_metrics.inUse;
+            close = broken || !m_open;
+            if (close) {
+                --m_metrics.total;
+                if (broken) {
+                    ++m_metrics.discarded;
+                }
+            } else {
+                m_idle.push_back({connection, Clock::now()});
+            }
+        }
+        m_available.notify_one();
+        if (close) {
+            m_closer(connection);
+        }
+    }
+
+    void markLeased() {
+        ++m_metrics.inUse;
+        m_metrics.peakInUse = std::max(m_metrics.peakInUse, m_metrics.inUse);
+    }
+
+    /// Charges a successful acquire() with the time since it started. Caller holds m_mutex.
+    void recordWait(Clock::time_point start) {
+        ++m_metrics.acquires;
+        auto waited = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+        m_metrics.totalWaitMicros += waited;
+        m_metrics.maxWaitMicros = std::max(m_metrics.maxWaitMicros, waited);
+    }
+
+    [[nodiscard]] bool needsValidation(const Idle& entry) const {
+        return m_validator && Clock::now() - entry.since >= m_options.validateAfterIdle;
+    }
+
+    /// Closes the oldest idle connections that exceeded the idle timeout, keeping minSize open.
+    void evictIdle(std::unique_lock<std::mutex>& lock, Clock::time_point now) {
+        std::vector<Connection*> expired;
+        while (!m_idle.empty() && m_metrics.total - expired.size() > m_options.minSize &&
+               now - m_idle.front().since >= m_options.idleTimeout) {
+            expired.push_back(m_idle.front().connection);
+            m_idle.pop_front();
+        }
+        if (expired.empty()) {
+            return;
+        }
+        m_metrics.total -= expired.size();
+        m_metrics.evicted += expired.size();
+
+        lock.unlock();
+        for (auto* connection : expired) {
+            m_closer(connection);
+        }
+        lock.lock();
+        m_available.notify_all();
+    }
+
+    std::string m_name;
+    ConnectionPoolOptions m_options;
+    Factory m_factory;
+    Closer m_closer;
+    Validator m_validator;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_available;  ///< Signalled when a connection is returned or a slot frees up.
+    std::deque<Idle> m_idle;              ///< Idle connections, oldest first.
+    ConnectionPoolMetrics m_metrics;
+    bool m_open = false;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Point-in-time counters of a ConnectionPool.
+ */
+struct ConnectionPoolMetrics {
+    size_t total = 0;              ///< Open connections, including ones being opened.
+    size_t idle = 0;               ///< Connections waiting in the pool.
+    size_t inUse = 0;              ///< Connections currently leased.
+    size_t peakInUse = 0;          ///< Highest inUse seen.
+    size_t waiters = 0;            ///< Threads blocked in acquire().
+    uint64_t acquires = 0;         ///< Successful acquire() calls.
+    uint64_t timeouts = 0;         ///< acquire() calls that gave up.
+    uint64_t created = 0;          ///< Connections opened.
+    uint64_t evicted = 0;          ///< Idle connections closed by the idle timeout.
+    uint64_t discarded = 0;        ///< Connections closed after failing a health check or being marked broken.
+    uint64_t totalWaitMicros = 0;  ///< Time spent in acquire(), summed.
+    uint64_t maxWaitMicros = 0;    ///< Longest single acquire().
+    double utilization = 0.0;      ///< inUse relative to the pool's maximum size.
+
+    [[nodiscard]] double averageWaitMicros() const {
+        return acquires == 0 ? 0.0 : static_cast<double>(totalWaitMicros) / static_cast<double>(acquires);
+    }
+};
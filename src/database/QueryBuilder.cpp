@@ -1,66 +1,304 @@
 #include "QueryBuilder.hpp"
 
+#include <array>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+    // Distinct statements kept per thread; beyond this the cache starts over rather than tracking recency.
+    constexpr size_t kMaxCachedStatements = 1024;
+
+    // MariaDB and SQLite need a LIMIT before an OFFSET; these mean "no limit".
+    constexpr const char* kMariaDBNoLimit = "18446744073709551615";
+    constexpr const char* kSQLiteNoLimit = "-1";
+
+    struct Compiled {
+        std::string text;
+        size_t placeholders = 0;
+    };
+
+    /**
+     * @brief Replaces each `?` outside quoted literals with the dialect's placeholder and counts them.
+     */
+    Compiled rewritePlaceholders(const SqlDialect dialect, const std::string& sql) {
+        Compiled compiled;
+        compiled.text.reserve(sql.size() + 16);
+        char quote = 0;
+        for (const char c : sql) {
+            if (quote) {
+                if (c == quote) quote = 0;  // A doubled quote closes and reopens, which is equivalent
+            } else if (c == '\'' || c == '"') {
+                quote = c;
+            } else if (c == '?') {
+                ++compiled.placeholders;
+                if (dialect == SqlDialect::PostgreSQL) {
+                    compiled.text += '$' + std::to_string(compiled.placeholders);
+                    continue;
+                }
+            }
+            compiled.text += c;
+        }
+        return compiled;
+    }
+
+    template <typename Key, typename Hash = std::hash<Key>>
+    using CompiledCache = std::unordered_map<Key, std::shared_ptr<const Compiled>, Hash>;
+
+    // Caches are per thread, so a lookup takes no lock; each thread compiles a shape once.
+    template <typename Key, typename Hash, typename Make>
+    std::shared_ptr<const Compiled> lookup(CompiledCache<Key, Hash>& cache, const Key& key, Make&& make) {
+        if (const auto it = cache.find(key); it != cache.end()) {
+            return it->second;
+        }
+        if (cache.size() >= kMaxCachedStatements) {
+            cache.clear();
+        }
+        return cache.emplace(key, std::make_shared<const Compiled>(make())).first->second;
+    }
+
+    BuiltQuery bind(const std::shared_ptr<const Compiled>& compiled, std::vector<std::string> params) {
+        if (compiled->placeholders != params.size()) {
+            throw std::logic_error("Query has " + std::to_string(compiled->placeholders) + " placeholders but " +
+                                   std::to_string(params.size()) + " values: " + compiled->text);
+        }
+        // Aliasing constructor: the text keeps its cache entry alive
+        return {std::shared_ptr<const std::string>(compiled, &compiled->text), std::move(params)};
+    }
+}
+
+bool QueryBuilder::Shape::operator==(const Shape& other) const {
+    const auto tie = [](const Shape& shape) {
+        return std::tie(shape.dialect, shape.statement, shape.selectColumns, shape.table, shape.setColumns,
+                        shape.conditions, shape.joins, shape.orderBy, shape.limit, shape.offset, shape.skipLocked,
+                        shape.returning);
+    };
+    return tie(*this) == tie(other);
+}
+
+struct QueryBuilder::ShapeHash {
+    size_t operator()(const Shape& shape) const {
+        size_t seed = static_cast<size_t>(shape.dialect) * 8 + static_cast<size_t>(shape.statement);
+        const auto mix = [&seed](const size_t value) { seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2); };
+        const auto mixAll = [&mix](const std::vector<std::string>& values) {
+            mix(values.size());
+            for (const auto& value : values) {
+                mix(std::hash<std::string>{}(value));
+            }
+        };
+        mixAll(shape.selectColumns);
+        mix(std::hash<std::string>{}(shape.table));
+        mixAll(shape.setColumns);
+        mixAll(shape.conditions);
+        mixAll(shape.joins);
+        mixAll(shape.orderBy);
+        mix(shape.limit ? *shape.limit + 1 : 0);
+        mix(shape.offset ? *shape.offset + 1 : 0);
+        mix(shape.skipLocked);
+        mix(std::hash<std::string>{}(shape.returning));
+        return seed;
+    }
+};
+
+QueryBuilder::QueryBuilder(const SqlDialect dialect) {
+    m_shape.dialect = dialect;
+}
+
 QueryBuilder& QueryBuilder::select(const std::vector<std::string>& columns) {
     if (columns.empty()) throw std::invalid_argument("Columns for SELECT cannot be empty");
-    m_selectColumns = columns;
+    m_shape.selectColumns = columns;
     return *this;
 }
 
 QueryBuilder& QueryBuilder::from(const std::string& table) {
     if (table.empty()) throw std::invalid_argument("Table name cannot be empty");
-    m_table = table;
+    m_shape.statement = Statement::Select;
+    m_shape.table = table;
+    return *this;
+}
+
+QueryBuilder& QueryBuilder::insertInto(const std::string& table) {
+    if (table.empty()) throw std::invalid_argument("Table name cannot be empty");
+    m_shape.statement = Statement::Insert;
+    m_shape.table = table;
+    return *this;
+}
+
+QueryBuilder& QueryBuilder::update(const std::string& table) {
+    if (table.empty()) throw std::invalid_argument("Table name cannot be empty");
+    m_shape.statement = Statement::Update;
+    m_shape.table = table;
+    return *this;
+}
+
+QueryBuilder& QueryBuilder::deleteFrom(const std::string& table) {
+    if (table.empty()) throw std::invalid_argument("Table name cannot be empty");
+    m_shape.statement = Statement::Delete;
+    m_shape.table = table;
+    return *this;
+}
+
+QueryBuilder& QueryBuilder::set(const std::string& column, std::string value) {
+    if (column.empty()) throw std::invalid_argument("Column name cannot be empty");
+    m_shape.setColumns.push_back(column);
+    m_setParams.push_back(std::move(value));
     return *this;
 }
 
-QueryBuilder& QueryBuilder::where(const std::string& condition, const std::map<std::string, std::string>& parameters) {
+QueryBuilder& QueryBuilder::where(const std::string& condition, std::vector<std::string> params) {
     if (condition.empty()) throw std::invalid_argument("Condition cannot be empty");
-    m_conditions.push_back(condition);
-    m_parameters.insert(parameters.begin(), parameters.end());
+    m_shape.conditions.push_back(condition);
+    m_conditionParams.insert(m_conditionParams.end(), std::make_move_iterator(params.begin()),
+                             std::make_move_iterator(params.end()));
     return *this;
 }
 
 QueryBuilder& QueryBuilder::join(const std::string& table, const std::string& condition) {
     if (table.empty() || condition.empty()) throw std::invalid_argument("JOIN table and condition cannot be empty");
-    m_joins.push_back("JOIN " + table + " ON " + condition);
+    m_shape.joins.push_back("JOIN " + table + " ON " + condition);
     return *this;
 }
 
-QueryBuilder& QueryBuilder::limit(const int limit) {
-    if (limit <= 0) throw std::invalid_argument("LIMIT must be a positive integer");
+QueryBuilder& QueryBuilder::limit(const size_t limit) {
+    if (limit == 0) throw std::invalid_argument("LIMIT must be a positive integer");
     m_limit = limit;
+    m_shape.limit = m_shape.dialect == SqlDialect::MariaDB ? limit : 0;
+    return *this;
+}
+
+QueryBuilder& QueryBuilder::offset(const size_t offset) {
+    m_offset = offset;
+    m_shape.offset = m_shape.dialect == SqlDialect::MariaDB ? offset : 0;
     return *this;
 }
 
 QueryBuilder& QueryBuilder::orderBy(const std::string& column, const OrderDirection direction) {
     if (column.empty()) throw std::invalid_argument("ORDER BY column cannot be empty");
-    m_orderBy = column + (direction == OrderDirection::ASC ? " ASC" : " DESC");
+    m_shape.orderBy.push_back(column + (direction == OrderDirection::ASC ? " ASC" : " DESC"));
     return *this;
 }
 
-std::string QueryBuilder::build() const {
-    if (m_table.empty()) throw std::logic_error("FROM clause is required");
+QueryBuilder& QueryBuilder::forUpdateSkipLocked() {
+    m_shape.skipLocked = true;
+    return *this;
+}
 
-    std::string query = "SELECT ";
-    query += m_selectColumns.empty() ? "*" : join(m_selectColumns, ", ");
-    query += " FROM " + m_table;
+QueryBuilder& QueryBuilder::returningId(const std::string& column) {
+    if (column.empty()) throw std::invalid_argument("RETURNING column cannot be empty");
+    m_shape.returning = column;
+    return *this;
+}
 
-    for (const auto& join : m_joins) {
-        query += " " + join;
+BuiltQuery QueryBuilder::build() const {
+    if (m_shape.table.empty()) throw std::logic_error("Table is required");
+    if (m_shape.setColumns.empty()) {
+        if (m_shape.statement == Statement::Insert) throw std::logic_error("INSERT needs at least one column");
+        if (m_shape.statement == Statement::Update) throw std::logic_error("UPDATE needs at least one assignment");
     }
 
-    if (!m_conditions.empty()) {
-        query += " WHERE " + join(m_conditions, " AND ");
-    }
+    thread_local CompiledCache<Shape, ShapeHash> cache;
+    const auto compiled = lookup(cache, m_shape, [this] { return rewritePlaceholders(m_shape.dialect, assemble()); });
+    return bind(compiled, bindValues());
+}
 
-    if (!m_orderBy.empty()) {
-        query += " ORDER BY " + m_orderBy;
-    }
+BuiltQuery QueryBuilder::raw(const SqlDialect dialect, const std::string& sql, std::vector<std::string> params) {
+    thread_local std::array<CompiledCache<std::string, std::hash<std::string>>, 3> caches;  // One per SqlDialect
+    const auto compiled = lookup(caches.at(static_cast<size_t>(dialect)), sql,
+                                 [dialect, &sql] { return rewritePlaceholders(dialect, sql); });
+    return bind(compiled, std::move(params));
+}
+
+std::string QueryBuilder::assemble() const {
+    const SqlDialect dialect = m_shape.dialect;
+    std::string query;
+    const auto whereClause = [&] {
+        if (!m_shape.conditions.empty()) {
+            query += " WHERE " + (m_shape.conditions.size() == 1 ? m_shape.conditions.front()
+                                                                 : "(" + join(m_shape.conditions, ") AND (") + ")");
+        }
+    };
+
+    switch (m_shape.statement) {
+        case Statement::Select: {
+            query = "SELECT ";
+            query += m_shape.selectColumns.empty() ? "*" : join(m_shape.selectColumns, ", ");
+            query += " FROM " + m_shape.table;
+            for (const auto& join : m_shape.joins) {
+                query += " " + join;
+            }
+            whereClause();
+            if (!m_shape.orderBy.empty()) {
+                query += " ORDER BY " + join(m_shape.orderBy, ", ");
+            }
 
-    if (m_limit > 0) {
-        query += " LIMIT " + std::to_string(m_limit);
+            // MariaDB's prepared statements reject LIMIT and OFFSET bound as strings; write the numbers instead
+            const auto number = [dialect](const size_t value) {
+                return dialect == SqlDialect::MariaDB ? std::to_string(value) : std::string("?");
+            };
+            if (m_limit) {
+                query += " LIMIT " + number(*m_limit);
+            } else if (m_offset && dialect != SqlDialect::PostgreSQL) {
+                query += std::string(" LIMIT ") + (dialect == SqlDialect::MariaDB ? kMariaDBNoLimit : kSQLiteNoLimit);
+            }
+            if (m_offset) {
+                query += " OFFSET " + number(*m_offset);
+            }
+            if (m_shape.skipLocked && dialect != SqlDialect::SQLite) {
+                query += " FOR UPDATE SKIP LOCKED";
+            }
+            break;
+        }
+        case Statement::Insert: {
+            query = "INSERT INTO " + m_shape.table + " (" + join(m_shape.setColumns, ", ") + ") VALUES (?";
+            for (size_t i = 1; i < m_shape.setColumns.size(); ++i) {
+                query += ", ?";
+            }
+            query += ")";
+            if (!m_shape.returning.empty() && dialect == SqlDialect::PostgreSQL) {
+                query += " RETURNING " + m_shape.returning;
+            }
+            break;
+        }
+        case Statement::Update: {
+            query = "UPDATE " + m_shape.table + " SET " + join(m_shape.setColumns, " = ?, ") + " = ?";
+            whereClause();
+            break;
+        }
+        case Statement::Delete: {
+            query = "DELETE FROM " + m_shape.table;
+            whereClause();
+            break;
+        }
     }
+    query += ";";
+    return query;
+}
 
-    return query + ";";
+std::vector<std::string> QueryBuilder::bindValues() const {
+    std::vector<std::string> params;
+    switch (m_shape.statement) {
+        case Statement::Select:
+            params.reserve(m_conditionParams.size() + 2);
+            params.insert(params.end(), m_conditionParams.begin(), m_conditionParams.end());
+            if (m_shape.dialect != SqlDialect::MariaDB) {
+                if (m_limit) params.push_back(std::to_string(*m_limit));
+                if (m_offset) params.push_back(std::to_string(*m_offset));
+            }
+            break;
+        case Statement::Insert:
+            params = m_setParams;
+            break;
+        case Statement::Update:
+            params.reserve(m_setParams.size() + m_conditionParams.size());
+            params.insert(params.end(), m_setParams.begin(), m_setParams.end());
+            params.insert(params.end(), m_conditionParams.begin(), m_conditionParams.end());
+            break;
+        case Statement::Delete:
+            params = m_conditionParams;
+            break;
+    }
+    return params;
 }
 
 std::string QueryBuilder::join(const std::vector<std::string>& elements, const std::string& delimiter) {
@@ -72,4 +310,4 @@ std::string QueryBuilder::join(const std::vector<std::string>& elements, const s
         }
     }
     return result;
-}
\ No newline at end of file
+}
@@ -1,35 +1,149 @@
 #pragma once
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include "database/SqlDialect.hpp"
+
+/**
+ * @brief SQL text and bind values produced by QueryBuilder.
+ */
+struct BuiltQuery {
+    std::shared_ptr<const std::string> text;  ///< SQL text, shared by the queries of one shape built on one thread.
+    std::vector<std::string> params;          ///< Values for the placeholders, in order.
+
+    [[nodiscard]] const std::string& sql() const { return *text; }
+};
 
 /**
  * @brief A class for building SQL queries dynamically.
  *
- * QueryBuilder provides a fluent API for constructing SQL SELECT queries,
- * allowing the user to specify columns, tables, conditions, joins, order, and limits.
+ * QueryBuilder provides a fluent API for constructing SELECT, INSERT, UPDATE and DELETE statements.
+ * Values never become part of the SQL text: conditions mark them with `?` and pass them alongside,
+ * and build() returns the text together with the ordered bind values. The text is written for the
+ * target dialect (placeholder syntax, LIMIT/OFFSET, RETURNING, SKIP LOCKED) and cached per thread,
+ * keyed by the builder's own fields rather than by the finished text, so a repeated query shape is
+ * neither reassembled nor rewritten and hits the backends' prepared statement caches.
  */
 class QueryBuilder {
 public:
     enum class OrderDirection { ASC, DESC };
 
+    /**
+     * @param dialect Dialect the SQL is written for, usually IDatabase::dialect() of the target database.
+     */
+    explicit QueryBuilder(SqlDialect dialect);
+
     QueryBuilder& select(const std::vector<std::string>& columns);
     QueryBuilder& from(const std::string& table);
-    QueryBuilder& where(const std::string& condition, const std::map<std::string, std::string>& parameters = {});
+
+    /**
+     * @brief Starts an INSERT; the row's columns and values are given with set().
+     */
+    QueryBuilder& insertInto(const std::string& table);
+
+    /**
+     * @brief Starts an UPDATE; the assignments are given with set().
+     */
+    QueryBuilder& update(const std::string& table);
+
+    QueryBuilder& deleteFrom(const std::string& table);
+
+    /**
+     * @brief Adds a column and its value to an INSERT, or an assignment to an UPDATE.
+     */
+    QueryBuilder& set(const std::string& column, std::string value);
+
+    /**
+     * @brief Adds a condition, ANDed with the others.
+     * @param condition SQL condition with a `?` for each value, e.g. "created_at >= ?".
+     *                  Question marks inside quoted literals are left alone.
+     * @param params Values for the condition's placeholders, in order.
+     */
+    QueryBuilder& where(const std::string& condition, std::vector<std::string> params = {});
+
     QueryBuilder& join(const std::string& table, const std::string& condition);
-    QueryBuilder& limit(int limit);
+
+    /**
+     * @brief Bound as a parameter, except on MariaDB, whose prepared statements reject the string
+     * parameters every value is bound as; the number is written into the text there.
+     */
+    QueryBuilder& limit(size_t limit);
+    QueryBuilder& offset(size_t offset);
+
+    /**
+     * @brief Adds a sort key; keys apply in the order they are added.
+     */
     QueryBuilder& orderBy(const std::string& column, OrderDirection direction = OrderDirection::ASC);
-    [[nodiscard]] std::string build() const;
+
+    /**
+     * @brief Locks the selected rows, skipping rows locked by other transactions, so concurrent
+     * workers can claim different rows. Omitted on SQLite, where the write transaction already
+     * excludes every other writer.
+     */
+    QueryBuilder& forUpdateSkipLocked();
+
+    /**
+     * @brief Makes an INSERT report its generated key the way the dialect's
+     * IDatabase::executeInsertReturningId reads it: a RETURNING clause on PostgreSQL, the
+     * connection's last insert ID elsewhere (no clause).
+     */
+    QueryBuilder& returningId(const std::string& column = "id");
+
+    /**
+     * @brief Produces the SQL text and bind values.
+     * @throws std::logic_error if the statement is incomplete or the placeholders and values do not match.
+     */
+    [[nodiscard]] BuiltQuery build() const;
+
+    /**
+     * @brief Compiles a hand-written statement that marks its values with `?`, cached per thread by its text.
+     * @throws std::logic_error if the placeholders and values do not match.
+     */
+    static BuiltQuery raw(SqlDialect dialect, const std::string& sql, std::vector<std::string> params = {});
 
 private:
-    std::vector<std::string> m_selectColumns;
-    std::string m_table;
-    std::vector<std::string> m_conditions;
-    std::vector<std::string> m_joins;
-    int m_limit = -1;
-    std::string m_orderBy;
-    std::map<std::string, std::string> m_parameters;
+    enum class Statement { Select, Insert, Update, Delete };
+
+    /**
+     * @brief Everything that decides the SQL text, as opposed to the bind values; the key of build()'s cache.
+     */
+    struct Shape {
+        SqlDialect dialect;
+        Statement statement = Statement::Select;
+        std::vector<std::string> selectColumns;
+        std::string table;
+        std::vector<std::string> setColumns;  ///< INSERT columns or UPDATE assignments.
+        std::vector<std::string> conditions;
+        std::vector<std::string> joins;
+        std::vector<std::string> orderBy;
+        std::optional<size_t> limit;          ///< The value on MariaDB, which writes it into the text; 0 elsewhere.
+        std::optional<size_t> offset;         ///< Same as limit.
+        bool skipLocked = false;
+        std::string returning;
+
+        bool operator==(const Shape& other) const;
+    };
+    struct ShapeHash;
+
+    /**
+     * @brief Writes the statement with `?` placeholders.
+     */
+    [[nodiscard]] std::string assemble() const;
+
+    /**
+     * @brief Collects the bind values in the order assemble() places their placeholders.
+     */
+    [[nodiscard]] std::vector<std::string> bindValues() const;
+
+    Shape m_shape;
+    std::vector<std::string> m_setParams;        ///< Values for the shape's setColumns.
+    std::vector<std::string> m_conditionParams;  ///< Values for the shape's conditions.
+    std::optional<size_t> m_limit;
+    std::optional<size_t> m_offset;
 
     static std::string join(const std::vector<std::string>& elements, const std::string& delimiter);
-};
\ No newline at end of file
+};
@@ -0,0 +1,98 @@
+#include "ResultSet.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+    bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    T parseNumber(std::string_view text, size_t column) {
+        T value{};
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size()) {
+            throw std::runtime_error("ResultSet: column " + std::to_string(column) + " is not numeric: '" +
+                                     std::string(text) + "'");
+        }
+        return value;
+    }
+}
+
+int64_t ResultSet::Row::getInt64(size_t column) const {
+    if (isNull(column)) {
+        throw std::runtime_error("ResultSet: column " + std::to_string(column) + " is NULL");
+    }
+    return parseNumber<int64_t>((*this)[column], column);
+}
+
+double ResultSet::Row::getDouble(size_t column) const {
+    if (isNull(column)) {
+        throw std::runtime_error("ResultSet: column " + std::to_string(column) + " is NULL");
+    }
+    return parseNumber<double>((*this)[column], column);
+}
+
+std::optional<int64_t> ResultSet::Row::getOptionalInt64(size_t column) const {
+    if (isNull(column)) {
+        return std::nullopt;
+    }
+    return parseNumber<int64_t>((*this)[column], column);
+}
+
+std::optional<double> ResultSet::Row::getOptionalDouble(size_t column) const {
+    if (isNull(column)) {
+        return std::nullopt;
+    }
+    return parseNumber<double>((*this)[column], column);
+}
+
+std::optional<std::string_view> ResultSet::Row::getOptionalString(size_t column) const {
+    if (isNull(column)) {
+        return std::nullopt;
+    }
+    return (*this)[column];
+}
+
+std::optional<size_t> ResultSet::findColumn(std::string_view name) const {
+    const size_t count = columnCount();
+    for (size_t i = 0; i < count; ++i) {
+        if (equalsIgnoreCase(columnName(i), name)) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+size_t ResultSet::columnIndex(std::string_view name) const {
+    if (auto index = findColumn(name)) {
+        return *index;
+    }
+    throw std::runtime_error("ResultSet: no column named '" + std::string(name) + "'");
+}
+
+std::vector<std::vector<std::string>> ResultSet::toRows() const {
+    const size_t rows = rowCount();
+    const size_t columns = columnCount();
+    std::vector<std::vector<std::string>> result;
+    result.reserve(rows);
+    for (size_t r = 0; r < rows; ++r) {
+        std::vector<std::string> row;
+        row.reserve(columns);
+        for (size_t c = 0; c < columns; ++c) {
+            row.emplace_back(value(r, c));
+        }
+        result.push_back(std::move(row));
+    }
+    return result;
+}
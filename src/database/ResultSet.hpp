@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class ResultSet
+ * @brief Read-only view of a query result whose cells are string_views over buffers owned by the result.
+ *
+ * Cells stay valid for the lifetime of the ResultSet. Rows are accessed through lightweight Row views
+ * with typed getters, so callers can convert values without allocating intermediate strings.
+ * Columns can be addressed by index or by name; names match case-insensitively because PostgreSQL
+ * folds unquoted identifiers to lower case.
+ */
+class ResultSet {
+public:
+    /**
+     * @brief View of a single row; valid as long as its ResultSet.
+     */
+    class Row {
+    public:
+        Row(const ResultSet* result, size_t index) : m_result(result), m_index(index) {}
+
+        [[nodiscard]] size_t index() const { return m_index; }
+        [[nodiscard]] size_t size() const { return m_result->columnCount(); }
+
+        /// Raw cell text; empty for NULL.
+        std::string_view operator[](size_t column) const { return m_result->value(m_index, column); }
+        [[nodiscard]] bool isNull(size_t column) const { return m_result->isNull(m_index, column); }
+
+        [[nodiscard]] std::string_view getString(size_t column) const { return (*this)[column]; }
+        [[nodiscard]] std::string_view getString(std::string_view name) const { return getString(m_result->columnIndex(name)); }
+
+        /// @throws std::runtime_error if the cell is NULL or not an integer.
+        [[nodiscard]] int64_t getInt64(size_t column) const;
+        [[nodiscard]] int64_t getInt64(std::string_view name) const { return getInt64(m_result->columnIndex(name)); }
+
+        /// @throws std::runtime_error if the cell is NULL or not a number.
+        [[nodiscard]] double getDouble(size_t column) const;
+        [[nodiscard]] double getDouble(std::string_view name) const { return getDouble(m_result->columnIndex(name)); }
+
+        /// std::nullopt for NULL. @throws std::runtime_error if the cell is not an integer.
+        [[nodiscard]] std::optional<int64_t> getOptionalInt64(size_t column) const;
+        [[nodiscard]] std::optional<int64_t> getOptionalInt64(std::string_view name) const { return getOptionalInt64(m_result->columnIndex(name)); }
+
+        /// std::nullopt for NULL. @throws std::runtime_error if the cell is not a number.
+        [[nodiscard]] std::optional<double> getOptionalDouble(size_t column) const;
+        [[nodiscard]] std::optional<double> getOptionalDouble(std::string_view name) const { return getOptionalDouble(m_result->columnIndex(name)); }
+
+        /// std::nullopt for NULL.
+        [[nodiscard]] std::optional<std::string_view> getOptionalString(size_t column) const;
+        [[nodiscard]] std::optional<std::string_view> getOptionalString(std::string_view name) const { return getOptionalString(m_result->columnIndex(name)); }
+
+    private:
+        const ResultSet* m_result;
+        size_t m_index;
+    };
+
+    /**
+     * @brief Forward iterator over the rows of a ResultSet.
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Row;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Row;
+
+        Iterator(const ResultSet* result, size_t index) : m_result(result), m_index(index) {}
+        Row operator*() const { return Row(m_result, m_index); }
+        Iterator& operator++() { ++m_index; return *this; }
+        Iterator operator++(int) { Iterator previous = *this; ++m_index; return previous; }
+        bool operator==(const Iterator& other) const { return m_index == other.m_index && m_result == other.m_result; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        const ResultSet* m_result;
+        size_t m_index;
+    };
+
+    virtual ~ResultSet() = default;
+
+    [[nodiscard]] virtual size_t rowCount() const = 0;
+    [[nodiscard]] virtual size_t columnCount() const = 0;
+    [[nodiscard]] virtual std::string_view columnName(size_t column) const = 0;
+
+    /**
+     * @brief Returns the text of a cell; empty for NULL.
+     */
+    [[nodiscard]] virtual std::string_view value(size_t row, size_t column) const = 0;
+    [[nodiscard]] virtual bool isNull(size_t row, size_t column) const = 0;
+
+    /**
+     * @brief Looks up a column by name, ignoring case.
+     * @return The column index, or std::nullopt if there is no such column.
+     */
+    [[nodiscard]] std::optional<size_t> findColumn(std::string_view name) const;
+
+    /**
+     * @brief Looks up a column by name, ignoring case.
+     * @throws std::runtime_error if there is no such column.
+     */
+    [[nodiscard]] size_t columnIndex(std::string_view name) const;
+
+    [[nodiscard]] bool empty() const { return rowCount() == 0; }
+    [[nodiscard]] Row row(size_t index) const { return Row(this, index); }
+    Row operator[](size_t index) const { return row(index); }
+    [[nodiscard]] Iterator begin() const { return Iterator(this, 0); }
+    [[nodiscard]] Iterator end() const { return Iterator(this, rowCount()); }
+
+    /**
+     * @brief Copies the result into the row-of-strings layout returned by IDatabase::fetchQuery.
+     */
+    [[nodiscard]] std::vector<std::vector<std::string>> toRows() const;
+};
@@ -0,0 +1,317 @@
+#include "SchemaMigrator.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include "database/QueryBuilder.hpp"
+#include "utils/Logger.hpp"
+
+namespace {
+    // Same spelling on every backend
+    constexpr const char* kCreateVersionTable =
+        "CREATE TABLE IF NOT EXISTS schema_migrations ("
+        "version INTEGER PRIMARY KEY, "
+        "description VARCHAR(255) NOT NULL, "
+        "applied_at BIGINT NOT NULL);";
+
+    constexpr const char* kSelectVersion = "SELECT MAX(version) FROM schema_migrations;";
+
+    // Serializes migrators of one PostgreSQL database until their transaction ends; any fixed key works
+    constexpr const char* kPostgreSQLLock = "SELECT pg_advisory_xact_lock(4206605716);";
+
+    /**
+     * @brief CASE expression giving the JobStatus value of a status read as text.
+     *
+     * Matches both the status name, as jobs tables made before the migrations stored it, and the value
+     * already written as digits; anything else becomes UNKNOWN (5).
+     */
+    std::string statusValueOf(const std::string& text) {
+        constexpr const char* kNames[] = {"PENDING", "IN_PROGRESS", "COMPLETED", "FAILED", "CANCELLED", "UNKNOWN"};
+        std::string expression = "CASE " + text;
+        for (int value = 0; value < 6; ++value) {
+            const std::string digits = std::to_string(value);
+            expression += std::string(" WHEN '") + kNames[value] + "' THEN " + digits + " WHEN '" + digits + "' THEN " + digits;
+        }
+        return expression + " ELSE 5 END";
+    }
+
+    int versionOf(const ResultSet& result) {
+        if (result.empty()) {
+            return 0;
+        }
+        return static_cast<int>(result.row(0).getOptionalInt64(0).value_or(0));
+    }
+}
+
+const std::string& SchemaColumn::definition(const SqlDialect dialect) const {
+    switch (dialect) {
+        case SqlDialect::PostgreSQL: return postgresql;
+        case SqlDialect::MariaDB: return mariadb;
+        case SqlDialect::SQLite: break;
+    }
+    return sqlite;
+}
+
+const std::vector<std::string>& SchemaMigration::statements(const SqlDialect dialect) const {
+    switch (dialect) {
+        case SqlDialect::PostgreSQL: return postgresql;
+        case SqlDialect::MariaDB: return mariadb;
+        case SqlDialect::SQLite: break;
+    }
+    return sqlite;
+}
+
+std::vector<SchemaMigration> SchemaMigrator::applicationMigrations() {
+    // Job status is stored as its JobStatus value (PENDING = 0 ... UNKNOWN = 5); JobRepository converts.
+    // A jobs table made by hand before the migrations existed stored the status name, which the integer
+    // filters of JobRepository never match, so migration 1 rewrites such statuses and, where the backend
+    // can, turns the column into an integer one.
+    return {
+        {1, "Create application tables",
+         {
+             "CREATE TABLE IF NOT EXISTS jobs ("
+             "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+             "inputFile TEXT NOT NULL, "
+             "outputFile TEXT NOT NULL, "
+             "options TEXT, "
+             "status INTEGER NOT NULL DEFAULT 0, "
+             "message TEXT, "
+             "checkpoint TEXT, "
+             "template_id TEXT, "
+             "priority INTEGER NOT NULL DEFAULT 0, "
+             "created_at INTEGER NOT NULL);",
+             "CREATE TABLE IF NOT EXISTS encoding_templates ("
+             "id TEXT PRIMARY KEY, "
+             "description TEXT, "
+             "ffmpeg_command TEXT, "
+             "settings TEXT);",
+             "CREATE TABLE IF NOT EXISTS metadata_cache (cache_key TEXT PRIMARY KEY, metadata TEXT NOT NULL);",
+             "CREATE TABLE IF NOT EXISTS keyframe_index (cache_key TEXT PRIMARY KEY, data TEXT NOT NULL);",
+             // SQLite cannot change a column's type; a TEXT column holding the digits compares equal to the
+             // bound values
+             "UPDATE jobs SET status = " + statusValueOf("CAST(status AS TEXT)") + " WHERE typeof(status) <> 'integer';",
+         },
+         {
+             "CREATE TABLE IF NOT EXISTS jobs ("
+             "id SERIAL PRIMARY KEY, "
+             "inputFile TEXT NOT NULL, "
+             "outputFile TEXT NOT NULL, "
+             "options TEXT, "
+             "status SMALLINT NOT NULL DEFAULT 0, "
+             "message TEXT, "
+             "checkpoint TEXT, "
+             "template_id TEXT, "
+             "priority SMALLINT NOT NULL DEFAULT 0, "
+             "created_at BIGINT NOT NULL);",
+             "CREATE TABLE IF NOT EXISTS encoding_templates ("
+             "id TEXT PRIMARY KEY, "
+             "description TEXT, "
+             "ffmpeg_command TEXT, "
+             "settings TEXT);",
+             "CREATE TABLE IF NOT EXISTS metadata_cache (cache_key TEXT PRIMARY KEY, metadata TEXT NOT NULL);",
+             "CREATE TABLE IF NOT EXISTS keyframe_index (cache_key TEXT PRIMARY KEY, data TEXT NOT NULL);",
+             "ALTER TABLE jobs ALTER COLUMN status DROP DEFAULT;",
+             "ALTER TABLE jobs ALTER COLUMN status TYPE SMALLINT USING " + statusValueOf("status::text") + ";",
+             "ALTER TABLE jobs ALTER COLUMN status SET DEFAULT 0;",
+         },
+         {
+             // Indexed text columns need a bounded VARCHAR on InnoDB
+             "CREATE TABLE IF NOT EXISTS jobs ("
+             "id INT AUTO_INCREMENT PRIMARY KEY, "
+             "inputFile TEXT NOT NULL, "
+             "outputFile TEXT NOT NULL, "
+             "options TEXT, "
+             "status TINYINT NOT NULL DEFAULT 0, "
+             "message TEXT, "
+             "checkpoint MEDIUMTEXT, "
+             "template_id VARCHAR(255), "
+             "priority SMALLINT NOT NULL DEFAULT 0, "
+             "created_at BIGINT NOT NULL) ENGINE=InnoDB;",
+             "CREATE TABLE IF NOT EXISTS encoding_templates ("
+             "id VARCHAR(255) PRIMARY KEY, "
+             "description TEXT, "
+             "ffmpeg_command TEXT, "
+             "settings MEDIUMTEXT) ENGINE=InnoDB;",
+             "CREATE TABLE IF NOT EXISTS metadata_cache ("
+             "cache_key VARCHAR(512) PRIMARY KEY, metadata MEDIUMTEXT NOT NULL) ENGINE=InnoDB;",
+             "CREATE TABLE IF NOT EXISTS keyframe_index ("
+             "cache_key VARCHAR(512) PRIMARY KEY, data LONGTEXT NOT NULL) ENGINE=InnoDB;",
+             // Before migration 2 indexes it: InnoDB cannot index a TEXT status without a prefix length
+             "UPDATE jobs SET status = " + statusValueOf("CAST(status AS CHAR)") + ";",
+             "ALTER TABLE jobs MODIFY status TINYINT NOT NULL DEFAULT 0;",
+         },
+         // A jobs table made by hand before the migrations existed has only the columns up to message;
+         // the CREATE above leaves it alone, so the later columns and migration 2's indexes need these
+         {
+             {"jobs", "checkpoint", "TEXT", "TEXT", "MEDIUMTEXT"},
+             {"jobs", "template_id", "TEXT", "TEXT", "VARCHAR(255)"},
+             {"jobs", "priority", "INTEGER NOT NULL DEFAULT 0", "SMALLINT NOT NULL DEFAULT 0", "SMALLINT NOT NULL DEFAULT 0"},
+             {"jobs", "created_at", "INTEGER NOT NULL DEFAULT 0", "BIGINT NOT NULL DEFAULT 0", "BIGINT NOT NULL DEFAULT 0"},
+         }},
+
+        // Claiming the next job filters on status and takes the highest priority, oldest first; listing
+        // pages through one status, template or creation range in ID order. Every index ends in id so
+        // both are served from the index alone. Status is bound as a parameter, which neither SQLite nor
+        // a generic PostgreSQL plan can match against a partial index predicate, so status leads the
+        // claim index instead of filtering it.
+        {2, "Add job claim and listing indexes",
+         {
+             "CREATE INDEX IF NOT EXISTS idx_jobs_claim ON jobs (status, priority DESC, created_at, id);",
+             "CREATE INDEX IF NOT EXISTS idx_jobs_status_id ON jobs (status, id);",
+             "CREATE INDEX IF NOT EXISTS idx_jobs_template_id ON jobs (template_id, id);",
+             "CREATE INDEX IF NOT EXISTS idx_jobs_created_at_id ON jobs (created_at, id);",
+         },
+         {
+             "CREATE INDEX IF NOT EXISTS idx_jobs_claim ON jobs (status, priority DESC, created_at, id);",
+             "CREATE INDEX IF NOT EXISTS idx_jobs_status_id ON jobs (status, id);",
+             "CREATE INDEX IF NOT EXISTS idx_jobs_template_id ON jobs (template_id, id);",
+             "CREATE INDEX IF NOT EXISTS idx_jobs_created_at_id ON jobs (created_at, id);",
+         },
+         {
+             "CREATE INDEX IF NOT EXISTS idx_jobs_claim ON jobs (status, priority DESC, created_at, id);",
+             "CREATE INDEX IF NOT EXISTS idx_jobs_status_id ON jobs (status, id);",
+             "CREATE INDEX IF NOT EXISTS idx_jobs_template_id ON jobs (template_id, id);",
+             "CREATE INDEX IF NOT EXISTS idx_jobs_created_at_id ON jobs (created_at, id);",
+         }},
+
+        // Recovered jobs are queued again with the deadline they were submitted with; 0 means none
+        {3, "Store job deadlines",
+         {},
+         {},
+         {},
+         {
+             {"jobs", "deadline", "INTEGER NOT NULL DEFAULT 0", "BIGINT NOT NULL DEFAULT 0", "BIGINT NOT NULL DEFAULT 0"},
+         }},
+
+        // MetadataCacheRepository deletes cache entries unused for longer than metadata.cache.max_age_days.
+        // Entries stored before this migration count as used now, so they get a full max age.
+        {4, "Track metadata cache entry use",
+         {
+             "ALTER TABLE metadata_cache ADD COLUMN last_used_at INTEGER NOT NULL DEFAULT 0;",
+             "ALTER TABLE keyframe_index ADD COLUMN last_used_at INTEGER NOT NULL DEFAULT 0;",
+             "UPDATE metadata_cache SET last_used_at = CAST(strftime('%s', 'now') AS INTEGER);",
+             "UPDATE keyframe_index SET last_used_at = CAST(strftime('%s', 'now') AS INTEGER);",
+             "CREATE INDEX IF NOT EXISTS idx_metadata_cache_last_used_at ON metadata_cache (last_used_at);",
+             "CREATE INDEX IF NOT EXISTS idx_keyframe_index_last_used_at ON keyframe_index (last_used_at);",
+         },
+         {
+             "ALTER TABLE metadata_cache ADD COLUMN IF NOT EXISTS last_used_at BIGINT NOT NULL DEFAULT 0;",
+             "ALTER TABLE keyframe_index ADD COLUMN IF NOT EXISTS last_used_at BIGINT NOT NULL DEFAULT 0;",
+             "UPDATE metadata_cache SET last_used_at = EXTRACT(EPOCH FROM now())::BIGINT;",
+             "UPDATE keyframe_index SET last_used_at = EXTRACT(EPOCH FROM now())::BIGINT;",
+             "CREATE INDEX IF NOT EXISTS idx_metadata_cache_last_used_at ON metadata_cache (last_used_at);",
+             "CREATE INDEX IF NOT EXISTS idx_keyframe_index_last_used_at ON keyframe_index (last_used_at);",
+         },
+         {
+             "ALTER TABLE metadata_cache ADD COLUMN IF NOT EXISTS last_used_at BIGINT NOT NULL DEFAULT 0;",
+             "ALTER TABLE keyframe_index ADD COLUMN IF NOT EXISTS last_used_at BIGINT NOT NULL DEFAULT 0;",
+             "UPDATE metadata_cache SET last_used_at = UNIX_TIMESTAMP() WHERE last_used_at = 0;",
+             "UPDATE keyframe_index SET last_used_at = UNIX_TIMESTAMP() WHERE last_used_at = 0;",
+             "CREATE INDEX IF NOT EXISTS idx_metadata_cache_last_used_at ON metadata_cache (last_used_at);",
+             "CREATE INDEX IF NOT EXISTS idx_keyframe_index_last_used_at ON keyframe_index (last_used_at);",
+         }},
+    };
+}
+
+SchemaMigrator::SchemaMigrator(std::shared_ptr<IDatabase> database, std::vector<SchemaMigration> migrations)
+    : m_database(std::move(database)), m_migrations(std::move(migrations)) {
+    int previous = 0;
+    for (const auto& migration : m_migrations) {
+        if (migration.version <= previous) {
+            throw std::invalid_argument("Schema migration versions must be positive and increasing, got " +
+                                        std::to_string(migration.version) + " after " + std::to_string(previous));
+        }
+        previous = migration.version;
+    }
+}
+
+int SchemaMigrator::migrate() const {
+    ensureVersionTable();
+    const int current = currentVersion();
+
+    int applied = 0;
+    for (const auto& migration : m_migrations) {
+        if (migration.version > current && apply(migration)) {
+            ++applied;
+        }
+    }
+
+    if (applied > 0) {
+        Logger::getInstance().info("Applied " + std::to_string(applied) + " schema migrations, schema is at version " +
+                                   std::to_string(currentVersion()));
+    } else {
+        Logger::getInstance().debug("Schema is up to date at version " + std::to_string(current));
+    }
+    return applied;
+}
+
+int SchemaMigrator::currentVersion() const {
+    return versionOf(*m_database->fetchResult(kSelectVersion, {}));
+}
+
+void SchemaMigrator::ensureVersionTable() const {
+    if (m_database->executeQuery(kCreateVersionTable) < 0) {
+        throw std::runtime_error("Failed to create the schema_migrations table");
+    }
+}
+
+bool SchemaMigrator::apply(const SchemaMigration& migration) const {
+    const std::string name = std::to_string(migration.version) + " (" + migration.description + ")";
+    const SqlDialect dialect = m_database->dialect();
+    const auto transaction = m_database->beginTransaction();
+
+    try {
+        if (dialect == SqlDialect::PostgreSQL) {
+            transaction->fetchResult(kPostgreSQLLock, {});
+        }
+        // Re-read under the lock: another instance may have applied it since migrate() looked
+        if (versionOf(*transaction->fetchResult(kSelectVersion, {})) >= migration.version) {
+            transaction->rollback();
+            return false;
+        }
+
+        for (const auto& statement : migration.statements(dialect)) {
+            if (transaction->executeQuery(statement, {}) < 0) {
+                throw std::runtime_error("statement failed: " + statement);
+            }
+        }
+        for (const auto& column : migration.columns) {
+            addColumnIfMissing(*transaction, dialect, column);
+        }
+
+        const auto record = QueryBuilder(dialect)
+                                .insertInto("schema_migrations")
+                                .set("version", std::to_string(migration.version))
+                                .set("description", migration.description)
+                                .set("applied_at", std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+                                    std::chrono::system_clock::now().time_since_epoch()).count()))
+                                .build();
+        if (transaction->executeQuery(record.sql(), record.params) < 0) {
+            throw std::runtime_error("failed to record the schema version");
+        }
+        transaction->commit();
+    } catch (const std::exception& e) {
+        try {
+            transaction->rollback();
+        } catch (const std::exception&) {
+            // The connection is unusable; the failure below is the one worth reporting
+        }
+        throw std::runtime_error("Schema migration " + name + " failed: " + e.what());
+    }
+
+    Logger::getInstance().info("Applied schema migration " + name);
+    return true;
+}
+
+void SchemaMigrator::addColumnIfMissing(ITransaction& transaction, const SqlDialect dialect, const SchemaColumn& column) {
+    // An empty result still names every column, on each backend
+    const auto probe = transaction.fetchResult("SELECT * FROM " + column.table + " WHERE 1 = 0;", {});
+    if (probe->findColumn(column.name)) {
+        return;
+    }
+    const std::string statement =
+        "ALTER TABLE " + column.table + " ADD COLUMN " + column.name + " " + column.definition(dialect) + ";";
+    if (transaction.executeQuery(statement, {}) < 0) {
+        throw std::runtime_error("statement failed: " + statement);
+    }
+    Logger::getInstance().info("Added missing column " + column.table + "." + column.name);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "database/interfaces/IDatabase.hpp"
+
+/**
+ * @brief A column that a table created before the migrations existed may lack, written once per dialect.
+ */
+struct SchemaColumn {
+    std::string table;
+    std::string name;
+    std::string sqlite;      ///< Column definition on SQLite, e.g. "INTEGER NOT NULL DEFAULT 0".
+    std::string postgresql;  ///< Column definition on PostgreSQL.
+    std::string mariadb;     ///< Column definition on MariaDB.
+
+    [[nodiscard]] const std::string& definition(SqlDialect dialect) const;
+};
+
+/**
+ * @brief One versioned schema change, written once per dialect.
+ */
+struct SchemaMigration {
+    int version;                          ///< Position in the schema history; strictly increasing.
+    std::string description;              ///< Recorded in schema_migrations alongside the version.
+    std::vector<std::string> sqlite;      ///< Statements run on SQLite, in order.
+    std::vector<std::string> postgresql;  ///< Statements run on PostgreSQL, in order.
+    std::vector<std::string> mariadb;     ///< Statements run on MariaDB, in order.
+    std::vector<SchemaColumn> columns;    ///< Added after the statements to tables that do not have them yet.
+
+    [[nodiscard]] const std::vector<std::string>& statements(SqlDialect dialect) const;
+};
+
+/**
+ * @class SchemaMigrator
+ * @brief Brings the database schema up to date by applying versioned migrations.
+ *
+ * Applied versions are recorded in the schema_migrations table. Each pending migration runs in its own
+ * transaction together with the insert of its version row, so a failed migration leaves no record and
+ * is retried on the next start. PostgreSQL takes an advisory lock and SQLite an immediate write lock for
+ * the transaction, so instances starting together apply each migration once. MariaDB commits DDL
+ * implicitly; its statements are written with IF NOT EXISTS so a migration interrupted halfway can run
+ * again, and its columns are only added when missing.
+ */
+class SchemaMigrator {
+public:
+    /**
+     * @param database Connected database to migrate.
+     * @param migrations Migrations in ascending version order; defaults to the application schema.
+     * @throws std::invalid_argument if the versions are not positive and strictly increasing.
+     */
+    explicit SchemaMigrator(std::shared_ptr<IDatabase> database,
+                            std::vector<SchemaMigration> migrations = applicationMigrations());
+
+    /**
+     * @brief Applies every migration newer than the recorded schema version.
+     * @return Number of migrations applied by this call.
+     * @throws std::runtime_error if a migration fails; the migrations before it stay applied.
+     */
+    int migrate() const;
+
+    /**
+     * @brief Returns the newest applied version, or 0 for an empty database.
+     * @throws std::runtime_error if the version table cannot be read.
+     */
+    [[nodiscard]] int currentVersion() const;
+
+    /**
+     * @brief The schema of the jobs, encoding_templates, metadata_cache and keyframe_index tables.
+     */
+    static std::vector<SchemaMigration> applicationMigrations();
+
+private:
+    void ensureVersionTable() const;
+
+    /**
+     * @brief Applies one migration unless another instance applied it first.
+     * @return True if this call applied it.
+     */
+    bool apply(const SchemaMigration& migration) const;
+
+    /**
+     * @brief Adds the column within the migration's transaction unless its table already has it.
+     */
+    static void addColumnIfMissing(ITransaction& transaction, SqlDialect dialect, const SchemaColumn& column);
+
+    std::shared_ptr<IDatabase> m_database;
+    std::vector<SchemaMigration> m_migrations;
+};
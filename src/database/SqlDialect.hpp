@@ -0,0 +1,12 @@
+#pragma once
+
+/**
+ * @brief SQL flavour spoken by a database backend.
+ *
+ * Decides placeholder syntax and which clauses QueryBuilder emits; see QueryBuilder::build.
+ */
+enum class SqlDialect {
+    SQLite,      ///< `?` placeholders; no row locks.
+    PostgreSQL,  ///< `$1`, `$2`, ... placeholders; RETURNING; FOR UPDATE SKIP LOCKED.
+    MariaDB      ///< `?` placeholders; FOR UPDATE SKIP LOCKED (10.6+).
+};
@@ -1,15 +1,44 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <condition_variable>
 #include "ITransaction.hpp"
+#include "database/ConnectionPoolMetrics.hpp"
+#include "database/ResultSet.hpp"
+#include "database/SqlDialect.hpp"
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include "utils/ThreadPool.hpp"
+
+/**
+ * @brief One statement of a batch passed to IDatabase::executeBatch.
+ */
+struct BatchStatement {
+    std::string query;                ///< SQL with placeholders.
+    std::vector<std::string> params;  ///< Values bound to the placeholders, in order.
+};
 
 /**
  * @brief Interface for database operations, supporting single or pooled connections.
  */
 class IDatabase {
 public:
+    /**
+     * @brief Receives the outcome of executeQueryAsync: affected rows, or -1 if the statement failed.
+     */
+    using ExecuteCallback = std::function<void(int affectedRows)>;
+
+    /**
+     * @brief Receives the outcome of fetchResultAsync: the result, or null and the exception fetchResult would have thrown.
+     */
+    using FetchCallback = std::function<void(std::unique_ptr<ResultSet> result, std::exception_ptr error)>;
+
     virtual ~IDatabase() = default;
 
     /**
@@ -29,6 +58,11 @@ public:
      */
     [[nodiscard]] virtual bool isConnected() const = 0;
 
+    /**
+     * @brief Returns the SQL dialect of the backend, for QueryBuilder.
+     */
+    [[nodiscard]] virtual SqlDialect dialect() const = 0;
+
     /**
      * @brief Executes a non-select query (e.g., INSERT, UPDATE, DELETE) with optional parameter binding.
      *
@@ -74,9 +108,82 @@ public:
     virtual std::vector<std::vector<std::string>> fetchQuery(const std::string& query, const std::vector<std::string>& params) = 0;
 
     /**
-     * @brief Begins a transaction.
+     * @brief Executes a select query with parameters and returns a typed, zero-copy view of the result.
+     *
+     * Unlike fetchQuery, cells are not copied into individual strings: they are string_views over the
+     * buffers of the returned ResultSet, with typed getters and column lookup by name.
+     *
+     * @param query The SQL query with placeholders for parameters.
+     * @param params A vector of values to bind to the query's placeholders, in sequential order.
+     * @return The query result; cells remain valid as long as it lives.
+     * @throws std::runtime_error if the query fails.
+     */
+    virtual std::unique_ptr<ResultSet> fetchResult(const std::string& query, const std::vector<std::string>& params) = 0;
+
+    /**
+     * @brief Runs a non-select statement without blocking the calling thread.
+     *
+     * The statement runs on the backend's I/O thread(s), and the callback is invoked there once it
+     * completes. Callbacks must be quick and must not block or throw: they hold up the statements
+     * queued behind them.
+     *
+     * @param query The SQL query with placeholders for parameters.
+     * @param params A vector of values to bind to the query's placeholders, in sequential order.
+     * @param onDone Called with the number of affected rows, or -1 if the statement failed.
+     * @throws std::runtime_error if the database is not connected.
+     */
+    virtual void executeQueryAsync(const std::string& query, const std::vector<std::string>& params,
+                                   ExecuteCallback onDone) = 0;
+
+    /**
+     * @brief Runs a select query without blocking the calling thread.
+     *
+     * Same threading rules as the callback form of executeQueryAsync.
+     *
+     * @param query The SQL query with placeholders for parameters.
+     * @param params A vector of values to bind to the query's placeholders, in sequential order.
+     * @param onDone Called with the result, or with null and the error if the query failed.
+     * @throws std::runtime_error if the database is not connected.
+     */
+    virtual void fetchResultAsync(const std::string& query, const std::vector<std::string>& params,
+                                  FetchCallback onDone) = 0;
+
+    /**
+     * @brief Future-returning form of executeQueryAsync.
+     * @return Future of the number of affected rows, or -1 if the statement failed.
+     */
+    std::future<int> executeQueryAsync(const std::string& query, const std::vector<std::string>& params) {
+        auto promise = std::make_shared<std::promise<int>>();
+        auto future = promise->get_future();
+        executeQueryAsync(query, params, [promise](int affectedRows) { promise->set_value(affectedRows); });
+        return future;
+    }
+
+    /**
+     * @brief Future-returning form of fetchResultAsync.
+     * @return Future of the query result; get() rethrows the error if the query failed.
+     */
+    std::future<std::unique_ptr<ResultSet>> fetchResultAsync(const std::string& query, const std::vector<std::string>& params) {
+        auto promise = std::make_shared<std::promise<std::unique_ptr<ResultSet>>>();
+        auto future = promise->get_future();
+        fetchResultAsync(query, params, [promise](std::unique_ptr<ResultSet> result, std::exception_ptr error) {
+            if (error) {
+                promise->set_exception(error);
+            } else {
+                promise->set_value(std::move(result));
+            }
+        });
+        return future;
+    }
+
+    /**
+     * @brief Begins a transaction pinned to one connection.
+     *
+     * Statements must be issued through the returned object to run inside the transaction. It is
+     * rolled back if it is destroyed without being committed.
      *
      * @return A transaction object.
+     * @throws std::runtime_error if the transaction cannot be started.
      */
     virtual std::shared_ptr<ITransaction> beginTransaction() = 0;
 
@@ -97,4 +204,120 @@ public:
     * @return The last inserted row ID, or -1 if not applicable or an error occurs.
     */
     virtual int executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) = 0;
+
+    /**
+     * @brief Executes several non-select statements in order, letting the backend send them together.
+     *
+     * Each statement succeeds or fails on its own, as if it had been passed to executeQuery;
+     * a failing statement does not undo or skip the others. Backends override this to save
+     * round trips or commits; the default simply runs the statements one by one.
+     *
+     * @param statements Statements to execute, in order.
+     * @return Affected rows for each statement, or -1 for the ones that failed.
+     */
+    virtual std::vector<int> executeBatch(const std::vector<BatchStatement>& statements) {
+        std::vector<int> results;
+        results.reserve(statements.size());
+        for (const auto& statement : statements) {
+            results.push_back(executeQuery(statement.query, statement.params));
+        }
+        return results;
+    }
+
+    /**
+     * @brief Inserts many rows into a table and returns their generated IDs.
+     *
+     * Backends insert the rows in a single transaction with as few statements as they can, so the
+     * cost of a large submission is a handful of round trips and one commit rather than one of each
+     * per row. The default inserts the rows one by one and is not atomic.
+     *
+     * @param table Table to insert into; its primary key must be an auto-generated `id` column.
+     * @param columns Columns set by every row.
+     * @param rows Values of each row, in the order of `columns`.
+     * @return Generated ID of each row, in the order of `rows`.
+     * @throws std::invalid_argument if a row does not have one value per column.
+     * @throws std::runtime_error if the insert fails.
+     */
+    virtual std::vector<int> insertRows(const std::string& table, const std::vector<std::string>& columns,
+                                        const std::vector<std::vector<std::string>>& rows) {
+        checkRowWidths(columns, rows);
+
+        std::string query = "INSERT INTO " + table + " (";
+        std::string placeholders;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            query += (i ? ", " : "") + columns[i];
+            placeholders += i ? ", ?" : "?";
+        }
+        query += ") VALUES (" + placeholders + ");";
+
+        std::vector<int> ids;
+        ids.reserve(rows.size());
+        for (const auto& row : rows) {
+            const int id = executeInsertReturningId(query, row);
+            if (id < 0) {
+                throw std::runtime_error("Failed to insert row " + std::to_string(ids.size()) + " into " + table);
+            }
+            ids.push_back(id);
+        }
+        return ids;
+    }
+
+    /**
+     * @brief Returns wait-time and utilization counters of the backend's connection pool.
+     * @return The counters, or std::nullopt for backends without a connection pool.
+     */
+    [[nodiscard]] virtual std::optional<ConnectionPoolMetrics> getPoolMetrics() const {
+        return std::nullopt;
+    }
+
+protected:
+    /**
+     * @brief Implements executeQueryAsync by running executeQuery on a thread of `ioThreads`,
+     * for backends whose client library has no usable non-blocking API.
+     */
+    void executeQueryOn(ThreadPool& ioThreads, const std::string& query, const std::vector<std::string>& params,
+                        ExecuteCallback onDone) {
+        ioThreads.submit([this, query, params, onDone = std::move(onDone)] {
+            int affectedRows = -1;
+            try {
+                affectedRows = executeQuery(query, params);
+            } catch (const std::exception&) {
+                // Reported as a failed statement, like the synchronous call would for most errors
+            }
+            onDone(affectedRows);
+        });
+    }
+
+    /**
+     * @brief Implements fetchResultAsync by running fetchResult on a thread of `ioThreads`.
+     */
+    void fetchResultOn(ThreadPool& ioThreads, const std::string& query, const std::vector<std::string>& params,
+                       FetchCallback onDone) {
+        ioThreads.submit([this, query, params, onDone = std::move(onDone)] {
+            std::unique_ptr<ResultSet> result;
+            std::exception_ptr error;
+            try {
+                result = fetchResult(query, params);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            onDone(std::move(result), error);
+        });
+    }
+
+    /**
+     * @brief Validates the shape of an insertRows call.
+     * @throws std::invalid_argument if there are no columns or a row does not have one value per column.
+     */
+    static void checkRowWidths(const std::vector<std::string>& columns, const std::vector<std::vector<std::string>>& rows) {
+        if (columns.empty()) {
+            throw std::invalid_argument("insertRows needs at least one column");
+        }
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (rows[i].size() != columns.size()) {
+                throw std::invalid_argument("Row " + std::to_string(i) + " has " + std::to_string(rows[i].size()) +
+                                            " values for " + std::to_string(columns.size()) + " columns");
+            }
+        }
+    }
 };
\ No newline at end of file
@@ -1,12 +1,52 @@
 #pragma once
 
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "database/ResultSet.hpp"
+
 /**
  * @brief Interface for database transactions.
+ *
+ * A transaction pins one connection for its whole lifetime: every statement issued through it runs on
+ * that connection, so the statements see each other's writes and commit together. A transaction that is
+ * destroyed without commit() or rollback() is rolled back.
  */
 class ITransaction {
 public:
     virtual ~ITransaction() = default;
 
+    /**
+     * @brief Executes a non-select statement inside the transaction.
+     * @param query The SQL query with placeholders for parameters.
+     * @param params A vector of values to bind to the query's placeholders, in sequential order.
+     * @return Number of affected rows, or -1 if the statement failed.
+     * @throws std::logic_error if the transaction has already ended.
+     */
+    virtual int executeQuery(const std::string& query, const std::vector<std::string>& params) = 0;
+
+    /**
+     * @brief Executes a select query inside the transaction.
+     * @param query The SQL query with placeholders for parameters.
+     * @param params A vector of values to bind to the query's placeholders, in sequential order.
+     * @return The query result.
+     * @throws std::runtime_error if the query fails.
+     * @throws std::logic_error if the transaction has already ended.
+     */
+    virtual std::unique_ptr<ResultSet> fetchResult(const std::string& query, const std::vector<std::string>& params) = 0;
+
+    /**
+     * @brief Executes an INSERT inside the transaction and returns the generated ID.
+     * @param query The SQL query with placeholders for parameters.
+     * @param params A vector of values to bind to the query's placeholders, in sequential order.
+     * @return The generated row ID, or -1 if the insert failed.
+     * @throws std::logic_error if the transaction has already ended.
+     */
+    virtual int executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) = 0;
+
     /**
      * @brief Commits the current transaction.
      * @throws std::runtime_error if commit fails.
@@ -18,4 +58,45 @@ public:
      * @throws std::runtime_error if rollback fails.
      */
     virtual void rollback() = 0;
-};
\ No newline at end of file
+
+    /**
+     * @brief Marks a point the transaction can later be rolled back to without aborting it.
+     * @param name Savepoint name, an SQL identifier.
+     * @throws std::invalid_argument if the name is not a plain identifier.
+     * @throws std::runtime_error if the savepoint cannot be created.
+     */
+    void savepoint(const std::string& name) {
+        runSavepointCommand("SAVEPOINT ", name);
+    }
+
+    /**
+     * @brief Undoes everything done since the savepoint; the savepoint stays usable.
+     * @throws std::invalid_argument if the name is not a plain identifier.
+     * @throws std::runtime_error if the rollback fails.
+     */
+    void rollbackToSavepoint(const std::string& name) {
+        runSavepointCommand("ROLLBACK TO SAVEPOINT ", name);
+    }
+
+    /**
+     * @brief Forgets the savepoint, keeping the work done since it.
+     * @throws std::invalid_argument if the name is not a plain identifier.
+     * @throws std::runtime_error if the release fails.
+     */
+    void releaseSavepoint(const std::string& name) {
+        runSavepointCommand("RELEASE SAVEPOINT ", name);
+    }
+
+private:
+    // SAVEPOINT, ROLLBACK TO SAVEPOINT and RELEASE SAVEPOINT are spelled the same on every backend.
+    void runSavepointCommand(const char* command, const std::string& name) {
+        const bool identifier = !name.empty() && !std::isdigit(static_cast<unsigned char>(name[0])) &&
+            std::all_of(name.begin(), name.end(), [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; });
+        if (!identifier) {
+            throw std::invalid_argument("Invalid savepoint name: " + name);
+        }
+        if (executeQuery(command + name, {}) < 0) {
+            throw std::runtime_error(std::string(command) + name + " failed");
+        }
+    }
+};
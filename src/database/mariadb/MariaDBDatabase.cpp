@@ -1,16 +1,45 @@
 #include "MariaDBDatabase.hpp"
+#include "database/BufferedResultSet.hpp"
 #include "utils/Logger.hpp"
+#include <algorithm>
 #include <stdexcept>
 #include "MariaDBTransaction.hpp"
 
+namespace {
+    // Client error codes (errmsg.h) after which the connection cannot be reused.
+    constexpr unsigned int kServerGoneError = 2006;
+    constexpr unsigned int kServerLost = 2013;
+
+    // Rows per multi-row INSERT, and the most placeholders the protocol allows in one statement.
+    constexpr size_t kBulkInsertRows = 1000;
+    constexpr size_t kMaxBindParameters = 65535;
+
+    using StatementPtr = std::unique_ptr<MYSQL_STMT, decltype(&mysql_stmt_close)>;
+    using ResultPtr = std::unique_ptr<MYSQL_RES, decltype(&mysql_free_result)>;
+
+    void markBrokenIfLost(ConnectionPool<MYSQL>::Lease& connection) {
+        const unsigned int error = mysql_errno(connection.get());
+        if (error == kServerGoneError || error == kServerLost) {
+            connection.markBroken();
+        }
+    }
+}
+
 MariaDBDatabase::MariaDBDatabase(std::string host, std::string user, std::string password,
-                                 std::string database, unsigned int port, size_t poolSize)
+                                 std::string database, unsigned int port, const ConnectionPoolOptions& poolOptions)
     : m_host(std::move(host)), m_user(std::move(user)), m_password(std::move(password)),
-      m_database(std::move(database)), m_port(port), m_poolSize(poolSize), m_connected(false) {}
+      m_database(std::move(database)), m_port(port), m_connected(false) {
+    m_pool = std::make_unique<ConnectionPool<MYSQL>>(
+        "MariaDB", poolOptions,
+        [this] { return openConnection(); },
+        [](MYSQL* connection) { mysql_close(connection); },
+        [](MYSQL* connection) { return mysql_ping(connection) == 0; });
+}
 
 MariaDBDatabase::~MariaDBDatabase() {
     if (m_connected) {
-        cleanupPool();
+        m_ioThreads.reset();  // Let queued asynchronous calls finish first
+        m_pool->shutdown();
         m_connected = false;
         Logger::getInstance().info("MariaDB connection pool closed.");
     }
@@ -22,9 +51,11 @@ void MariaDBDatabase::connect() {
         return;
     }
     try {
-        initializePool();
+        m_pool->start();
+        m_ioThreads = std::make_unique<ThreadPool>(m_pool->options().maxSize);
         m_connected = true;
-        Logger::getInstance().info("MariaDB connection pool initialized with pool size: " + std::to_string(m_poolSize));
+        Logger::getInstance().info("MariaDB connection pool initialized with ", m_pool->options().minSize,
+                                   " to ", m_pool->options().maxSize, " connections");
     } catch (const std::runtime_error& e) {
         Logger::getInstance().error("Failed to initialize MariaDB connection pool: " + std::string(e.what()));
         throw;
@@ -33,7 +64,8 @@ void MariaDBDatabase::connect() {
 
 void MariaDBDatabase::disconnect() {
     if (m_connected) {
-        cleanupPool();
+        m_ioThreads.reset();  // Let queued asynchronous calls finish first
+        m_pool->shutdown();
         m_connected = false;
         Logger::getInstance().info("MariaDB connection pool closed.");
     }
@@ -49,25 +81,30 @@ int MariaDBDatabase::executeQuery(const std::string& query) {
 
 int MariaDBDatabase::executeQuery(const std::string& query, const std::vector<std::string>& params) {
     checkConnection();
-    auto connection = acquireConnection();
+    auto connection = m_pool->acquire();
+    return execute(connection, query, params);
+}
+
+int MariaDBDatabase::execute(ConnectionPool<MYSQL>::Lease& connection, const std::string& query,
+                             const std::vector<std::string>& params) {
     int rowsAffected = -1;
 
     if (params.empty()) {
-        if (mysql_query(connection, query.c_str()) == 0) {
-            rowsAffected = static_cast<int>(mysql_affected_rows(connection));
+        if (mysql_query(connection.get(), query.c_str()) == 0) {
+            rowsAffected = static_cast<int>(mysql_affected_rows(connection.get()));
             Logger::getInstance().info("Query executed successfully: " + query);
         } else {
-            Logger::getInstance().error("MariaDB query failed: " + std::string(mysql_error(connection)));
+            Logger::getInstance().error("MariaDB query failed: " + std::string(mysql_error(connection.get())));
+            markBrokenIfLost(connection);
         }
-        releaseConnection(connection);
         return rowsAffected;
     }
 
-    MYSQL_STMT* stmt = mysql_stmt_init(connection);
-    if (!stmt || mysql_stmt_prepare(stmt, query.c_str(), query.length()) != 0) {
-        Logger::getInstance().error("Failed to prepare MariaDB statement: " + std::string(mysql_stmt_error(stmt)));
-        releaseConnection(connection);
-        mysql_stmt_close(stmt);
+    StatementPtr stmt(mysql_stmt_init(connection.get()), &mysql_stmt_close);
+    if (!stmt || mysql_stmt_prepare(stmt.get(), query.c_str(), query.length()) != 0) {
+        Logger::getInstance().error("Failed to prepare MariaDB statement: ",
+                                    stmt ? mysql_stmt_error(stmt.get()) : mysql_error(connection.get()));
+        markBrokenIfLost(connection);
         return -1;
     }
 
@@ -78,15 +115,13 @@ int MariaDBDatabase::executeQuery(const std::string& query, const std::vector<st
         bind[i].buffer_length = params[i].length();
     }
 
-    if (mysql_stmt_bind_param(stmt, bind.data()) != 0 || mysql_stmt_execute(stmt) != 0) {
-        Logger::getInstance().error("Failed to execute query with parameters: " + std::string(mysql_stmt_error(stmt)));
+    if (mysql_stmt_bind_param(stmt.get(), bind.data()) != 0 || mysql_stmt_execute(stmt.get()) != 0) {
+        Logger::getInstance().error("Failed to execute query with parameters: " + std::string(mysql_stmt_error(stmt.get())));
+        markBrokenIfLost(connection);
     } else {
-        rowsAffected = static_cast<int>(mysql_stmt_affected_rows(stmt));
+        rowsAffected = static_cast<int>(mysql_stmt_affected_rows(stmt.get()));
         Logger::getInstance().info("Parameterized query executed successfully: " + query);
     }
-
-    mysql_stmt_close(stmt);
-    releaseConnection(connection);
     return rowsAffected;
 }
 
@@ -95,70 +130,240 @@ std::vector<std::vector<std::string>> MariaDBDatabase::fetchQuery(const std::str
 }
 
 std::vector<std::vector<std::string>> MariaDBDatabase::fetchQuery(const std::string& query, const std::vector<std::string>& params) {
-    checkConnection();
-    auto connection = acquireConnection();
-    std::vector<std::vector<std::string>> rows;
+    return fetchResult(query, params)->toRows();
+}
 
-    MYSQL_STMT* stmt = mysql_stmt_init(connection);
-    if (!stmt || mysql_stmt_prepare(stmt, query.c_str(), query.length()) != 0) {
-        releaseConnection(connection);
-        throw std::runtime_error("Failed to prepare MariaDB statement: " + std::string(mysql_stmt_error(stmt)));
+/**
+ * @brief Prepares, binds and executes a select statement, then reads its rows one at a time.
+ *
+ * Results are not stored client-side (no mysql_stmt_store_result), so rows stream from the server
+ * as they are fetched. The statement must be read or destroyed before the connection runs anything else.
+ */
+class MariaDBDatabase::StatementReader {
+public:
+    StatementReader(ConnectionPool<MYSQL>::Lease& connection, const std::string& query, const std::vector<std::string>& params)
+        : m_connection(connection), m_stmt(mysql_stmt_init(connection.get()), &mysql_stmt_close),
+          m_metaResult(nullptr, &mysql_free_result) {
+        if (!m_stmt || mysql_stmt_prepare(m_stmt.get(), query.c_str(), query.length()) != 0) {
+            markBrokenIfLost(connection);
+            throw std::runtime_error("Failed to prepare MariaDB statement: " +
+                                     std::string(m_stmt ? mysql_stmt_error(m_stmt.get()) : mysql_error(connection.get())));
+        }
+
+        std::vector<MYSQL_BIND> bind(params.size());
+        for (size_t i = 0; i < params.size(); ++i) {
+            bind[i].buffer_type = MYSQL_TYPE_STRING;
+            bind[i].buffer = const_cast<void*>(static_cast<const void*>(params[i].c_str()));
+            bind[i].buffer_length = params[i].length();
+        }
+
+        if (!params.empty() && mysql_stmt_bind_param(m_stmt.get(), bind.data()) != 0) {
+            throw std::runtime_error("Failed to bind parameters: " + std::string(mysql_stmt_error(m_stmt.get())));
+        }
+
+        if (mysql_stmt_execute(m_stmt.get()) != 0) {
+            markBrokenIfLost(connection);
+            throw std::runtime_error("Failed to execute query: " + std::string(mysql_stmt_error(m_stmt.get())));
+        }
+
+        m_metaResult.reset(mysql_stmt_result_metadata(m_stmt.get()));
+        if (!m_metaResult) {
+            throw std::runtime_error("Failed to retrieve metadata: " + std::string(mysql_stmt_error(m_stmt.get())));
+        }
+
+        // One buffer per column; cells longer than it are fetched again with mysql_stmt_fetch_column.
+        const unsigned int columnCount = mysql_num_fields(m_metaResult.get());
+        m_bind.resize(columnCount);
+        m_buffers.assign(columnCount, std::vector<char>(kInitialCellSize));
+        m_lengths.resize(columnCount);
+        m_nulls.resize(columnCount);
+        m_errors.resize(columnCount);
+        for (unsigned int i = 0; i < columnCount; ++i) {
+            m_bind[i].buffer_type = MYSQL_TYPE_STRING;
+            m_bind[i].buffer = m_buffers[i].data();
+            m_bind[i].buffer_length = m_buffers[i].size();
+            m_bind[i].length = &m_lengths[i];
+            m_bind[i].is_null = &m_nulls[i];
+            m_bind[i].error = &m_errors[i];
+        }
+
+        if (mysql_stmt_bind_result(m_stmt.get(), m_bind.data()) != 0) {
+            throw std::runtime_error("Failed to bind result: " + std::string(mysql_stmt_error(m_stmt.get())));
+        }
     }
 
-    std::vector<MYSQL_BIND> bind(params.size());
-    for (size_t i = 0; i < params.size(); ++i) {
-        bind[i].buffer_type = MYSQL_TYPE_STRING;
-        bind[i].buffer = const_cast<void*>(static_cast<const void*>(params[i].c_str()));
-        bind[i].buffer_length = params[i].length();
+    void addColumns(BufferedResultSet& result) const {
+        const MYSQL_FIELD* fields = mysql_fetch_fields(m_metaResult.get());
+        for (size_t i = 0; i < m_bind.size(); ++i) {
+            result.addColumn(fields[i].name ? fields[i].name : "");
+        }
+    }
+
+    /**
+     * @brief Fetches the next row into `result`.
+     * @return False once there are no more rows.
+     * @throws std::runtime_error if fetching fails.
+     */
+    bool fetchRow(BufferedResultSet& result) {
+        const int status = mysql_stmt_fetch(m_stmt.get());
+        if (status == MYSQL_NO_DATA) {
+            return false;
+        }
+        if (status != 0 && status != MYSQL_DATA_TRUNCATED) {
+            markBrokenIfLost(m_connection);
+            throw std::runtime_error("Failed to fetch rows: " + std::string(mysql_stmt_error(m_stmt.get())));
+        }
+
+        result.beginRow();
+        for (unsigned int i = 0; i < m_bind.size(); ++i) {
+            if (m_nulls[i]) {
+                result.appendNull();
+                continue;
+            }
+            if (m_lengths[i] > m_buffers[i].size()) {
+                m_buffers[i].resize(m_lengths[i]);
+                m_bind[i].buffer = m_buffers[i].data();
+                m_bind[i].buffer_length = m_buffers[i].size();
+                if (mysql_stmt_fetch_column(m_stmt.get(), &m_bind[i], i, 0) != 0) {
+                    throw std::runtime_error("Failed to fetch column: " + std::string(mysql_stmt_error(m_stmt.get())));
+                }
+            }
+            result.appendCell({m_buffers[i].data(), m_lengths[i]});
+        }
+        // Rebind so grown buffers are used directly for the following rows.
+        if (status == MYSQL_DATA_TRUNCATED) {
+            mysql_stmt_bind_result(m_stmt.get(), m_bind.data());
+        }
+        return true;
     }
 
-    if (!params.empty() && mysql_stmt_bind_param(stmt, bind.data()) != 0) {
-        mysql_stmt_close(stmt);
-        releaseConnection(connection);
-        throw std::runtime_error("Failed to bind parameters: " + std::string(mysql_stmt_error(stmt)));
+private:
+    static constexpr unsigned long kInitialCellSize = 256;
+
+    ConnectionPool<MYSQL>::Lease& m_connection;
+    StatementPtr m_stmt;
+    ResultPtr m_metaResult;
+    std::vector<MYSQL_BIND> m_bind;
+    std::vector<std::vector<char>> m_buffers;
+    std::vector<unsigned long> m_lengths;
+    std::vector<my_bool> m_nulls;
+    std::vector<my_bool> m_errors;
+};
+
+std::unique_ptr<ResultSet> MariaDBDatabase::fetchResult(const std::string& query, const std::vector<std::string>& params) {
+    checkConnection();
+    auto connection = m_pool->acquire();
+    return fetch(connection, query, params);
+}
+
+std::unique_ptr<ResultSet> MariaDBDatabase::fetch(ConnectionPool<MYSQL>::Lease& connection, const std::string& query,
+                                                  const std::vector<std::string>& params) {
+    StatementReader reader(connection, query, params);
+    auto result = std::make_unique<BufferedResultSet>();
+    reader.addColumns(*result);
+    while (reader.fetchRow(*result)) {
     }
+    return result;
+}
+
+std::vector<int> MariaDBDatabase::insertRows(const std::string& table, const std::vector<std::string>& columns,
+                                             const std::vector<std::vector<std::string>>& rows) {
+    checkRowWidths(columns, rows);
+    checkConnection();
 
-    if (mysql_stmt_execute(stmt) != 0) {
-        mysql_stmt_close(stmt);
-        releaseConnection(connection);
-        throw std::runtime_error("Failed to execute query: " + std::string(mysql_stmt_error(stmt)));
+    std::vector<int> ids;
+    ids.reserve(rows.size());
+    if (rows.empty()) {
+        return ids;
     }
 
-    MYSQL_RES* metaResult = mysql_stmt_result_metadata(stmt);
-    if (!metaResult) {
-        mysql_stmt_close(stmt);
-        releaseConnection(connection);
-        throw std::runtime_error("Failed to retrieve metadata: " + std::string(mysql_stmt_error(stmt)));
+    std::string prefix = "INSERT INTO " + table + " (";
+    std::string placeholders = "(";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        prefix += (i ? ", " : "") + columns[i];
+        placeholders += i ? ", ?" : "?";
     }
+    prefix += ") VALUES ";
+    placeholders += ")";
 
-    std::vector<MYSQL_BIND> resultBind(mysql_num_fields(metaResult));
-    std::vector<char> buffer(1024);
-    for (auto& b : resultBind) {
-        b.buffer_type = MYSQL_TYPE_STRING;
-        b.buffer = buffer.data();
-        b.buffer_length = buffer.size();
+    const size_t rowsPerStatement = std::max<size_t>(1, std::min(kBulkInsertRows, kMaxBindParameters / columns.size()));
+    const bool multiStatement = rows.size() > rowsPerStatement;
+
+    auto connection = m_pool->acquire();
+    if (multiStatement && execute(connection, "START TRANSACTION", {}) < 0) {
+        throw std::runtime_error("Failed to begin MariaDB bulk insert: " + std::string(mysql_error(connection.get())));
     }
 
-    mysql_stmt_bind_result(stmt, resultBind.data());
-    while (mysql_stmt_fetch(stmt) == 0) {
-        std::vector<std::string> row;
-        row.reserve(resultBind.size());
-        for (auto& b : resultBind) {
-            row.emplace_back(static_cast<char*>(b.buffer));
+    try {
+        std::string query;
+        std::vector<std::string> values;
+        for (size_t first = 0; first < rows.size(); first += rowsPerStatement) {
+            const size_t count = std::min(rowsPerStatement, rows.size() - first);
+
+            // Only the last statement can be shorter, so the SQL text is built at most twice.
+            if (values.size() != count * columns.size()) {
+                query = prefix;
+                for (size_t r = 0; r < count; ++r) {
+                    query += r ? ", " + placeholders : placeholders;
+                }
+                query += " RETURNING id";
+            }
+
+            values.clear();
+            for (size_t r = first; r < first + count; ++r) {
+                values.insert(values.end(), rows[r].begin(), rows[r].end());
+            }
+
+            StatementReader reader(connection, query, values);
+            BufferedResultSet returned;
+            reader.addColumns(returned);
+            while (reader.fetchRow(returned)) {
+            }
+            if (returned.rowCount() != count) {
+                throw std::runtime_error("MariaDB bulk insert into " + table + " returned " +
+                                         std::to_string(returned.rowCount()) + " IDs for " + std::to_string(count) + " rows");
+            }
+
+            // Auto-increment values within one statement grow in insertion order.
+            const size_t offset = ids.size();
+            for (const auto row : returned) {
+                ids.push_back(static_cast<int>(row.getInt64(0)));
+            }
+            std::sort(ids.begin() + static_cast<std::ptrdiff_t>(offset), ids.end());
         }
-        rows.push_back(row);
+    } catch (const std::exception&) {
+        if (multiStatement && !connection.isBroken()) {
+            execute(connection, "ROLLBACK", {});
+        }
+        throw;
     }
 
-    mysql_free_result(metaResult);
-    mysql_stmt_close(stmt);
-    releaseConnection(connection);
-    return rows;
+    if (multiStatement && execute(connection, "COMMIT", {}) < 0) {
+        throw std::runtime_error("Failed to commit MariaDB bulk insert: " + std::string(mysql_error(connection.get())));
+    }
+    Logger::getInstance().info("Inserted ", rows.size(), " rows into ", table);
+    return ids;
+}
+
+void MariaDBDatabase::executeQueryAsync(const std::string& query, const std::vector<std::string>& params,
+                                        ExecuteCallback onDone) {
+    checkConnection();
+    executeQueryOn(*m_ioThreads, query, params, std::move(onDone));
+}
+
+void MariaDBDatabase::fetchResultAsync(const std::string& query, const std::vector<std::string>& params,
+                                       FetchCallback onDone) {
+    checkConnection();
+    fetchResultOn(*m_ioThreads, query, params, std::move(onDone));
 }
 
 std::shared_ptr<ITransaction> MariaDBDatabase::beginTransaction() {
     checkConnection();
-    auto connection = acquireConnection();
-    return std::make_shared<MariaDBTransaction>(connection);
+    return std::make_shared<MariaDBTransaction>(*this, m_pool->acquire());
+}
+
+std::optional<ConnectionPoolMetrics> MariaDBDatabase::getPoolMetrics() const {
+    return m_pool->metrics();
 }
 
 void MariaDBDatabase::checkConnection() const {
@@ -167,42 +372,19 @@ void MariaDBDatabase::checkConnection() const {
     }
 }
 
-void MariaDBDatabase::initializePool() {
-    std::lock_guard lock(m_poolMutex);
-    for (size_t i = 0; i < m_poolSize; ++i) {
-        MYSQL* connection = mysql_init(nullptr);
-        if (!connection || !mysql_real_connect(connection, m_host.c_str(), m_user.c_str(), m_password.c_str(),
-                                               m_database.c_str(), m_port, nullptr, 0)) {
-            throw std::runtime_error("Failed to initialize a MariaDB connection.");
+MYSQL* MariaDBDatabase::openConnection() const {
+    MYSQL* connection = mysql_init(nullptr);
+    if (!connection || !mysql_real_connect(connection, m_host.c_str(), m_user.c_str(), m_password.c_str(),
+                                           m_database.c_str(), m_port, nullptr, 0)) {
+        const std::string error = connection ? mysql_error(connection) : "out of memory";
+        if (connection) {
+            mysql_close(connection);
         }
-        m_connectionPool.push(connection);
+        throw std::runtime_error("Failed to initialize a MariaDB connection: " + error);
     }
-}
-
-MYSQL* MariaDBDatabase::acquireConnection() {
-    std::unique_lock lock(m_poolMutex);
-    m_condition.wait(lock, [this] { return !m_connectionPool.empty(); });
-
-    MYSQL* connection = m_connectionPool.front();
-    m_connectionPool.pop();
     return connection;
 }
 
-void MariaDBDatabase::releaseConnection(MYSQL* connection) {
-    std::lock_guard lock(m_poolMutex);
-    m_connectionPool.push(connection);
-    m_condition.notify_one();
-}
-
-void MariaDBDatabase::cleanupPool() {
-    std::lock_guard lock(m_poolMutex);
-    while (!m_connectionPool.empty()) {
-        MYSQL* connection = m_connectionPool.front();
-        m_connectionPool.pop();
-        mysql_close(connection);
-    }
-}
-
 /**
  * @brief Retrieves the last inserted row ID for the MariaDB database.
  *
@@ -210,12 +392,10 @@ void MariaDBDatabase::cleanupPool() {
  * @throws std::runtime_error if the database is not connected.
  */
 int MariaDBDatabase::getLastInsertId() {
-    std::lock_guard lock(m_poolMutex);
     checkConnection();
 
-    MYSQL* connection = acquireConnection();
-    my_ulonglong lastInsertId = mysql_insert_id(connection);
-    releaseConnection(connection);
+    auto connection = m_pool->acquire();
+    my_ulonglong lastInsertId = mysql_insert_id(connection.get());
 
     if (lastInsertId == 0) {
         throw std::runtime_error("Failed to retrieve last insert ID.");
@@ -224,12 +404,16 @@ int MariaDBDatabase::getLastInsertId() {
 }
 
 int MariaDBDatabase::executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) {
-    // Use parameterized execution logic here
-    if (executeQuery(query, params)) {
-        auto connection = acquireConnection();
-        int lastInsertId = static_cast<int>(mysql_insert_id(connection));
-        releaseConnection(connection);
-        return lastInsertId;
+    checkConnection();
+    // The insert id is per connection, so read it on the connection that ran the insert.
+    auto connection = m_pool->acquire();
+    return insert(connection, query, params);
+}
+
+int MariaDBDatabase::insert(ConnectionPool<MYSQL>::Lease& connection, const std::string& query,
+                            const std::vector<std::string>& params) {
+    if (execute(connection, query, params) > 0) {
+        return static_cast<int>(mysql_insert_id(connection.get()));
     }
     return -1;
 }
\ No newline at end of file
@@ -2,11 +2,12 @@
 
 #include "database/interfaces/IDatabase.hpp"
 #include "database/interfaces/ITransaction.hpp"
+#include "database/ConnectionPool.hpp"
+#include "utils/ThreadPool.hpp"
 #include <mariadb/mysql.h>
+#include <memory>
 #include <string>
 #include <vector>
-#include <queue>
-#include <condition_variable>
 
 /**
  * @class MariaDBDatabase
@@ -24,10 +25,10 @@ public:
      * @param password Database password.
      * @param database Database name.
      * @param port Database port number.
-     * @param poolSize Number of connections to maintain in the connection pool.
+     * @param poolOptions Sizing, timeouts and health check policy of the connection pool.
      */
     MariaDBDatabase(std::string host, std::string user, std::string password,
-                    std::string database, unsigned int port, size_t poolSize);
+                    std::string database, unsigned int port, const ConnectionPoolOptions& poolOptions);
 
     /**
      * @brief Destructor. Closes all connections in the pool.
@@ -51,6 +52,8 @@ public:
      */
     [[nodiscard]] bool isConnected() const override;
 
+    [[nodiscard]] SqlDialect dialect() const override { return SqlDialect::MariaDB; }
+
     /**
      * @brief Executes a non-select SQL query on the database.
      *
@@ -86,53 +89,101 @@ public:
     std::vector<std::vector<std::string>> fetchQuery(const std::string& query, const std::vector<std::string>& params) override;
 
     /**
-     * @brief Begins a new transaction on the database.
+     * @brief Executes a parameterized select query and packs the rows into a single buffer.
+     *
+     * @param query The SQL query string with placeholders.
+     * @param params A vector of values to bind to the query's placeholders, in sequential order.
+     * @return The query result.
+     * @throws std::runtime_error if the query fails.
+     */
+    std::unique_ptr<ResultSet> fetchResult(const std::string& query, const std::vector<std::string>& params) override;
+
+    /**
+     * @brief Inserts the rows with multi-row `INSERT ... VALUES ... RETURNING id` statements on one connection.
+     *
+     * Each statement carries up to 1000 rows (fewer for wide rows, to stay within 65535 placeholders);
+     * when more than one is needed they share a single transaction. RETURNING needs MariaDB 10.5 or later.
+     *
+     * @return Generated ID of each row, in the order of `rows`.
+     * @throws std::invalid_argument if a row does not have one value per column.
+     * @throws std::runtime_error if the insert fails; no row is inserted then.
+     */
+    std::vector<int> insertRows(const std::string& table, const std::vector<std::string>& columns,
+                                const std::vector<std::vector<std::string>>& rows) override;
+
+    /**
+     * @brief Runs the statement on one of the I/O threads, which are as many as the pool's connections.
+     *
+     * Connector/C does have non-blocking prepared-statement calls (mysql_stmt_prepare_start,
+     * mysql_stmt_execute_start, mysql_stmt_fetch_start and their _cont forms), but driving them needs
+     * connections opened with MYSQL_OPT_NONBLOCK and an event loop stepping every prepare, execute,
+     * store and fetch of a statement. The blocking statement path and its cursors are shared with the
+     * synchronous calls, so the asynchronous calls run it on threads of their own instead.
+     */
+    void executeQueryAsync(const std::string& query, const std::vector<std::string>& params,
+                           ExecuteCallback onDone) override;
+    void fetchResultAsync(const std::string& query, const std::vector<std::string>& params,
+                          FetchCallback onDone) override;
+    using IDatabase::executeQueryAsync;
+    using IDatabase::fetchResultAsync;
+
+    /**
+     * @brief Begins a transaction pinned to one pooled connection until it commits or rolls back.
      * @return A shared pointer to an ITransaction representing the transaction.
      * @throws std::runtime_error if the transaction cannot be started.
      */
     std::shared_ptr<ITransaction> beginTransaction() override;
 
+    /**
+     * @brief Returns wait-time and utilization counters of the connection pool.
+     */
+    [[nodiscard]] std::optional<ConnectionPoolMetrics> getPoolMetrics() const override;
+
 private:
+    friend class MariaDBTransaction;
+
     std::string m_host;               ///< Database host address.
     std::string m_user;               ///< Database username.
     std::string m_password;           ///< Database password.
     std::string m_database;           ///< Database name.
     unsigned int m_port;              ///< Database port.
-    size_t m_poolSize;                ///< Number of connections in the pool.
     bool m_connected;                 ///< Connection status flag.
 
-    std::queue<MYSQL*> m_connectionPool; ///< Pool of MariaDB connections.
-    std::mutex m_poolMutex;             ///< Mutex for thread-safe access to the connection pool.
-    std::condition_variable m_condition; ///< Condition variable for managing connection availability.
+    std::unique_ptr<ConnectionPool<MYSQL>> m_pool; ///< Pool of MariaDB connections.
+    std::unique_ptr<ThreadPool> m_ioThreads;       ///< Runs the asynchronous calls; exists while connected.
+
+    class StatementReader;
 
     /**
-     * @brief Initializes the pool with `m_poolSize` connections.
-     * @throws std::runtime_error if any connection cannot be established.
+     * @brief Opens a single connection for the pool.
+     * @throws std::runtime_error if the connection cannot be established.
      */
-    void initializePool();
+    MYSQL* openConnection() const;
 
     /**
-     * @brief Acquires a connection from the pool.
-     * @return A pointer to an available MYSQL connection.
+     * @brief Runs a statement on a leased connection, marking the lease broken if the server went away.
+     * @return Number of affected rows; -1 if an error occurs.
      */
-    MYSQL* acquireConnection();
+    int execute(ConnectionPool<MYSQL>::Lease& connection, const std::string& query, const std::vector<std::string>& params);
 
     /**
-     * @brief Releases a connection back into the pool.
-     * @param connection A pointer to the MYSQL connection to be returned.
+     * @brief Runs a select on a leased connection and reads the whole result.
+     * @throws std::runtime_error if the query fails.
      */
-    void releaseConnection(MYSQL* connection);
+    std::unique_ptr<ResultSet> fetch(ConnectionPool<MYSQL>::Lease& connection, const std::string& query,
+                                     const std::vector<std::string>& params);
 
     /**
-     * @brief Ensures the database is connected before executing queries.
-     * @throws std::runtime_error if the database is not connected.
+     * @brief Runs an insert on a leased connection and reads the generated ID from that connection.
+     * @return The generated ID, or -1 if the insert failed.
      */
-    void checkConnection() const;
+    int insert(ConnectionPool<MYSQL>::Lease& connection, const std::string& query, const std::vector<std::string>& params);
 
     /**
-     * @brief Cleans up all connections in the connection pool, closing each one.
+     * @brief Ensures the database is connected before executing queries.
+     * @throws std::runtime_error if the database is not connected.
      */
-    void cleanupPool();
+    void checkConnection() const;
 
    /**
     * @brief Retrieves the last inserted row ID for the database.
@@ -1,25 +1,86 @@
 #pragma once
 #include "database/interfaces/ITransaction.hpp"
+#include "database/ConnectionPool.hpp"
+#include "database/mariadb/MariaDBDatabase.hpp"
+#include "utils/Logger.hpp"
 #include <mariadb/mysql.h>
 
+/**
+ * @class MariaDBTransaction
+ * @brief Transaction pinned to one leased MariaDB connection.
+ *
+ * Every statement runs on the leased connection, which goes back to the pool as soon as the
+ * transaction commits or rolls back.
+ */
 class MariaDBTransaction final : public ITransaction {
-    MYSQL* m_connection;
+    MariaDBDatabase& m_database;                ///< Runs the statements; must outlive the transaction.
+    ConnectionPool<MYSQL>::Lease m_connection;  ///< Pinned connection; empty once the transaction has ended.
 
 public:
-    explicit MariaDBTransaction(MYSQL* connection) : m_connection(connection) {
-        mysql_query(m_connection, "START TRANSACTION");
+    /**
+     * @brief Begins the transaction on the leased connection.
+     * @throws std::runtime_error if START TRANSACTION fails.
+     */
+    MariaDBTransaction(MariaDBDatabase& database, ConnectionPool<MYSQL>::Lease connection)
+        : m_database(database), m_connection(std::move(connection)) {
+        if (m_database.execute(m_connection, "START TRANSACTION", {}) < 0) {
+            throw std::runtime_error("Failed to begin MariaDB transaction: " + std::string(mysql_error(m_connection.get())));
+        }
+    }
+
+    int executeQuery(const std::string& query, const std::vector<std::string>& params) override {
+        checkActive();
+        return m_database.execute(m_connection, query, params);
+    }
+
+    std::unique_ptr<ResultSet> fetchResult(const std::string& query, const std::vector<std::string>& params) override {
+        checkActive();
+        return m_database.fetch(m_connection, query, params);
+    }
+
+    int executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) override {
+        checkActive();
+        return m_database.insert(m_connection, query, params);
     }
 
     void commit() override {
-        mysql_query(m_connection, "COMMIT");
+        end("COMMIT");
     }
 
     void rollback() override {
-        mysql_query(m_connection, "ROLLBACK");
+        end("ROLLBACK");
     }
 
     ~MariaDBTransaction() override {
-        // Ensure transaction is ended properly
-        rollback();
+        // Ensure transaction is ended properly before the connection goes back to the pool
+        if (m_connection) {
+            try {
+                rollback();
+            } catch (const std::exception& e) {
+                Logger::getInstance().error("MariaDB transaction rollback failed: " + std::string(e.what()));
+            }
+        }
+    }
+
+private:
+    void checkActive() const {
+        if (!m_connection) {
+            throw std::logic_error("MariaDB transaction has already ended");
+        }
+    }
+
+    // A connection whose COMMIT or ROLLBACK failed is in an unknown state, so it is discarded.
+    void end(const char* command) {
+        checkActive();
+        std::string error;
+        const bool success = m_database.execute(m_connection, command, {}) >= 0;
+        if (!success) {
+            error = mysql_error(m_connection.get());
+            m_connection.markBroken();
+        }
+        m_connection.reset();
+        if (!success) {
+            throw std::runtime_error(std::string(command) + " failed: " + error);
+        }
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,274 @@
+#include "PostgreSQLAsyncExecutor.hpp"
+#include "utils/Logger.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+    constexpr int kMaxEvents = 64;
+
+    const std::string kStopped = "PostgreSQL async executor stopped";
+
+    // complete() treats an empty message as success, so never pass it libpq's empty one
+    std::string errorOf(const PGconn* conn) {
+        const char* message = PQerrorMessage(conn);
+        return *message ? message : "PostgreSQL connection failed";
+    }
+}
+
+PostgreSQLAsyncExecutor::PostgreSQLAsyncExecutor(ConnectionPool<PGconn>& pool) : m_pool(pool) {
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = m_wake;
+    if (m_epoll < 0 || m_wake < 0 || epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &event) != 0) {
+        const std::string error = std::strerror(errno);
+        if (m_wake >= 0) close(m_wake);
+        if (m_epoll >= 0) close(m_epoll);
+        throw std::runtime_error("Failed to create PostgreSQL event loop: " + error);
+    }
+    m_thread = std::thread(&PostgreSQLAsyncExecutor::run, this);
+    try {
+        m_acquirer = std::thread(&PostgreSQLAsyncExecutor::acquireConnections, this);
+    } catch (...) {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = m_loopStopping = true;
+        }
+        wake();
+        m_thread.join();
+        close(m_wake);
+        close(m_epoll);
+        throw;
+    }
+}
+
+PostgreSQLAsyncExecutor::~PostgreSQLAsyncExecutor() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_submittedCondition.notify_all();
+    if (m_acquirer.joinable()) {
+        m_acquirer.join();
+    }
+    // Only now can nothing be added to m_ready behind the loop's back
+    {
+        std::lock_guard lock(m_mutex);
+        m_loopStopping = true;
+    }
+    wake();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    for (auto& ready : m_ready) {
+        ready.connection.reset();
+        notify(ready.request.onDone, ResultPtr(nullptr, &PQclear), kStopped);
+    }
+    m_ready.clear();
+    for (const auto& request : m_submitted) {
+        notify(request.onDone, ResultPtr(nullptr, &PQclear), kStopped);
+    }
+    m_submitted.clear();
+    close(m_wake);
+    close(m_epoll);
+}
+
+void PostgreSQLAsyncExecutor::submit(std::string query, std::vector<std::string> params, Completion onDone) {
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_stopping) {
+            throw std::runtime_error(kStopped);
+        }
+        m_submitted.push_back({std::move(query), std::move(params), std::move(onDone)});
+    }
+    m_submittedCondition.notify_one();
+}
+
+void PostgreSQLAsyncExecutor::run() {
+    std::array<epoll_event, kMaxEvents> events{};
+    while (true) {
+        const int ready = epoll_wait(m_epoll, events.data(), kMaxEvents, -1);
+        if (ready < 0 && errno != EINTR) {
+            Logger::getInstance().error("PostgreSQL event loop failed: " + std::string(std::strerror(errno)));
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            if (events[i].data.fd == m_wake) {
+                uint64_t count;
+                (void) read(m_wake, &count, sizeof(count));
+            } else {
+                onReady(events[i].data.fd, events[i].events);
+            }
+        }
+
+        std::deque<Ready> sendable;
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_loopStopping) {
+                break;
+            }
+            sendable.swap(m_ready);
+        }
+        dispatch(std::move(sendable));
+    }
+
+    // A connection with a statement still running cannot go back to the pool; complete() discards it.
+    while (!m_inFlight.empty()) {
+        complete(m_inFlight.begin()->first, kStopped);
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;  // Also set when the loop itself failed, so submit() stops queueing
+    }
+    m_submittedCondition.notify_all();
+}
+
+void PostgreSQLAsyncExecutor::acquireConnections() {
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_submittedCondition.wait(lock, [this] { return m_stopping || !m_submitted.empty(); });
+        if (m_stopping) {
+            return;
+        }
+        Ready ready{std::move(m_submitted.front()), {}, {}};
+        m_submitted.pop_front();
+        lock.unlock();
+
+        try {
+            ready.connection = m_pool.acquire();
+        } catch (const std::exception& e) {
+            // The pool is shut down, exhausted past its acquire timeout, or the server is unreachable
+            ready.error = e.what();
+        }
+
+        lock.lock();
+        m_ready.push_back(std::move(ready));
+        wake();
+    }
+}
+
+void PostgreSQLAsyncExecutor::dispatch(std::deque<Ready> ready) {
+    for (auto& item : ready) {
+        if (!item.connection) {
+            notify(item.request.onDone, ResultPtr(nullptr, &PQclear),
+                   item.error.empty() ? "No PostgreSQL connection available" : item.error);
+            continue;
+        }
+        send(std::move(item.request), std::move(item.connection));
+    }
+}
+
+void PostgreSQLAsyncExecutor::wake() {
+    const uint64_t one = 1;
+    (void) write(m_wake, &one, sizeof(one));
+}
+
+void PostgreSQLAsyncExecutor::send(Request request, ConnectionPool<PGconn>::Lease connection) {
+    PGconn* conn = connection.get();
+    std::vector<const char*> values;
+    values.reserve(request.params.size());
+    for (const auto& param : request.params) {
+        values.push_back(param.c_str());
+    }
+
+    if (PQsetnonblocking(conn, 1) != 0 ||
+        PQsendQueryParams(conn, request.query.c_str(), static_cast<int>(values.size()), nullptr, values.data(),
+                          nullptr, nullptr, 0) != 1) {
+        const std::string error = errorOf(conn);
+        connection.markBroken();
+        connection.reset();
+        notify(request.onDone, ResultPtr(nullptr, &PQclear), error);
+        return;
+    }
+
+    const int socket = PQsocket(conn);
+    auto& statement = m_inFlight.emplace(socket, InFlight{std::move(request), std::move(connection)}).first->second;
+
+    const int flushed = PQflush(conn);
+    statement.flushing = flushed == 1;
+    epoll_event event{};
+    event.events = statement.flushing ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    event.data.fd = socket;
+    if (flushed < 0 || epoll_ctl(m_epoll, EPOLL_CTL_ADD, socket, &event) != 0) {
+        complete(socket, flushed < 0 ? errorOf(conn) : std::string(std::strerror(errno)));
+    }
+}
+
+void PostgreSQLAsyncExecutor::onReady(const int socket, const uint32_t events) {
+    const auto it = m_inFlight.find(socket);
+    if (it == m_inFlight.end()) {
+        return;
+    }
+    InFlight& statement = it->second;
+    PGconn* conn = statement.connection.get();
+
+    if (statement.flushing) {
+        const int flushed = PQflush(conn);
+        if (flushed < 0) {
+            complete(socket, errorOf(conn));
+            return;
+        }
+        if (flushed == 0) {
+            statement.flushing = false;
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = socket;
+            epoll_ctl(m_epoll, EPOLL_CTL_MOD, socket, &event);
+        }
+    }
+
+    if ((events & (EPOLLIN | EPOLLERR | EPOLLHUP)) == 0) {
+        return;
+    }
+    if (PQconsumeInput(conn) != 1) {
+        complete(socket, errorOf(conn));
+        return;
+    }
+    while (!PQisBusy(conn)) {
+        PGresult* result = PQgetResult(conn);
+        if (!result) {
+            complete(socket, {});
+            return;
+        }
+        if (statement.result && PQresultStatus(statement.result.get()) == PGRES_FATAL_ERROR) {
+            PQclear(result);
+        } else {
+            statement.result.reset(result);
+        }
+    }
+}
+
+void PostgreSQLAsyncExecutor::complete(const int socket, const std::string& error) {
+    auto node = m_inFlight.extract(socket);
+    InFlight& statement = node.mapped();
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, socket, nullptr);
+
+    PGconn* conn = statement.connection.get();
+    if (!error.empty() || PQsetnonblocking(conn, 0) != 0 || PQstatus(conn) != CONNECTION_OK) {
+        statement.connection.markBroken();
+    }
+    // Give the connection back before the callback runs, so the next statement can use it
+    statement.connection.reset();
+
+    if (error.empty() && !statement.result) {
+        notify(statement.request.onDone, ResultPtr(nullptr, &PQclear), "PostgreSQL returned no result");
+    } else {
+        notify(statement.request.onDone, error.empty() ? std::move(statement.result) : ResultPtr(nullptr, &PQclear), error);
+    }
+}
+
+void PostgreSQLAsyncExecutor::notify(const Completion& onDone, ResultPtr result, const std::string& error) {
+    try {
+        onDone(std::move(result), error);
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("PostgreSQL async completion threw: " + std::string(e.what()));
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "database/ConnectionPool.hpp"
+#include <libpq-fe.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class PostgreSQLAsyncExecutor
+ * @brief Event loop running statements through libpq's non-blocking API.
+ *
+ * Each statement is sent with PQsendQueryParams on a pooled connection switched to non-blocking mode.
+ * A single thread then waits on the sockets of every statement in flight with epoll and reads results
+ * as they arrive, so any number of statements can be outstanding without a thread per statement.
+ * One statement runs per connection at a time.
+ *
+ * Borrowing a connection can block: the pool may open a new one or run its health check on an idle
+ * one, and waits while every connection is in use. A second thread therefore does all borrowing, in
+ * submission order, and hands each statement to the loop together with its connection, so the loop
+ * itself never blocks. A statement that gets no connection within the pool's acquire timeout
+ * completes with the pool's error.
+ */
+class PostgreSQLAsyncExecutor {
+public:
+    using ResultPtr = std::unique_ptr<PGresult, decltype(&PQclear)>;
+
+    /**
+     * @brief Receives the statement's result, or null and an error message if the connection failed.
+     *
+     * A statement the server rejected still yields a result, in PGRES_FATAL_ERROR state. Runs on the
+     * event loop thread, so it must not block.
+     */
+    using Completion = std::function<void(ResultPtr result, const std::string& error)>;
+
+    /**
+     * @brief Starts the event loop and connection threads.
+     * @param pool Pool the connections are borrowed from; must outlive the executor.
+     * @throws std::runtime_error if the epoll instance cannot be created.
+     */
+    explicit PostgreSQLAsyncExecutor(ConnectionPool<PGconn>& pool);
+
+    /**
+     * @brief Stops both threads. Statements still queued or in flight complete with an error, and the
+     * connections of in-flight statements are closed rather than returned to the pool. Waits for a
+     * connection being borrowed, at most the pool's acquire timeout.
+     */
+    ~PostgreSQLAsyncExecutor();
+
+    PostgreSQLAsyncExecutor(const PostgreSQLAsyncExecutor&) = delete;
+    PostgreSQLAsyncExecutor& operator=(const PostgreSQLAsyncExecutor&) = delete;
+
+    /**
+     * @brief Queues a statement; `onDone` is called on the loop thread once it completes.
+     */
+    void submit(std::string query, std::vector<std::string> params, Completion onDone);
+
+private:
+    struct Request {
+        std::string query;
+        std::vector<std::string> params;
+        Completion onDone;
+    };
+
+    /**
+     * @brief A statement and the connection borrowed for it, or the error that prevented borrowing one.
+     */
+    struct Ready {
+        Request request;
+        ConnectionPool<PGconn>::Lease connection;
+        std::string error;
+    };
+
+    /**
+     * @brief A statement that has been sent and whose result is being read.
+     */
+    struct InFlight {
+        Request request;
+        ConnectionPool<PGconn>::Lease connection;
+        ResultPtr result{nullptr, &PQclear};  ///< Result kept so far: the first error, else the last result.
+        bool flushing = false;                ///< Whether libpq still has query data to send.
+    };
+
+    void run();
+
+    /**
+     * @brief Connection thread: borrows a connection for each submitted statement and passes both to the loop.
+     */
+    void acquireConnections();
+
+    /**
+     * @brief Sends the statements whose connection has been borrowed. Loop thread only.
+     */
+    void dispatch(std::deque<Ready> ready);
+
+    void wake();
+
+    void send(Request request, ConnectionPool<PGconn>::Lease connection);
+
+    /**
+     * @brief Flushes pending output and reads available input of the statement on `socket`.
+     */
+    void onReady(int socket, uint32_t events);
+
+    /**
+     * @brief Unregisters the statement, returns its connection and calls its completion.
+     * @param error Empty on success; otherwise the connection is discarded.
+     */
+    void complete(int socket, const std::string& error);
+
+    static void notify(const Completion& onDone, ResultPtr result, const std::string& error);
+
+    ConnectionPool<PGconn>& m_pool;
+    int m_epoll = -1;    ///< epoll instance watching m_wake and the sockets in m_inFlight.
+    int m_wake = -1;     ///< eventfd signalled by submit() and the destructor.
+
+    std::mutex m_mutex;                          ///< Guards the queues and flags below.
+    std::condition_variable m_submittedCondition;  ///< Wakes the connection thread.
+    std::deque<Request> m_submitted;             ///< Statements handed over by submit(), waiting for a connection.
+    std::deque<Ready> m_ready;                   ///< Statements with a connection, not yet seen by the loop.
+    bool m_stopping = false;                     ///< Set first on shutdown: submit() refuses, the connection thread ends.
+    bool m_loopStopping = false;                 ///< Set once the connection thread has ended: the loop ends.
+
+    std::unordered_map<int, InFlight> m_inFlight;  ///< Statements in flight, by socket. Loop thread only.
+    std::thread m_thread;                        ///< Event loop.
+    std::thread m_acquirer;                      ///< Connection thread.
+};
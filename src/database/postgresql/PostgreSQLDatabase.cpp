@@ -1,13 +1,47 @@
 #include "PostgreSQLDatabase.hpp"
+#include "PostgreSQLResultSet.hpp"
+#include "PostgreSQLTransaction.hpp"
 #include "utils/Logger.hpp"
+#include <algorithm>
 #include <stdexcept>
 
-PostgreSQLDatabase::PostgreSQLDatabase(std::string conninfo, const size_t poolSize)
-    : m_conninfo(std::move(conninfo)), m_poolSize(poolSize), m_connected(false) {}
+namespace {
+    // Statements sent before reading results back. Bounding the window keeps the server's
+    // replies from filling the socket while libpq is still blocked sending queries.
+    constexpr size_t kPipelineWindow = 256;
+
+    // Rows per multi-row INSERT, and the most bind parameters the protocol allows in one statement.
+    constexpr size_t kBulkInsertRows = 1000;
+    constexpr size_t kMaxBindParameters = 65535;
+
+    int affectedRowsOf(const PGresult* result) {
+        switch (PQresultStatus(result)) {
+            case PGRES_COMMAND_OK: {
+                const char* tuples = PQcmdTuples(const_cast<PGresult*>(result));
+                return *tuples ? std::stoi(tuples) : 0;
+            }
+            case PGRES_TUPLES_OK:
+                return PQntuples(result);
+            default:
+                return -1;
+        }
+    }
+}
+
+PostgreSQLDatabase::PostgreSQLDatabase(std::string conninfo, const ConnectionPoolOptions& poolOptions)
+    : m_conninfo(std::move(conninfo)), m_connected(false) {
+    m_pool = std::make_unique<ConnectionPool<PGconn>>(
+        "PostgreSQL", poolOptions,
+        [this] { return openConnection(); },
+        [](PGconn* conn) { PQfinish(conn); },
+        // PQstatus only reflects what libpq has already noticed, so it costs no round trip.
+        [](PGconn* conn) { return PQstatus(conn) == CONNECTION_OK; });
+}
 
 PostgreSQLDatabase::~PostgreSQLDatabase() {
     if (m_connected) {
-        cleanupPool();
+        m_async.reset();  // Fails the statements still queued and closes the connections they hold
+        m_pool->shutdown();
         m_connected = false;
         Logger::getInstance().info("PostgreSQL connection pool closed.");
     }
@@ -20,9 +54,11 @@ void PostgreSQLDatabase::connect() {
     }
 
     try {
-        initializePool();
+        m_pool->start();
+        m_async = std::make_unique<PostgreSQLAsyncExecutor>(*m_pool);
         m_connected = true;
-        Logger::getInstance().info("PostgreSQL connection pool initialized with pool size: " + std::to_string(m_poolSize));
+        Logger::getInstance().info("PostgreSQL connection pool initialized with ", m_pool->options().minSize,
+                                   " to ", m_pool->options().maxSize, " connections");
     } catch (const std::runtime_error& e) {
         Logger::getInstance().error("Failed to initialize PostgreSQL connection pool: " + std::string(e.what()));
         throw;
@@ -31,7 +67,8 @@ void PostgreSQLDatabase::connect() {
 
 void PostgreSQLDatabase::disconnect() {
     if (m_connected) {
-        cleanupPool();
+        m_async.reset();  // Fails the statements still queued and closes the connections they hold
+        m_pool->shutdown();
         m_connected = false;
         Logger::getInstance().info("PostgreSQL connection pool closed.");
     }
@@ -47,33 +84,22 @@ int PostgreSQLDatabase::executeQuery(const std::string& query) {
 
 int PostgreSQLDatabase::executeQuery(const std::string& query, const std::vector<std::string>& params) {
     checkConnection();
+    auto conn = m_pool->acquire();
+    return executeOn(conn, query, params);
+}
 
-    const auto conn = acquireConnection();
-    std::vector<const char*> c_params;
-    c_params.reserve(params.size());
-    for (const auto& param : params) {
-        c_params.push_back(param.c_str());
-    }
-
-    PGresult* result = PQexecParams(conn,
-                                    query.c_str(),
-                                    static_cast<int>(params.size()),
-                                    nullptr,
-                                    c_params.data(),
-                                    nullptr,
-                                    nullptr,
-                                    0);
+int PostgreSQLDatabase::executeOn(ConnectionPool<PGconn>::Lease& conn, const std::string& query,
+                                  const std::vector<std::string>& params) {
+    auto result = execParams(conn, query, params);
 
     int affectedRows = -1;
-    if (PQresultStatus(result) == PGRES_COMMAND_OK) {
-        affectedRows = std::stoi(PQcmdTuples(result));
+    if (PQresultStatus(result.get()) == PGRES_COMMAND_OK) {
+        const char* tuples = PQcmdTuples(result.get());
+        affectedRows = *tuples ? std::stoi(tuples) : 0;
         Logger::getInstance().info("Parameterized query executed successfully: " + query);
     } else {
-        Logger::getInstance().error("PostgreSQLDatabase query execution failed: " + std::string(PQerrorMessage(conn)));
+        Logger::getInstance().error("PostgreSQLDatabase query execution failed: " + std::string(PQerrorMessage(conn.get())));
     }
-
-    PQclear(result);
-    releaseConnection(conn);
     return affectedRows;
 }
 
@@ -82,82 +108,259 @@ std::vector<std::vector<std::string>> PostgreSQLDatabase::fetchQuery(const std::
 }
 
 std::vector<std::vector<std::string>> PostgreSQLDatabase::fetchQuery(const std::string& query, const std::vector<std::string>& params) {
+    return fetchResult(query, params)->toRows();
+}
+
+std::unique_ptr<ResultSet> PostgreSQLDatabase::fetchResult(const std::string& query, const std::vector<std::string>& params) {
     checkConnection();
-    const auto conn = acquireConnection();
+    auto conn = m_pool->acquire();
+    // The PGresult is independent of the connection, which goes back to the pool on return.
+    return fetchOn(conn, query, params);
+}
 
-    std::vector<const char*> c_params;
-    c_params.reserve(params.size());
-    for (const auto& param : params) {
-        c_params.push_back(param.c_str());
+std::unique_ptr<ResultSet> PostgreSQLDatabase::fetchOn(ConnectionPool<PGconn>::Lease& conn, const std::string& query,
+                                                       const std::vector<std::string>& params) {
+    auto result = execParams(conn, query, params);
+    if (PQresultStatus(result.get()) != PGRES_TUPLES_OK) {
+        throw std::runtime_error("PostgreSQLDatabase query fetch failed: " + std::string(PQerrorMessage(conn.get())));
     }
+    return std::make_unique<PostgreSQLResultSet>(result.release());
+}
 
-    PGresult* result = PQexecParams(conn,
-                                    query.c_str(),
-                                    static_cast<int>(params.size()),
-                                    nullptr,
-                                    c_params.data(),
-                                    nullptr,
-                                    nullptr,
-                                    0);
+void PostgreSQLDatabase::executeQueryAsync(const std::string& query, const std::vector<std::string>& params,
+                                           ExecuteCallback onDone) {
+    checkConnection();
+    m_async->submit(query, params, [onDone = std::move(onDone)](PGresultPtr result, const std::string& error) {
+        const int affectedRows = result ? affectedRowsOf(result.get()) : -1;
+        if (affectedRows < 0) {
+            Logger::getInstance().error("PostgreSQLDatabase async query execution failed: ",
+                                        result ? PQresultErrorMessage(result.get()) : error);
+        }
+        onDone(affectedRows);
+    });
+}
 
-    if (PQresultStatus(result) != PGRES_TUPLES_OK) {
-        const std::string error = PQerrorMessage(conn);
-        PQclear(result);
-        releaseConnection(conn);
-        throw std::runtime_error("PostgreSQLDatabase query fetch failed: " + error);
+void PostgreSQLDatabase::fetchResultAsync(const std::string& query, const std::vector<std::string>& params,
+                                          FetchCallback onDone) {
+    checkConnection();
+    m_async->submit(query, params, [onDone = std::move(onDone)](PGresultPtr result, const std::string& error) {
+        if (!result || PQresultStatus(result.get()) != PGRES_TUPLES_OK) {
+            const std::string message = result ? PQresultErrorMessage(result.get()) : error;
+            onDone(nullptr, std::make_exception_ptr(std::runtime_error("PostgreSQLDatabase async query fetch failed: " + message)));
+            return;
+        }
+        onDone(std::make_unique<PostgreSQLResultSet>(result.release()), nullptr);
+    });
+}
+
+std::shared_ptr<ITransaction> PostgreSQLDatabase::beginTransaction() {
+    checkConnection();
+    return std::make_shared<PostgreSQLTransaction>(m_pool->acquire());
+}
+
+std::vector<int> PostgreSQLDatabase::executeBatch(const std::vector<BatchStatement>& statements) {
+    checkConnection();
+    std::vector<int> results(statements.size(), -1);
+    if (statements.empty()) {
+        return results;
     }
 
-    const int numRows = PQntuples(result);
-    const int numCols = PQnfields(result);
-    std::vector<std::vector<std::string>> rows;
-    rows.reserve(numRows);
+    auto conn = m_pool->acquire();
+    if (PQenterPipelineMode(conn.get()) != 1) {
+        Logger::getInstance().warn("PostgreSQL pipeline mode unavailable, executing batch sequentially: ",
+                                   PQerrorMessage(conn.get()));
+        conn.reset();
+        return IDatabase::executeBatch(statements);
+    }
 
-    for (int i = 0; i < numRows; ++i) {
-        std::vector<std::string> row;
-        row.reserve(numCols);
-        for (int j = 0; j < numCols; ++j) {
-            row.emplace_back(PQgetvalue(result, i, j));
+    for (size_t begin = 0; begin < statements.size(); begin += kPipelineWindow) {
+        const size_t end = std::min(begin + kPipelineWindow, statements.size());
+        if (!runPipelineWindow(conn.get(), statements, begin, end, results)) {
+            Logger::getInstance().error("PostgreSQL pipeline failed: ", PQerrorMessage(conn.get()));
+            conn.markBroken();
+            return results;
         }
-        rows.emplace_back(std::move(row));
     }
 
-    PQclear(result);
-    releaseConnection(conn);
-    return rows;
+    if (PQexitPipelineMode(conn.get()) != 1) {
+        Logger::getInstance().error("Failed to leave PostgreSQL pipeline mode: ", PQerrorMessage(conn.get()));
+        conn.markBroken();
+    }
+    return results;
 }
 
-std::shared_ptr<ITransaction> PostgreSQLDatabase::beginTransaction() {
+std::vector<int> PostgreSQLDatabase::insertRows(const std::string& table, const std::vector<std::string>& columns,
+                                                const std::vector<std::vector<std::string>>& rows) {
+    checkRowWidths(columns, rows);
     checkConnection();
-    executeQuery("BEGIN");
-    return nullptr;
-}
-
-void PostgreSQLDatabase::initializePool() {
-    std::lock_guard<std::mutex> lock(m_poolMutex);
-    for (size_t i = 0; i < m_poolSize; ++i) {
-        PGconn* conn = PQconnectdb(m_conninfo.c_str());
-        if (PQstatus(conn) != CONNECTION_OK) {
-            const std::string error = PQerrorMessage(conn);
-            PQfinish(conn);
-            throw std::runtime_error("Failed to initialize PostgreSQL connection: " + error);
+
+    std::vector<int> ids;
+    ids.reserve(rows.size());
+    if (rows.empty()) {
+        return ids;
+    }
+
+    std::string prefix = "INSERT INTO " + table + " (";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        prefix += (i ? ", " : "") + columns[i];
+    }
+    prefix += ") VALUES ";
+
+    const size_t rowsPerStatement = std::max<size_t>(1, std::min(kBulkInsertRows, kMaxBindParameters / columns.size()));
+    const bool multiStatement = rows.size() > rowsPerStatement;
+
+    auto conn = m_pool->acquire();
+    auto runControl = [&conn](const char* command) {
+        const auto result = execParams(conn, command, {});
+        return PQresultStatus(result.get()) == PGRES_COMMAND_OK;
+    };
+
+    if (multiStatement && !runControl("BEGIN")) {
+        throw std::runtime_error("Failed to begin PostgreSQL bulk insert: " + std::string(PQerrorMessage(conn.get())));
+    }
+
+    try {
+        std::string query;
+        std::vector<const char*> values;
+        for (size_t first = 0; first < rows.size(); first += rowsPerStatement) {
+            const size_t count = std::min(rowsPerStatement, rows.size() - first);
+
+            // Only the last statement can be shorter, so the SQL text is built at most twice.
+            if (values.size() != count * columns.size()) {
+                query = prefix;
+                size_t parameter = 1;
+                for (size_t r = 0; r < count; ++r) {
+                    query += r ? ", (" : "(";
+                    for (size_t c = 0; c < columns.size(); ++c) {
+                        query += (c ? ", $" : "$") + std::to_string(parameter++);
+                    }
+                    query += ")";
+                }
+                query += " RETURNING id;";
+            }
+
+            values.clear();
+            for (size_t r = first; r < first + count; ++r) {
+                for (const auto& value : rows[r]) {
+                    values.push_back(value.c_str());
+                }
+            }
+
+            PGresultPtr result(PQexecParams(conn.get(), query.c_str(), static_cast<int>(values.size()), nullptr,
+                                            values.data(), nullptr, nullptr, 0),
+                               &PQclear);
+            if (PQstatus(conn.get()) != CONNECTION_OK) {
+                conn.markBroken();
+            }
+            if (PQresultStatus(result.get()) != PGRES_TUPLES_OK || PQntuples(result.get()) != static_cast<int>(count)) {
+                throw std::runtime_error("PostgreSQL bulk insert into " + table + " failed: " +
+                                         std::string(PQerrorMessage(conn.get())));
+            }
+
+            // RETURNING does not promise VALUES order, but the sequence hands out increasing IDs
+            // to the rows of one statement in the order they are inserted.
+            const size_t offset = ids.size();
+            for (int r = 0; r < static_cast<int>(count); ++r) {
+                ids.push_back(std::stoi(PQgetvalue(result.get(), r, 0)));
+            }
+            std::sort(ids.begin() + static_cast<std::ptrdiff_t>(offset), ids.end());
+        }
+    } catch (const std::exception&) {
+        if (multiStatement && PQstatus(conn.get()) == CONNECTION_OK) {
+            runControl("ROLLBACK");
+        }
+        throw;
+    }
+
+    if (multiStatement && !runControl("COMMIT")) {
+        throw std::runtime_error("Failed to commit PostgreSQL bulk insert: " + std::string(PQerrorMessage(conn.get())));
+    }
+    Logger::getInstance().info("Inserted ", rows.size(), " rows into ", table);
+    return ids;
+}
+
+bool PostgreSQLDatabase::runPipelineWindow(PGconn* conn, const std::vector<BatchStatement>& statements,
+                                           size_t begin, size_t end, std::vector<int>& results) {
+    std::vector<const char*> c_params;
+    for (size_t i = begin; i < end; ++i) {
+        const auto& statement = statements[i];
+        c_params.clear();
+        for (const auto& param : statement.params) {
+            c_params.push_back(param.c_str());
+        }
+        if (PQsendQueryParams(conn, statement.query.c_str(), static_cast<int>(statement.params.size()),
+                              nullptr, c_params.data(), nullptr, nullptr, 0) != 1 ||
+            PQpipelineSync(conn) != 1) {
+            return false;
+        }
+    }
+    if (PQflush(conn) != 0) {
+        return false;
+    }
+
+    // Each statement yields its result, a terminating nullptr, then the result of its sync point.
+    for (size_t i = begin; i < end; ++i) {
+        PGresult* result = PQgetResult(conn);
+        if (!result) {
+            return false;
+        }
+        results[i] = affectedRowsOf(result);
+        if (results[i] < 0) {
+            Logger::getInstance().error("PostgreSQLDatabase batch statement failed: ", PQresultErrorMessage(result),
+                                        " (", statements[i].query, ")");
+        }
+        PQclear(result);
+
+        while ((result = PQgetResult(conn)) != nullptr) {
+            PQclear(result);
+        }
+
+        result = PQgetResult(conn);
+        const bool synced = result && PQresultStatus(result) == PGRES_PIPELINE_SYNC;
+        PQclear(result);
+        if (!synced) {
+            return false;
         }
-        m_connectionPool.push(conn);
     }
+    return true;
 }
 
-PGconn* PostgreSQLDatabase::acquireConnection() {
-    std::unique_lock<std::mutex> lock(m_poolMutex);
-    m_condition.wait(lock, [this] { return !m_connectionPool.empty(); });
+std::optional<ConnectionPoolMetrics> PostgreSQLDatabase::getPoolMetrics() const {
+    return m_pool->metrics();
+}
 
-    PGconn* conn = m_connectionPool.front();
-    m_connectionPool.pop();
+PGconn* PostgreSQLDatabase::openConnection() const {
+    PGconn* conn = PQconnectdb(m_conninfo.c_str());
+    if (PQstatus(conn) != CONNECTION_OK) {
+        const std::string error = PQerrorMessage(conn);
+        PQfinish(conn);
+        throw std::runtime_error("Failed to initialize PostgreSQL connection: " + error);
+    }
     return conn;
 }
 
-void PostgreSQLDatabase::releaseConnection(PGconn* conn) {
-    std::lock_guard<std::mutex> lock(m_poolMutex);
-    m_connectionPool.push(conn);
-    m_condition.notify_one();
+PostgreSQLDatabase::PGresultPtr PostgreSQLDatabase::execParams(ConnectionPool<PGconn>::Lease& conn, const std::string& query,
+                                                               const std::vector<std::string>& params) {
+    std::vector<const char*> c_params;
+    c_params.reserve(params.size());
+    for (const auto& param : params) {
+        c_params.push_back(param.c_str());
+    }
+
+    PGresultPtr result(PQexecParams(conn.get(),
+                                    query.c_str(),
+                                    static_cast<int>(params.size()),
+                                    nullptr,
+                                    c_params.data(),
+                                    nullptr,
+                                    nullptr,
+                                    0),
+                       &PQclear);
+
+    if (PQstatus(conn.get()) != CONNECTION_OK) {
+        conn.markBroken();
+    }
+    return result;
 }
 
 void PostgreSQLDatabase::checkConnection() const {
@@ -166,24 +369,22 @@ void PostgreSQLDatabase::checkConnection() const {
     }
 }
 
-void PostgreSQLDatabase::cleanupPool() {
-    std::lock_guard<std::mutex> lock(m_poolMutex);
-    while (!m_connectionPool.empty()) {
-        PGconn* conn = m_connectionPool.front();
-        m_connectionPool.pop();
-        PQfinish(conn);
-    }
-}
-
 int PostgreSQLDatabase::getLastInsertId() {
     throw std::runtime_error("PostgreSQLDatabase: getLastInsertId not available on PostgreSQL");
 }
 
 int PostgreSQLDatabase::executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) {
+    checkConnection();
+    auto conn = m_pool->acquire();
+    return insertOn(conn, query, params);
+}
+
+int PostgreSQLDatabase::insertOn(ConnectionPool<PGconn>::Lease& conn, const std::string& query,
+                                 const std::vector<std::string>& params) {
     // Use the PostgreSQL `RETURNING` clause in the query, and fetch the result.
-    auto result = fetchQuery(query, params);
-    if (!result.empty() && !result[0].empty()) {
-        return std::stoi(result[0][0]);
+    const auto result = fetchOn(conn, query, params);
+    if (!result->empty() && result->columnCount() > 0) {
+        return static_cast<int>(result->row(0).getInt64(0));
     }
     return -1;
 }
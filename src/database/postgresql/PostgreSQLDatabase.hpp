@@ -1,11 +1,12 @@
 #pragma once
 
 #include "database/interfaces/IDatabase.hpp"
+#include "database/ConnectionPool.hpp"
+#include "database/postgresql/PostgreSQLAsyncExecutor.hpp"
 #include <libpq-fe.h>
+#include <memory>
 #include <string>
 #include <vector>
-#include <queue>
-#include <condition_variable>
 
 /**
  * @class PostgreSQLDatabase
@@ -16,9 +17,9 @@ public:
     /**
      * @brief Constructs a PostgreSQLDatabase instance with specified connection string and pool size.
      * @param conninfo Connection string for the PostgreSQL database.
-     * @param poolSize Number of connections to maintain in the connection pool.
+     * @param poolOptions Sizing, timeouts and health check policy of the connection pool.
      */
-    PostgreSQLDatabase(std::string conninfo, size_t poolSize);
+    PostgreSQLDatabase(std::string conninfo, const ConnectionPoolOptions& poolOptions);
 
     /**
      * @brief Destructor. Ensures all connections are closed.
@@ -42,6 +43,8 @@ public:
      */
     [[nodiscard]] bool isConnected() const override;
 
+    [[nodiscard]] SqlDialect dialect() const override { return SqlDialect::PostgreSQL; }
+
     /**
      * @brief Executes a non-select SQL query on the database.
      * @param query SQL query string to execute.
@@ -75,48 +78,113 @@ public:
     std::vector<std::vector<std::string>> fetchQuery(const std::string& query, const std::vector<std::string>& params) override;
 
     /**
-     * @brief Begins a new database transaction.
+     * @brief Executes a parameterized select query; the result wraps the PGresult without copying cells.
+     * @param query SQL query string with placeholders.
+     * @param params Vector of parameter values for the query.
+     * @return The query result.
+     * @throws std::runtime_error if the query fails.
+     */
+    std::unique_ptr<ResultSet> fetchResult(const std::string& query, const std::vector<std::string>& params) override;
+
+    /**
+     * @brief Sends the statement without waiting for it; see PostgreSQLAsyncExecutor.
+     *
+     * The callback runs on the executor's event loop thread once the result has been read.
+     */
+    void executeQueryAsync(const std::string& query, const std::vector<std::string>& params,
+                           ExecuteCallback onDone) override;
+
+    /**
+     * @brief Sends the query without waiting for it; the result wraps the PGresult like fetchResult.
+     */
+    void fetchResultAsync(const std::string& query, const std::vector<std::string>& params,
+                          FetchCallback onDone) override;
+    using IDatabase::executeQueryAsync;
+    using IDatabase::fetchResultAsync;
+
+    /**
+     * @brief Begins a transaction pinned to one pooled connection until it commits or rolls back.
      * @return A shared pointer to an ITransaction representing the transaction.
      * @throws std::runtime_error if the transaction cannot be started.
      */
     std::shared_ptr<ITransaction> beginTransaction() override;
 
+    /**
+     * @brief Executes the statements on one connection in libpq pipeline mode.
+     *
+     * Statements are sent in windows without waiting for each result, so a window costs a single
+     * round trip. A sync point follows every statement, so each one commits on its own and an
+     * error only fails that statement.
+     *
+     * @param statements Statements to execute, in order.
+     * @return Affected rows for each statement, or -1 for the ones that failed.
+     */
+    std::vector<int> executeBatch(const std::vector<BatchStatement>& statements) override;
+
+    /**
+     * @brief Inserts the rows with multi-row `INSERT ... VALUES ... RETURNING id` statements on one connection.
+     *
+     * Each statement carries up to 1000 rows (fewer for wide rows, to stay within the protocol's
+     * 65535 bind parameters); when more than one is needed they share a single transaction.
+     *
+     * @return Generated ID of each row, in the order of `rows`.
+     * @throws std::invalid_argument if a row does not have one value per column.
+     * @throws std::runtime_error if the insert fails; no row is inserted then.
+     */
+    std::vector<int> insertRows(const std::string& table, const std::vector<std::string>& columns,
+                                const std::vector<std::vector<std::string>>& rows) override;
+
+    /**
+     * @brief Returns wait-time and utilization counters of the connection pool.
+     */
+    [[nodiscard]] std::optional<ConnectionPoolMetrics> getPoolMetrics() const override;
+
 private:
-    std::string m_conninfo;            ///< Connection string for PostgreSQL database.
-    size_t m_poolSize;                 ///< Number of connections in the pool.
-    std::queue<PGconn*> m_connectionPool; ///< Pool of PostgreSQL connections.
-    mutable std::mutex m_poolMutex;    ///< Mutex for thread-safe connection pool access.
-    std::condition_variable m_condition; ///< Condition variable for managing connection availability.
-    bool m_connected;                  ///< Connection status flag for the pool.
+    friend class PostgreSQLTransaction;
+
+    using PGresultPtr = std::unique_ptr<PGresult, decltype(&PQclear)>;
+
+    std::string m_conninfo;                          ///< Connection string for PostgreSQL database.
+    std::unique_ptr<ConnectionPool<PGconn>> m_pool;  ///< Pool of PostgreSQL connections.
+    std::unique_ptr<PostgreSQLAsyncExecutor> m_async; ///< Event loop for the asynchronous calls; exists while connected.
+    bool m_connected;                                ///< Connection status flag for the pool.
 
     /**
-     * @brief Initializes the connection pool with `m_poolSize` connections.
+     * @brief Opens a single connection for the pool.
      * @throws std::runtime_error if a connection cannot be established.
      */
-    void initializePool();
+    PGconn* openConnection() const;
 
     /**
-     * @brief Retrieves a connection from the pool, waiting if necessary.
-     * @return A pointer to a `PGconn` from the pool.
+     * @brief Runs a parameterized statement on a leased connection.
+     * Marks the lease broken if the connection dropped, so the pool replaces it.
      */
-    PGconn* acquireConnection();
+    static PGresultPtr execParams(ConnectionPool<PGconn>::Lease& conn, const std::string& query,
+                                  const std::vector<std::string>& params);
 
     /**
-     * @brief Releases a connection back into the pool.
-     * @param conn A pointer to a `PGconn` to return to the pool.
+     * @brief executeQuery, fetchResult and executeInsertReturningId on a given connection,
+     * shared by the pooled calls and by PostgreSQLTransaction.
      */
-    void releaseConnection(PGconn* conn);
+    static int executeOn(ConnectionPool<PGconn>::Lease& conn, const std::string& query,
+                         const std::vector<std::string>& params);
+    static std::unique_ptr<ResultSet> fetchOn(ConnectionPool<PGconn>::Lease& conn, const std::string& query,
+                                              const std::vector<std::string>& params);
+    static int insertOn(ConnectionPool<PGconn>::Lease& conn, const std::string& query,
+                        const std::vector<std::string>& params);
 
     /**
-     * @brief Checks if the database is connected and throws an exception if it is not.
-     * @throws std::runtime_error if the connection pool is not initialized.
+     * @brief Sends statements [begin, end) as one pipeline window and collects their results into `results`.
+     * @return False if the connection failed mid-window; the remaining results stay -1.
      */
-    void checkConnection() const;
+    static bool runPipelineWindow(PGconn* conn, const std::vector<BatchStatement>& statements,
+                                  size_t begin, size_t end, std::vector<int>& results);
 
     /**
-     * @brief Cleans up all connections in the connection pool, closing each one.
+     * @brief Checks if the database is connected and throws an exception if it is not.
+     * @throws std::runtime_error if the connection pool is not initialized.
      */
-    void cleanupPool();
+    void checkConnection() const;
 
    /**
     * @brief Retrieves the last inserted row ID for the database.
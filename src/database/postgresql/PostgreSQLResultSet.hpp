@@ -0,0 +1,38 @@
+#pragma once
+
+#include "database/ResultSet.hpp"
+#include <libpq-fe.h>
+#include <memory>
+
+/**
+ * @class PostgreSQLResultSet
+ * @brief ResultSet over a PGresult; cells point straight into libpq's buffers.
+ */
+class PostgreSQLResultSet final : public ResultSet {
+public:
+    /**
+     * @brief Takes ownership of a result in PGRES_TUPLES_OK state.
+     */
+    explicit PostgreSQLResultSet(PGresult* result) : m_result(result, &PQclear) {}
+
+    [[nodiscard]] size_t rowCount() const override { return static_cast<size_t>(PQntuples(m_result.get())); }
+    [[nodiscard]] size_t columnCount() const override { return static_cast<size_t>(PQnfields(m_result.get())); }
+
+    [[nodiscard]] std::string_view columnName(size_t column) const override {
+        const char* name = PQfname(m_result.get(), static_cast<int>(column));
+        return name ? std::string_view(name) : std::string_view();
+    }
+
+    [[nodiscard]] std::string_view value(size_t row, size_t column) const override {
+        const int r = static_cast<int>(row);
+        const int c = static_cast<int>(column);
+        return {PQgetvalue(m_result.get(), r, c), static_cast<size_t>(PQgetlength(m_result.get(), r, c))};
+    }
+
+    [[nodiscard]] bool isNull(size_t row, size_t column) const override {
+        return PQgetisnull(m_result.get(), static_cast<int>(row), static_cast<int>(column)) == 1;
+    }
+
+private:
+    std::unique_ptr<PGresult, decltype(&PQclear)> m_result;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "database/interfaces/ITransaction.hpp"
+#include "database/postgresql/PostgreSQLDatabase.hpp"
+#include "utils/Logger.hpp"
+#include <optional>
+
+/**
+ * @class PostgreSQLTransaction
+ * @brief Transaction pinned to one leased PostgreSQL connection.
+ *
+ * The connection goes back to the pool as soon as the transaction commits or rolls back. After a failed
+ * statement PostgreSQL rejects everything but a rollback, either of the whole transaction or to a savepoint.
+ */
+class PostgreSQLTransaction final : public ITransaction {
+public:
+    /**
+     * @brief Begins the transaction on the leased connection.
+     * @throws std::runtime_error if BEGIN fails.
+     */
+    explicit PostgreSQLTransaction(ConnectionPool<PGconn>::Lease connection) : m_connection(std::move(connection)) {
+        if (PostgreSQLDatabase::executeOn(m_connection, "BEGIN", {}) < 0) {
+            m_connection.markBroken();
+            throw std::runtime_error("Failed to begin PostgreSQL transaction: " +
+                                     std::string(PQerrorMessage(m_connection.get())));
+        }
+    }
+
+    ~PostgreSQLTransaction() override {
+        if (m_connection) {
+            try {
+                rollback();
+            } catch (const std::exception& e) {
+                Logger::getInstance().error("PostgreSQL transaction rollback failed: " + std::string(e.what()));
+            }
+        }
+    }
+
+    int executeQuery(const std::string& query, const std::vector<std::string>& params) override {
+        checkActive();
+        return PostgreSQLDatabase::executeOn(m_connection, query, params);
+    }
+
+    std::unique_ptr<ResultSet> fetchResult(const std::string& query, const std::vector<std::string>& params) override {
+        checkActive();
+        return PostgreSQLDatabase::fetchOn(m_connection, query, params);
+    }
+
+    int executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) override {
+        checkActive();
+        return PostgreSQLDatabase::insertOn(m_connection, query, params);
+    }
+
+    void commit() override {
+        end("COMMIT");
+    }
+
+    void rollback() override {
+        end("ROLLBACK");
+    }
+
+private:
+    void checkActive() const {
+        if (!m_connection) {
+            throw std::logic_error("PostgreSQL transaction has already ended");
+        }
+    }
+
+    // The lease is returned either way: a connection whose COMMIT or ROLLBACK failed is left in an
+    // unknown state, so it is discarded rather than reused.
+    void end(const char* command) {
+        checkActive();
+        const auto result = PostgreSQLDatabase::execParams(m_connection, command, {});
+        std::optional<std::string> error;
+        if (PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
+            error = PQerrorMessage(m_connection.get());
+            m_connection.markBroken();
+        } else if (std::string(command) == "COMMIT" && std::string(PQcmdStatus(result.get())) == "ROLLBACK") {
+            // COMMIT of a transaction aborted by an earlier error succeeds but rolls back.
+            error = "transaction was aborted by an earlier error and has been rolled back";
+        }
+        m_connection.reset();
+        if (error) {
+            throw std::runtime_error(std::string(command) + " failed: " + *error);
+        }
+    }
+
+    ConnectionPool<PGconn>::Lease m_connection;  ///< Pinned connection; empty once the transaction has ended.
+};
@@ -1,41 +1,108 @@
 #include "SQLiteDatabase.hpp"
+#include "SQLiteTransaction.hpp"
 #include "utils/Logger.hpp"
+#include <algorithm>
 #include <stdexcept>
 
+namespace {
+    bool isInMemory(const std::string& path) {
+        return path.empty() || path == ":memory:" || path.rfind("file::memory:", 0) == 0;
+    }
+}
+
 SQLiteDatabase::SQLiteDatabase(std::string dbPath)
-    : m_dbPath(std::move(dbPath)), m_db(nullptr), m_connected(false) {}
+    : SQLiteDatabase(std::move(dbPath), Settings{}) {}
+
+SQLiteDatabase::SQLiteDatabase(std::string dbPath, const Settings& settings)
+    : m_dbPath(std::move(dbPath)), m_settings(settings), m_connected(false) {}
 
 SQLiteDatabase::~SQLiteDatabase() {
-    std::lock_guard lock(m_mutex);
-    if (m_connected && m_db) {
-        sqlite3_close(m_db);
-        m_connected = false;
-        Logger::getInstance().info("Disconnected from SQLite database at " + m_dbPath);
-    }
+    disconnect();
 }
 
 void SQLiteDatabase::connect() {
-    std::lock_guard lock(m_mutex);
+    std::lock_guard lock(m_writeMutex);
     if (m_connected) {
         Logger::getInstance().warn("Database is already connected.");
         return;
     }
-    if (sqlite3_open(m_dbPath.c_str(), &m_db) == SQLITE_OK) {
-        m_connected = true;
-        Logger::getInstance().info("Connected to SQLite database at " + m_dbPath);
-    } else {
-        throw std::runtime_error("Failed to connect to SQLite database at " + m_dbPath);
+
+    m_writer = open(false);
+
+    // An in-memory database is private to its connection, so readers could never see its tables.
+    size_t readConnections = isInMemory(m_dbPath) ? 0 : m_settings.readConnections;
+    try {
+        m_readers.resize(readConnections);
+        for (auto& reader : m_readers) {
+            reader = open(true);
+        }
+    } catch (...) {
+        for (auto& reader : m_readers) {
+            close(reader);
+        }
+        m_readers.clear();
+        close(m_writer);
+        throw;
     }
+
+    {
+        std::lock_guard readerLock(m_readerMutex);
+        m_idleReaders.clear();
+        for (auto& reader : m_readers) {
+            m_idleReaders.push_back(&reader);
+        }
+    }
+    m_useReaders = !m_readers.empty();
+    m_connected = true;
+
+    m_asyncThread = std::make_unique<ThreadPool>(1);
+
+    if (!m_readers.empty() && m_settings.checkpointInterval.count() > 0) {
+        m_stopCheckpoint = false;
+        m_checkpointThread = std::thread(&SQLiteDatabase::checkpointLoop, this);
+    }
+
+    Logger::getInstance().info("Connected to SQLite database at ", m_dbPath, " (1 writer, ",
+                               m_readers.size(), " readers)");
 }
 
 void SQLiteDatabase::disconnect() {
-    std::lock_guard lock(m_mutex);
-    if (m_connected && m_db) {
-        sqlite3_close(m_db);
-        m_connected = false;
-        m_db = nullptr;
-        Logger::getInstance().info("Disconnected from SQLite database at " + m_dbPath);
+    // Let queued asynchronous calls finish while the connections are still open
+    m_asyncThread.reset();
+
+    {
+        // Flip the flag under the reader mutex so threads waiting for a reader wake up and fail.
+        std::lock_guard readerLock(m_readerMutex);
+        if (!m_connected.exchange(false)) {
+            return;
+        }
+        m_useReaders = false;
+    }
+    m_readerAvailable.notify_all();
+
+    if (m_checkpointThread.joinable()) {
+        {
+            std::lock_guard lock(m_checkpointMutex);
+            m_stopCheckpoint = true;
+        }
+        m_checkpointWake.notify_all();
+        m_checkpointThread.join();
     }
+
+    {
+        std::unique_lock readerLock(m_readerMutex);
+        m_readerAvailable.wait(readerLock, [this] { return m_idleReaders.size() == m_readers.size(); });
+        m_idleReaders.clear();
+        for (auto& reader : m_readers) {
+            close(reader);
+        }
+        m_readers.clear();
+    }
+
+    std::lock_guard lock(m_writeMutex);
+    close(m_writer);
+    m_transactionOwner = std::thread::id();
+    Logger::getInstance().info("Disconnected from SQLite database at " + m_dbPath);
 }
 
 bool SQLiteDatabase::isConnected() const {
@@ -47,81 +114,353 @@ int SQLiteDatabase::executeQuery(const std::string& query) {
 }
 
 int SQLiteDatabase::executeQuery(const std::string& query, const std::vector<std::string>& params) {
-    std::lock_guard lock(m_mutex);
+    std::lock_guard lock(m_writeMutex);
     checkConnection();
+    return executeOnWriter(query, params);
+}
 
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        Logger::getInstance().error("Failed to prepare query: " + query);
-        return -1;
-    }
+std::vector<std::vector<std::string>> SQLiteDatabase::fetchQuery(const std::string& query) {
+    return fetchQuery(query, {});
+}
+
+template <typename Consume>
+auto SQLiteDatabase::runRead(const std::string& query, const std::vector<std::string>& params, Consume&& consume) {
+    checkConnection();
+
+    if (m_useReaders && m_transactionOwner.load() != std::this_thread::get_id()) {
+        struct ReaderGuard {
+            SQLiteDatabase& database;
+            Connection* reader;
+            ~ReaderGuard() { database.releaseReader(reader); }
+        } guard{*this, acquireReader()};
 
-    for (int i = 0; i < params.size(); ++i) {
-        if (sqlite3_bind_text(stmt, i + 1, params[i].c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
-            Logger::getInstance().error("Failed to bind parameter " + std::to_string(i + 1));
-            sqlite3_finalize(stmt);
-            return -1;
+        auto stmt = prepare(*guard.reader, query, params);
+        if (sqlite3_stmt_readonly(stmt.get())) {
+            return consume(stmt.get());
         }
+        // Statements such as INSERT ... RETURNING fall through to the writer.
     }
 
-    int affectedRows = (sqlite3_step(stmt) == SQLITE_DONE) ? sqlite3_changes(m_db) : -1;
-    sqlite3_finalize(stmt);
-    return affectedRows;
+    std::lock_guard lock(m_writeMutex);
+    checkConnection();
+    auto stmt = prepare(m_writer, query, params);
+    return consume(stmt.get());
 }
 
-std::vector<std::vector<std::string>> SQLiteDatabase::fetchQuery(const std::string& query) {
-    return fetchQuery(query, {});
+std::vector<std::vector<std::string>> SQLiteDatabase::fetchQuery(const std::string& query, const std::vector<std::string>& params) {
+    return runRead(query, params, &SQLiteDatabase::collectRows);
 }
 
-std::vector<std::vector<std::string>> SQLiteDatabase::fetchQuery(const std::string& query, const std::vector<std::string>& params) {
-    std::lock_guard lock(m_mutex);
+std::unique_ptr<ResultSet> SQLiteDatabase::fetchResult(const std::string& query, const std::vector<std::string>& params) {
+    return runRead(query, params, &SQLiteDatabase::collectResult);
+}
+
+void SQLiteDatabase::executeQueryAsync(const std::string& query, const std::vector<std::string>& params,
+                                       ExecuteCallback onDone) {
+    checkConnection();
+    executeQueryOn(*m_asyncThread, query, params, std::move(onDone));
+}
+
+void SQLiteDatabase::fetchResultAsync(const std::string& query, const std::vector<std::string>& params,
+                                      FetchCallback onDone) {
+    checkConnection();
+    fetchResultOn(*m_asyncThread, query, params, std::move(onDone));
+}
+
+int SQLiteDatabase::getLastInsertId() {
+    std::lock_guard lock(m_writeMutex);
+    checkConnection();
+    return static_cast<int>(sqlite3_last_insert_rowid(m_writer.db));
+}
+
+int SQLiteDatabase::executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) {
+    // Hold the writer across both calls so another insert can't slip in between.
+    std::lock_guard lock(m_writeMutex);
+    checkConnection();
+    executeOnWriter(query, params);
+    return static_cast<int>(sqlite3_last_insert_rowid(m_writer.db));
+}
+
+std::shared_ptr<ITransaction> SQLiteDatabase::beginTransaction() {
+    return std::make_shared<SQLiteTransaction>(*this);
+}
+
+std::vector<int> SQLiteDatabase::executeBatch(const std::vector<BatchStatement>& statements) {
+    std::lock_guard lock(m_writeMutex);
+    checkConnection();
+
+    const bool ownTransaction = sqlite3_get_autocommit(m_writer.db) != 0;
+    if (ownTransaction && executeOnWriter("BEGIN TRANSACTION;", {}) < 0) {
+        throw std::runtime_error("Failed to begin SQLite batch transaction.");
+    }
+
+    std::vector<int> results;
+    results.reserve(statements.size());
+    for (const auto& statement : statements) {
+        results.push_back(executeOnWriter(statement.query, statement.params));
+    }
+
+    if (ownTransaction && executeOnWriter("COMMIT;", {}) < 0) {
+        executeOnWriter("ROLLBACK;", {});
+        throw std::runtime_error("Failed to commit SQLite batch transaction.");
+    }
+    return results;
+}
+
+std::vector<int> SQLiteDatabase::insertRows(const std::string& table, const std::vector<std::string>& columns,
+                                            const std::vector<std::vector<std::string>>& rows) {
+    checkRowWidths(columns, rows);
+
+    std::string query = "INSERT INTO " + table + " (";
+    std::string placeholders;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        query += (i ? ", " : "") + columns[i];
+        placeholders += i ? ", ?" : "?";
+    }
+    query += ") VALUES (" + placeholders + ");";
+
+    std::lock_guard lock(m_writeMutex);
     checkConnection();
 
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare query: " + query);
+    // A savepoint starts a transaction when none is open and nests otherwise, so a failure
+    // undoes exactly the rows of this call.
+    if (executeOnWriter("SAVEPOINT insert_rows;", {}) < 0) {
+        throw std::runtime_error("Failed to begin SQLite bulk insert.");
+    }
+
+    std::vector<int> ids;
+    ids.reserve(rows.size());
+    try {
+        auto stmt = m_writer.statements->acquire(query);
+        if (!stmt) {
+            throw std::runtime_error("Failed to prepare query: " + query + " (" + sqlite3_errmsg(m_writer.db) + ")");
+        }
+        for (const auto& row : rows) {
+            for (int i = 0; i < static_cast<int>(row.size()); ++i) {
+                if (sqlite3_bind_text(stmt.get(), i + 1, row[i].c_str(), static_cast<int>(row[i].size()),
+                                      SQLITE_STATIC) != SQLITE_OK) {
+                    throw std::runtime_error("Failed to bind parameter at index: " + std::to_string(i + 1));
+                }
+            }
+            if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+                throw std::runtime_error("Failed to insert row " + std::to_string(ids.size()) + " into " + table +
+                                         ": " + sqlite3_errmsg(m_writer.db));
+            }
+            ids.push_back(static_cast<int>(sqlite3_last_insert_rowid(m_writer.db)));
+            sqlite3_reset(stmt.get());
+        }
+    } catch (const std::exception&) {
+        executeOnWriter("ROLLBACK TO insert_rows;", {});
+        executeOnWriter("RELEASE insert_rows;", {});
+        throw;
+    }
+
+    if (executeOnWriter("RELEASE insert_rows;", {}) < 0) {
+        executeOnWriter("ROLLBACK TO insert_rows;", {});
+        executeOnWriter("RELEASE insert_rows;", {});
+        throw std::runtime_error("Failed to commit SQLite bulk insert.");
+    }
+    return ids;
+}
+
+SQLiteDatabase::StatementCacheStats SQLiteDatabase::getStatementCacheStats() const {
+    StatementCacheStats total;
+    auto add = [&total](const Connection& connection) {
+        if (!connection.statements) {
+            return;
+        }
+        auto stats = connection.statements->stats();
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.evictions += stats.evictions;
+        total.size += stats.size;
+    };
+
+    std::scoped_lock lock(m_writeMutex, m_readerMutex);
+    add(m_writer);
+    for (const auto& reader : m_readers) {
+        add(reader);
+    }
+    return total;
+}
+
+void SQLiteDatabase::checkConnection() const {
+    if (!m_connected) {
+        throw std::runtime_error("SQLiteDatabase is not connected.");
+    }
+}
+
+SQLiteDatabase::Connection SQLiteDatabase::open(bool readOnly) const {
+    Connection connection;
+    int flags = SQLITE_OPEN_NOMUTEX | (readOnly ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    if (sqlite3_open_v2(m_dbPath.c_str(), &connection.db, flags, nullptr) != SQLITE_OK) {
+        std::string error = connection.db ? sqlite3_errmsg(connection.db) : "out of memory";
+        sqlite3_close(connection.db);
+        throw std::runtime_error("Failed to connect to SQLite database at " + m_dbPath + ": " + error);
+    }
+    sqlite3_busy_timeout(connection.db, static_cast<int>(m_settings.busyTimeout.count()));
+
+    if (!readOnly && !isInMemory(m_dbPath)) {
+        // journal_mode is persistent in the file; readers opened afterwards pick it up.
+        char* error = nullptr;
+        if (sqlite3_exec(connection.db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;",
+                         nullptr, nullptr, &error) != SQLITE_OK) {
+            Logger::getInstance().warn("Failed to enable WAL on ", m_dbPath, ": ", error ? error : "unknown error");
+            sqlite3_free(error);
+        }
+    }
+
+    connection.statements = std::make_unique<SQLiteStatementCache>(connection.db, m_settings.statementCacheSize);
+    return connection;
+}
+
+void SQLiteDatabase::close(Connection& connection) {
+    // Statements must be finalized before the handle can be closed.
+    connection.statements.reset();
+    if (connection.db) {
+        sqlite3_close(connection.db);
+        connection.db = nullptr;
+    }
+}
+
+SQLiteStatementCache::Lease SQLiteDatabase::prepare(Connection& connection, const std::string& query, const std::vector<std::string>& params) {
+    auto stmt = connection.statements->acquire(query);
+    if (!stmt) {
+        throw std::runtime_error("Failed to prepare query: " + query + " (" + sqlite3_errmsg(connection.db) + ")");
     }
 
-    for (int i = 0; i < params.size(); ++i) {
-        if (sqlite3_bind_text(stmt, i + 1, params[i].c_str(), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
-            sqlite3_finalize(stmt);
+    for (int i = 0; i < static_cast<int>(params.size()); ++i) {
+        if (sqlite3_bind_text(stmt.get(), i + 1, params[i].c_str(), static_cast<int>(params[i].size()), SQLITE_TRANSIENT) != SQLITE_OK) {
             throw std::runtime_error("Failed to bind parameter at index: " + std::to_string(i + 1));
         }
     }
+    return stmt;
+}
 
+std::vector<std::vector<std::string>> SQLiteDatabase::collectRows(sqlite3_stmt* stmt) {
     std::vector<std::vector<std::string>> results;
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
+    int columnCount = sqlite3_column_count(stmt);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
         std::vector<std::string> row;
-        int columnCount = sqlite3_column_count(stmt);
+        row.reserve(columnCount);
         for (int i = 0; i < columnCount; ++i) {
             const char* val = reinterpret_cast<const char*>(sqlite3_column_text(stmt, i));
             row.emplace_back(val ? val : "");
         }
-        results.push_back(row);
+        results.push_back(std::move(row));
+    }
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Query failed: ") + sqlite3_errmsg(sqlite3_db_handle(stmt)));
     }
-
-    sqlite3_finalize(stmt);
     return results;
 }
 
-int SQLiteDatabase::getLastInsertId() {
-    std::lock_guard lock(m_mutex);
-    checkConnection();
-    return static_cast<int>(sqlite3_last_insert_rowid(m_db));
+std::unique_ptr<ResultSet> SQLiteDatabase::collectResult(sqlite3_stmt* stmt) {
+    auto result = std::make_unique<BufferedResultSet>();
+    addColumns(stmt, *result);
+    while (stepInto(stmt, *result)) {
+    }
+    return result;
 }
 
-int SQLiteDatabase::executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) {
-    executeQuery(query, params);
-    return getLastInsertId();
+void SQLiteDatabase::addColumns(sqlite3_stmt* stmt, BufferedResultSet& result) {
+    const int columnCount = sqlite3_column_count(stmt);
+    for (int i = 0; i < columnCount; ++i) {
+        const char* name = sqlite3_column_name(stmt, i);
+        result.addColumn(name ? name : "");
+    }
 }
 
-std::shared_ptr<ITransaction> SQLiteDatabase::beginTransaction() {
-    executeQuery("BEGIN TRANSACTION;");
-    return nullptr;
+bool SQLiteDatabase::stepInto(sqlite3_stmt* stmt, BufferedResultSet& result) {
+    const int rc = sqlite3_step(stmt);
+    if (rc == SQLITE_DONE) {
+        return false;
+    }
+    if (rc != SQLITE_ROW) {
+        throw std::runtime_error(std::string("Query failed: ") + sqlite3_errmsg(sqlite3_db_handle(stmt)));
+    }
+
+    const int columnCount = sqlite3_column_count(stmt);
+    result.beginRow();
+    for (int i = 0; i < columnCount; ++i) {
+        if (sqlite3_column_type(stmt, i) == SQLITE_NULL) {
+            result.appendNull();
+            continue;
+        }
+        // column_text before column_bytes, so the length refers to the text conversion.
+        const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, i));
+        result.appendCell({text, static_cast<size_t>(sqlite3_column_bytes(stmt, i))});
+    }
+    return true;
 }
 
-void SQLiteDatabase::checkConnection() const {
+int SQLiteDatabase::executeOnWriter(const std::string& query, const std::vector<std::string>& params) {
+    int affectedRows;
+    try {
+        auto stmt = prepare(m_writer, query, params);
+        affectedRows = (sqlite3_step(stmt.get()) == SQLITE_DONE) ? sqlite3_changes(m_writer.db) : -1;
+        if (affectedRows < 0) {
+            Logger::getInstance().error("Query failed: ", query, " (", sqlite3_errmsg(m_writer.db), ")");
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().error(e.what());
+        affectedRows = -1;
+    }
+
+    // Track which thread opened a transaction so its reads stay on the writer until it ends.
+    if (sqlite3_get_autocommit(m_writer.db)) {
+        m_transactionOwner = std::thread::id();
+    } else if (m_transactionOwner.load() == std::thread::id()) {
+        m_transactionOwner = std::this_thread::get_id();
+    }
+    return affectedRows;
+}
+
+SQLiteDatabase::Connection* SQLiteDatabase::acquireReader() {
+    std::unique_lock lock(m_readerMutex);
+    // Open cursors hold readers until they are drained or destroyed, so a slow consumer must not stall reads forever
+    if (!m_readerAvailable.wait_for(lock, m_settings.readerAcquireTimeout,
+                                    [this] { return !m_idleReaders.empty() || !m_connected; })) {
+        throw std::runtime_error("Timed out after " + std::to_string(m_settings.readerAcquireTimeout.count()) +
+                                 " ms waiting for an SQLite reader connection.");
+    }
     if (!m_connected) {
         throw std::runtime_error("SQLiteDatabase is not connected.");
     }
-}
\ No newline at end of file
+    Connection* reader = m_idleReaders.back();
+    m_idleReaders.pop_back();
+    return reader;
+}
+
+void SQLiteDatabase::releaseReader(Connection* reader) {
+    {
+        std::lock_guard lock(m_readerMutex);
+        m_idleReaders.push_back(reader);
+    }
+    // notify_all: disconnect() may be waiting for every reader, not just for one.
+    m_readerAvailable.notify_all();
+}
+
+void SQLiteDatabase::checkpointLoop() {
+    std::unique_lock lock(m_checkpointMutex);
+    while (!m_checkpointWake.wait_for(lock, m_settings.checkpointInterval, [this] { return m_stopCheckpoint; })) {
+        lock.unlock();
+        {
+            std::lock_guard writeLock(m_writeMutex);
+            // A checkpoint inside an open transaction would only see its own snapshot; try next round.
+            if (m_writer.db && sqlite3_get_autocommit(m_writer.db)) {
+                int logFrames = 0;
+                int checkpointedFrames = 0;
+                int rc = sqlite3_wal_checkpoint_v2(m_writer.db, nullptr, SQLITE_CHECKPOINT_PASSIVE,
+                                                   &logFrames, &checkpointedFrames);
+                if (rc == SQLITE_OK) {
+                    Logger::getInstance().debug("WAL checkpoint: ", checkpointedFrames, "/", logFrames, " frames");
+                } else if (rc != SQLITE_BUSY) {
+                    Logger::getInstance().warn("WAL checkpoint failed: ", sqlite3_errmsg(m_writer.db));
+                }
+            }
+        }
+        lock.lock();
+    }
+}
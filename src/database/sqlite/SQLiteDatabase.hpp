@@ -1,48 +1,210 @@
 #pragma once
 
 #include "database/interfaces/IDatabase.hpp"
+#include "database/sqlite/SQLiteStatementCache.hpp"
+#include "database/BufferedResultSet.hpp"
+#include "utils/ThreadPool.hpp"
 #include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 
 /**
  * @class SQLiteDatabase
  * @brief Manages connections and interactions with an SQLite database.
+ *
+ * The database runs in WAL mode with one writer connection and a set of read-only connections.
+ * Statements that modify the database are serialized on the writer, while SELECTs are spread over
+ * the readers and run in parallel with each other and with the writer. Reads issued by a thread
+ * that has an open transaction stay on the writer so they see its uncommitted changes.
  */
 class SQLiteDatabase final : public IDatabase {
 public:
     /**
-     * @brief Constructs an SQLiteDatabase with the given database path.
+     * @brief Connection and WAL tuning.
+     */
+    struct Settings {
+        size_t statementCacheSize = 64;                      ///< Prepared statements kept per connection; 0 disables the cache.
+        size_t readConnections = 4;                          ///< Read-only connections; 0 sends every query to the writer.
+        std::chrono::milliseconds busyTimeout{5000};         ///< How long a connection waits on a locked database.
+        std::chrono::milliseconds readerAcquireTimeout{5000}; ///< How long a read waits for a free reader connection.
+        std::chrono::milliseconds checkpointInterval{30000}; ///< Period of the passive WAL checkpoint; 0 disables it.
+    };
+
+    /**
+     * @brief Statement cache counters summed over all connections.
+     */
+    using StatementCacheStats = SQLiteStatementCache::Stats;
+
+    /**
+     * @brief Constructs an SQLiteDatabase with the given database path and default settings.
      * @param dbPath Path to the SQLite database file.
      */
     explicit SQLiteDatabase(std::string dbPath);
 
     /**
-     * @brief Destructor that closes the database connection if open.
+     * @brief Constructs an SQLiteDatabase with the given database path.
+     * @param dbPath Path to the SQLite database file.
+     * @param settings Connection counts, busy timeout and checkpoint period.
+     */
+    SQLiteDatabase(std::string dbPath, const Settings& settings);
+
+    /**
+     * @brief Destructor that closes the database connections if open.
      */
     ~SQLiteDatabase() override;
 
     void connect() override;
     void disconnect() override;
     [[nodiscard]] bool isConnected() const override;
+    [[nodiscard]] SqlDialect dialect() const override { return SqlDialect::SQLite; }
 
     int executeQuery(const std::string& query) override;
     int executeQuery(const std::string& query, const std::vector<std::string>& params) override;
 
     std::vector<std::vector<std::string>> fetchQuery(const std::string& query) override;
     std::vector<std::vector<std::string>> fetchQuery(const std::string& query, const std::vector<std::string>& params) override;
+    std::unique_ptr<ResultSet> fetchResult(const std::string& query, const std::vector<std::string>& params) override;
 
     int getLastInsertId() override;
     int executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) override;
 
+    /**
+     * @brief Runs the statement on a dedicated I/O thread, one statement at a time in submission order.
+     *
+     * SQLite calls are blocking library calls, so a separate thread is what keeps them off the caller.
+     * Asynchronous statements never join the calling thread's transaction: a write waits for it to end.
+     */
+    void executeQueryAsync(const std::string& query, const std::vector<std::string>& params,
+                           ExecuteCallback onDone) override;
+    void fetchResultAsync(const std::string& query, const std::vector<std::string>& params,
+                          FetchCallback onDone) override;
+    using IDatabase::executeQueryAsync;
+    using IDatabase::fetchResultAsync;
+
+    /**
+     * @brief Begins a transaction on the writer; see SQLiteTransaction.
+     *
+     * The database must outlive the transaction.
+     *
+     * @throws std::runtime_error if the transaction cannot be started.
+     */
     std::shared_ptr<ITransaction> beginTransaction() override;
 
+    /**
+     * @brief Executes the statements on the writer inside a single transaction, so the batch costs one commit.
+     *
+     * SQLite rolls back only the failing statement, so the others still commit. When the calling thread
+     * already has a transaction open, the statements simply join it.
+     *
+     * @param statements Statements to execute, in order.
+     * @return Affected rows for each statement, or -1 for the ones that failed.
+     */
+    std::vector<int> executeBatch(const std::vector<BatchStatement>& statements) override;
+
+    /**
+     * @brief Inserts the rows on the writer with one cached INSERT statement, inside a single savepoint.
+     *
+     * The statement is prepared once and rebound for every row; the savepoint commits once at the end,
+     * or nests in the calling thread's open transaction. If any row fails, none of them is inserted.
+     *
+     * @return Rowid of each inserted row, in the order of `rows`.
+     * @throws std::invalid_argument if a row does not have one value per column.
+     * @throws std::runtime_error if the insert fails.
+     */
+    std::vector<int> insertRows(const std::string& table, const std::vector<std::string>& columns,
+                                const std::vector<std::vector<std::string>>& rows) override;
+
+    /**
+     * @brief Returns hit/miss counters of the prepared statement caches.
+     */
+    [[nodiscard]] StatementCacheStats getStatementCacheStats() const;
+
 private:
+    friend class SQLiteTransaction;
+
+    /**
+     * @brief One sqlite3 handle with its own statement cache.
+     */
+    struct Connection {
+        sqlite3* db = nullptr;
+        std::unique_ptr<SQLiteStatementCache> statements;
+    };
+
     void checkConnection() const;
 
+    /**
+     * @brief Opens a connection, applies busy timeout and pragmas.
+     * @throws std::runtime_error if the database cannot be opened.
+     */
+    Connection open(bool readOnly) const;
+    static void close(Connection& connection);
+
+    /**
+     * @brief Fetches a reset statement for the query from the connection's cache and binds the parameters.
+     * @throws std::runtime_error if the query cannot be prepared or a parameter cannot be bound.
+     */
+    static SQLiteStatementCache::Lease prepare(Connection& connection, const std::string& query, const std::vector<std::string>& params);
+
+    static std::vector<std::vector<std::string>> collectRows(sqlite3_stmt* stmt);
+    static std::unique_ptr<ResultSet> collectResult(sqlite3_stmt* stmt);
+    static void addColumns(sqlite3_stmt* stmt, BufferedResultSet& result);
+
+    /**
+     * @brief Steps the statement once and appends the row to `result`.
+     * @return False once the statement is done.
+     * @throws std::runtime_error if stepping fails.
+     */
+    static bool stepInto(sqlite3_stmt* stmt, BufferedResultSet& result);
+
+    /**
+     * @brief Prepares a read on a reader connection, or on the writer when the statement writes or the
+     * calling thread has an open transaction, and passes the bound statement to `consume`.
+     */
+    template <typename Consume>
+    auto runRead(const std::string& query, const std::vector<std::string>& params, Consume&& consume);
+
+    /**
+     * @brief Runs a statement on the writer. Caller must hold m_writeMutex.
+     */
+    int executeOnWriter(const std::string& query, const std::vector<std::string>& params);
+
+    /**
+     * @brief Takes an idle reader, waiting up to Settings::readerAcquireTimeout for one to be returned if all are busy.
+     * @throws std::runtime_error if none is returned in time or the database is disconnected.
+     */
+    Connection* acquireReader();
+    void releaseReader(Connection* reader);
+
+    /**
+     * @brief Loop of the background thread running passive WAL checkpoints.
+     */
+    void checkpointLoop();
+
     std::string m_dbPath;
-    sqlite3* m_db;
-    bool m_connected;
-    mutable std::mutex m_mutex;
-};
\ No newline at end of file
+    Settings m_settings;
+    std::atomic<bool> m_connected;
+
+    Connection m_writer;                                  ///< The only connection allowed to write.
+    mutable std::recursive_mutex m_writeMutex;            ///< Serializes use of m_writer; re-entered by a transaction's own thread.
+    std::atomic<std::thread::id> m_transactionOwner;      ///< Thread with an open transaction on the writer.
+
+    std::vector<Connection> m_readers;                    ///< Read-only connections.
+    std::atomic<bool> m_useReaders{false};                ///< Whether connect() opened any readers.
+    std::vector<Connection*> m_idleReaders;               ///< Readers not currently checked out.
+    mutable std::mutex m_readerMutex;                     ///< Guards m_idleReaders.
+    std::condition_variable m_readerAvailable;            ///< Signalled when a reader is returned.
+
+    std::unique_ptr<ThreadPool> m_asyncThread;            ///< Runs the asynchronous calls; exists while connected.
+
+    std::thread m_checkpointThread;
+    std::mutex m_checkpointMutex;
+    std::condition_variable m_checkpointWake;             ///< Wakes the checkpoint thread on shutdown.
+    bool m_stopCheckpoint = false;
+};
@@ -0,0 +1,84 @@
+#include "SQLiteStatementCache.hpp"
+
+SQLiteStatementCache::Lease& SQLiteStatementCache::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_stmt = std::exchange(other.m_stmt, nullptr);
+        m_owned = other.m_owned;
+    }
+    return *this;
+}
+
+SQLiteStatementCache::Lease::~Lease() {
+    release();
+}
+
+void SQLiteStatementCache::Lease::release() {
+    if (!m_stmt) {
+        return;
+    }
+    if (m_owned) {
+        sqlite3_finalize(m_stmt);
+    } else {
+        // Resetting ends the implicit read transaction of a stepped SELECT.
+        sqlite3_reset(m_stmt);
+        sqlite3_clear_bindings(m_stmt);
+    }
+    m_stmt = nullptr;
+}
+
+SQLiteStatementCache::SQLiteStatementCache(sqlite3* db, size_t capacity)
+    : m_db(db), m_capacity(capacity) {}
+
+SQLiteStatementCache::~SQLiteStatementCache() {
+    clear();
+}
+
+SQLiteStatementCache::Lease SQLiteStatementCache::acquire(const std::string& sql) {
+    if (auto it = m_index.find(sql); it != m_index.end()) {
+        ++m_hits;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return Lease(it->second->second, false);
+    }
+
+    ++m_misses;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v3(m_db, sql.c_str(), static_cast<int>(sql.size() + 1),
+                           m_capacity > 0 ? SQLITE_PREPARE_PERSISTENT : 0, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return {};
+    }
+    if (m_capacity == 0) {
+        return Lease(stmt, true);
+    }
+
+    if (m_entries.size() >= m_capacity) {
+        auto& oldest = m_entries.back();
+        sqlite3_finalize(oldest.second);
+        m_index.erase(oldest.first);
+        m_entries.pop_back();
+        ++m_evictions;
+    }
+    m_entries.emplace_front(sql, stmt);
+    m_index[sql] = m_entries.begin();
+    m_size = m_entries.size();
+    return Lease(stmt, false);
+}
+
+void SQLiteStatementCache::clear() {
+    for (auto& [sql, stmt] : m_entries) {
+        sqlite3_finalize(stmt);
+    }
+    m_entries.clear();
+    m_index.clear();
+    m_size = 0;
+}
+
+SQLiteStatementCache::Stats SQLiteStatementCache::stats() const {
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.size = m_size;
+    return stats;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @class SQLiteStatementCache
+ * @brief LRU cache of prepared sqlite3_stmt handles for a single connection, keyed by SQL text.
+ *
+ * Statements are handed out reset and with their bindings cleared, so callers only bind and step.
+ * The cache is not thread-safe; it must be guarded by whatever serializes access to its connection.
+ * Only stats() may be called concurrently with acquire().
+ */
+class SQLiteStatementCache {
+public:
+    /**
+     * @brief Hit/miss counters for the cache.
+     */
+    struct Stats {
+        uint64_t hits = 0;       ///< Lookups served by an already prepared statement.
+        uint64_t misses = 0;     ///< Lookups that had to compile the SQL.
+        uint64_t evictions = 0;  ///< Statements finalized to make room for newer ones.
+        size_t size = 0;         ///< Statements currently cached.
+    };
+
+    /**
+     * @brief RAII handle to a cached statement; resets it on release so read locks are dropped.
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        explicit Lease(sqlite3_stmt* stmt, bool owned) : m_stmt(stmt), m_owned(owned) {}
+        Lease(Lease&& other) noexcept
+            : m_stmt(std::exchange(other.m_stmt, nullptr)), m_owned(other.m_owned) {}
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        [[nodiscard]] sqlite3_stmt* get() const { return m_stmt; }
+        explicit operator bool() const { return m_stmt != nullptr; }
+
+    private:
+        void release();
+
+        sqlite3_stmt* m_stmt = nullptr;  ///< Statement being used.
+        bool m_owned = false;            ///< True if not cached and must be finalized on release.
+    };
+
+    /**
+     * @brief Creates a cache for the given connection.
+     * @param db Connection the statements are prepared on.
+     * @param capacity Maximum number of statements kept; 0 disables caching.
+     */
+    SQLiteStatementCache(sqlite3* db, size_t capacity);
+    ~SQLiteStatementCache();
+
+    SQLiteStatementCache(const SQLiteStatementCache&) = delete;
+    SQLiteStatementCache& operator=(const SQLiteStatementCache&) = delete;
+
+    /**
+     * @brief Returns a ready-to-bind statement for the SQL, preparing and caching it on a miss.
+     * @param sql SQL text, used verbatim as the cache key.
+     * @return Lease wrapping the statement, empty if the SQL fails to compile.
+     */
+    Lease acquire(const std::string& sql);
+
+    /**
+     * @brief Finalizes every cached statement. Must be called before closing the connection.
+     */
+    void clear();
+
+    [[nodiscard]] Stats stats() const;
+
+private:
+    using Entry = std::pair<std::string, sqlite3_stmt*>;
+
+    sqlite3* m_db;                                                        ///< Owning connection.
+    size_t m_capacity;                                                    ///< Maximum cached statements.
+    std::list<Entry> m_entries;                                           ///< Most recently used first.
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;  ///< SQL text to entry.
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_evictions{0};
+    std::atomic<size_t> m_size{0};
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "database/interfaces/ITransaction.hpp"
+#include "database/sqlite/SQLiteDatabase.hpp"
+#include "utils/Logger.hpp"
+#include <mutex>
+
+/**
+ * @class SQLiteTransaction
+ * @brief Transaction on the SQLite writer connection.
+ *
+ * SQLite has a single writer, so the transaction holds the write lock from BEGIN to COMMIT or ROLLBACK.
+ * Writes from other threads wait for it to end, while their reads keep going to the reader connections and
+ * see the last committed state. The owning thread may still call the SQLiteDatabase directly; those calls
+ * join the transaction. The transaction must be ended or destroyed on the thread that began it.
+ */
+class SQLiteTransaction final : public ITransaction {
+public:
+    /**
+     * @brief Takes the write lock and begins an IMMEDIATE transaction, reserving the database for writing.
+     * @throws std::runtime_error if the transaction cannot be started, e.g. one is already open.
+     */
+    explicit SQLiteTransaction(SQLiteDatabase& database) : m_database(database), m_lock(database.m_writeMutex) {
+        m_database.checkConnection();
+        if (m_database.executeOnWriter("BEGIN IMMEDIATE;", {}) < 0) {
+            throw std::runtime_error("Failed to begin SQLite transaction: " +
+                                     std::string(sqlite3_errmsg(m_database.m_writer.db)));
+        }
+    }
+
+    ~SQLiteTransaction() override {
+        if (m_lock.owns_lock()) {
+            try {
+                rollback();
+            } catch (const std::exception& e) {
+                Logger::getInstance().error("SQLite transaction rollback failed: " + std::string(e.what()));
+            }
+        }
+    }
+
+    int executeQuery(const std::string& query, const std::vector<std::string>& params) override {
+        checkActive();
+        return m_database.executeOnWriter(query, params);
+    }
+
+    std::unique_ptr<ResultSet> fetchResult(const std::string& query, const std::vector<std::string>& params) override {
+        checkActive();
+        auto stmt = SQLiteDatabase::prepare(m_database.m_writer, query, params);
+        return SQLiteDatabase::collectResult(stmt.get());
+    }
+
+    int executeInsertReturningId(const std::string& query, const std::vector<std::string>& params) override {
+        checkActive();
+        if (m_database.executeOnWriter(query, params) < 0) {
+            return -1;
+        }
+        return static_cast<int>(sqlite3_last_insert_rowid(m_database.m_writer.db));
+    }
+
+    void commit() override {
+        end("COMMIT;");
+    }
+
+    void rollback() override {
+        end("ROLLBACK;");
+    }
+
+private:
+    void checkActive() const {
+        if (!m_lock.owns_lock()) {
+            throw std::logic_error("SQLite transaction has already ended");
+        }
+    }
+
+    // The write lock is kept if the command fails (e.g. COMMIT on a busy database), so the transaction
+    // can still be rolled back.
+    void end(const char* command) {
+        checkActive();
+        if (m_database.executeOnWriter(command, {}) < 0) {
+            throw std::runtime_error(std::string(command) + " failed: " + sqlite3_errmsg(m_database.m_writer.db));
+        }
+        m_lock.unlock();
+    }
+
+    SQLiteDatabase& m_database;
+    std::unique_lock<std::recursive_mutex> m_lock;  ///< Write lock, held while the transaction is open.
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+/**
+ * @brief Connection pool counters of the job database.
+ */
+class DatabasePoolMetricsDto final : public oatpp::DTO {
+    DTO_INIT(DatabasePoolMetricsDto, DTO)
+
+    DTO_FIELD(UInt64, connections);
+    DTO_FIELD(UInt64, idleConnections);
+    DTO_FIELD(UInt64, connectionsInUse);
+    DTO_FIELD(UInt64, peakConnectionsInUse);
+    DTO_FIELD(UInt64, waiters);
+    DTO_FIELD(UInt64, acquires);
+    DTO_FIELD(UInt64, acquireTimeouts);
+    DTO_FIELD(UInt64, connectionsCreated);
+    DTO_FIELD(UInt64, connectionsEvicted);
+    DTO_FIELD(UInt64, connectionsDiscarded);
+    DTO_FIELD(Float64, averageWaitMicros);
+    DTO_FIELD(UInt64, maxWaitMicros);
+    DTO_FIELD(Float64, utilization);
+};
+
+#include OATPP_CODEGEN_END(DTO)
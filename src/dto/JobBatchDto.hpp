@@ -0,0 +1,27 @@
+#pragma once
+
+#include "dto/JobDto.hpp"
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+/**
+ * @brief Request body of POST /jobs:batch.
+ */
+class JobBatchRequestDto final : public oatpp::DTO {
+    DTO_INIT(JobBatchRequestDto, DTO)
+
+    DTO_FIELD(List<Object<JobDto>>, jobs);
+};
+
+/**
+ * @brief Response of POST /jobs:batch: the created jobs, in request order, with their IDs and status.
+ */
+class JobBatchResponseDto final : public oatpp::DTO {
+    DTO_INIT(JobBatchResponseDto, DTO)
+
+    DTO_FIELD(List<Object<JobDto>>, jobs);
+};
+
+#include OATPP_CODEGEN_END(DTO)
@@ -17,6 +17,12 @@ class JobDto final : public oatpp::DTO {
     DTO_FIELD(Enum<JobStatus>::AsString, status);  // Use AsString for JSON-friendly output
     // Optional field for options
     DTO_FIELD(oatpp::String, options);  // Adding 'options' field as expected by JobController
+    // Optional completion deadline, in seconds since the Unix epoch
+    DTO_FIELD(Int64, deadline);
+    // Optional encoding template the job was created from
+    DTO_FIELD(String, templateId);
+    // Creation time, in seconds since the Unix epoch; set by the server
+    DTO_FIELD(Int64, createdAt);
 };
 
 #include OATPP_CODEGEN_END(DTO)
\ No newline at end of file
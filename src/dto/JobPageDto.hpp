@@ -0,0 +1,20 @@
+#pragma once
+
+#include "dto/JobDto.hpp"
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+/**
+ * @brief One page of GET /jobs.
+ */
+class JobPageDto final : public oatpp::DTO {
+    DTO_INIT(JobPageDto, DTO)
+
+    DTO_FIELD(List<Object<JobDto>>, jobs);
+    // Value of after_id for the next page; null on the last page
+    DTO_FIELD(Int64, nextAfterId);
+};
+
+#include OATPP_CODEGEN_END(DTO)
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+/**
+ * @brief Request body of POST /metadata:batch.
+ */
+class MetadataBatchRequestDto final : public oatpp::DTO {
+    DTO_INIT(MetadataBatchRequestDto, DTO)
+
+    DTO_FIELD(List<String>, paths);
+};
+
+#include OATPP_CODEGEN_END(DTO)
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include OATPP_CODEGEN_BEGIN(DTO)
+
+/**
+ * @brief Scheduler counters reported by the JobProcessor.
+ */
+class SchedulerMetricsDto final : public oatpp::DTO {
+    DTO_INIT(SchedulerMetricsDto, DTO)
+
+    DTO_FIELD(UInt64, jobsAdmitted);
+    DTO_FIELD(UInt64, jobsRejected);
+    DTO_FIELD(UInt64, deadlinesMet);
+    DTO_FIELD(UInt64, deadlinesMissed);
+    DTO_FIELD(UInt64, queuedJobs);
+    DTO_FIELD(UInt64, fastLaneJobs);
+    DTO_FIELD(UInt64, fastLaneQueuedJobs);
+};
+
+#include OATPP_CODEGEN_END(DTO)
@@ -2,11 +2,14 @@
 #include "utils/Logger.hpp"
 #include "utils/ConfigManager.hpp"
 
+#include "utils/ProcessRunner.hpp"
+
+#include <chrono>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <sstream>
 #include <stdexcept>
-#include <cstdlib>
 #include <utils/logger/LoggerMacros.hpp>
 
 /**
@@ -17,35 +20,77 @@
  * @return true if encoding was successful, false otherwise.
  */
 bool FFmpegEncodingService::encode(const std::string& inputFilePath, const std::string& outputFilePath, const std::vector<std::string>& options) {
+    return encode(inputFilePath, outputFilePath, options, {});
+}
+
+/**
+ * Encodes a media file using FFmpeg, with options applied to the input.
+ * @param inputFilePath - the input file path to be encoded.
+ * @param outputFilePath - the output file path for the encoded file.
+ * @param options - a vector of additional FFmpeg options.
+ * @param inputOptions - options placed before -i, such as -ss for input seeking.
+ * @return true if encoding was successful, false otherwise.
+ */
+bool FFmpegEncodingService::encode(const std::string& inputFilePath, const std::string& outputFilePath, const std::vector<std::string>& options,
+                                   const std::vector<std::string>& inputOptions) {
     // Retrieve default options from configuration
     const auto defaultOptions = ConfigManager::getInstance().get<std::vector<std::string>>("ffmpeg.default_options");
 
-    // Construct the FFmpeg command
-    std::ostringstream command;
-    command << "ffmpeg -i " << "\"" << inputFilePath << "\" ";
-
-    // Append default options from configuration
-    for (const auto& option : defaultOptions) {
-        command << option << " ";
-    }
+    // Build the argument vector; ffmpeg is executed directly, so paths and options are never parsed by a shell.
+    // -nostdin keeps ffmpeg from reading interactive commands from the service's stdin.
+    std::vector<std::string> command = {"ffmpeg", "-nostdin"};
+    try {
+        // Input options must precede the input they apply to
+        appendArguments(command, inputOptions);
+        command.insert(command.end(), {"-i", inputFilePath});
 
-    // Append any additional options
-    for (const auto& option : options) {
-        command << option << " ";
+        // Append default options from configuration, then any additional options
+        appendArguments(command, defaultOptions);
+        appendArguments(command, options);
+    } catch (const std::invalid_argument& e) {
+        LOG_ERROR("Invalid FFmpeg options for file %s: %s", outputFilePath.c_str(), e.what());
+        return false;
     }
 
     // Specify the output file
-    command << "\"" << outputFilePath << "\"";
+    command.push_back(outputFilePath);
 
     // Log the command
-    LOG_INFO("Executing FFmpeg command: %s", command.str().c_str());
+    LOG_INFO("Executing FFmpeg command: %s", joinForLog(command).c_str());
 
-    // Execute the command
-    if (const int result = std::system(command.str().c_str()); result == 0) {
+    // Execute the command; ffmpeg only writes to stdout when the output is a pipe, which is not kept
+    ProcessRunner::Result result;
+    try {
+        result = ProcessRunner::run(command, std::chrono::steady_clock::time_point::max(), nullptr, [](std::string_view) {});
+    } catch (const std::runtime_error& e) {
+        LOG_ERROR("Failed to start FFmpeg for file %s: %s", outputFilePath.c_str(), e.what());
+        return false;
+    }
+    if (result.exitCode == 0) {
         LOG_INFO("Encoding completed successfully for file: %s", outputFilePath.c_str());
         return true;
     } else {
         LOG_ERROR("Encoding failed for file: %s", outputFilePath.c_str());
         return false;
     }
-}
\ No newline at end of file
+}
+
+void FFmpegEncodingService::appendArguments(std::vector<std::string>& command, const std::vector<std::string>& options) {
+    // Options may be whole command-line fragments such as "-vf \"scale=1280:-2\""; split them like a shell would
+    for (const auto& option : options) {
+        auto arguments = ProcessRunner::splitArguments(option);
+        command.insert(command.end(), std::make_move_iterator(arguments.begin()), std::make_move_iterator(arguments.end()));
+    }
+}
+
+std::string FFmpegEncodingService::joinForLog(const std::vector<std::string>& command) {
+    std::string line;
+    for (const auto& argument : command) {
+        if (!line.empty()) {
+            line += ' ';
+        }
+        const bool quote = argument.empty() || argument.find_first_of(" \t'\"") != std::string::npos;
+        line += quote ? "'" + argument + "'" : argument;
+    }
+    return line;
+}
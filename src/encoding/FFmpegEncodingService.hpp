@@ -18,4 +18,27 @@ public:
      * @return true if encoding was successful, false otherwise.
      */
     bool encode(const std::string& inputFilePath, const std::string& outputFilePath, const std::vector<std::string>& options) override;
+
+    /**
+     * Encodes a media file using FFmpeg, with additional options placed before the input.
+     * @param inputFilePath - The path to the input file to be encoded.
+     * @param outputFilePath - The path where the encoded output file should be saved.
+     * @param options - Additional options for FFmpeg (e.g., encoding settings).
+     * @param inputOptions - Options applying to the input, such as -ss for input seeking.
+     * @return true if encoding was successful, false otherwise.
+     */
+    bool encode(const std::string& inputFilePath, const std::string& outputFilePath, const std::vector<std::string>& options,
+                const std::vector<std::string>& inputOptions) override;
+
+private:
+    /**
+     * Splits option fragments into arguments and appends them to the command.
+     * @throws std::invalid_argument if an option has an unterminated quote.
+     */
+    static void appendArguments(std::vector<std::string>& command, const std::vector<std::string>& options);
+
+    /**
+     * Renders the argument vector as one line for logging, quoting arguments with spaces or quotes.
+     */
+    static std::string joinForLog(const std::vector<std::string>& command);
 };
\ No newline at end of file
@@ -1,22 +1,71 @@
 #include "JobProcessor.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include "SegmentResume.hpp"
+#include "scheduling/EdfJobQueue.hpp"
+#include "scheduling/FairShareJobQueue.hpp"
+#include "scheduling/FifoJobQueue.hpp"
+#include "utils/CpuAffinity.hpp"
 #include "utils/Logger.hpp"
 
-JobProcessor::JobProcessor(std::shared_ptr<IEncodingService> encodingService, std::shared_ptr<JobRepository> jobRepository)
+JobProcessor::JobProcessor(std::shared_ptr<IEncodingService> encodingService, std::shared_ptr<JobRepository> jobRepository,
+                           std::shared_ptr<JobStatusWriter> statusWriter, const Settings& settings,
+                           std::shared_ptr<MetadataMerger> metadataMerger)
     : m_encodingService(std::move(encodingService)),
       m_jobRepository(std::move(jobRepository)),
-      m_running(false) {}
+      m_statusWriter(std::move(statusWriter)),
+      m_settings(settings),
+      m_metadataMerger(std::move(metadataMerger)),
+      m_jobClassifier(settings.fastLaneMaxRuntime),
+      m_numaTopology(settings.numaAware ? NumaTopology::discover() : NumaTopology()),
+      m_running(false) {
+    m_mainLane.name = "main";
+    m_mainLane.workerCount = std::max<std::size_t>(1, m_settings.workerCount);
+    m_mainLane.queue = createLaneQueue(m_mainLane);
+
+    if (m_settings.fastLane) {
+        m_fastLane.name = "fast";
+        m_fastLane.workerCount = std::max<std::size_t>(1, m_settings.fastLaneWorkerCount);
+        m_fastLane.cpus = m_settings.fastLaneCpus;
+        m_fastLane.queue = createLaneQueue(m_fastLane);
+
+        // Keep regular encodes off the CPUs reserved for the fast lane
+        if (!m_fastLane.cpus.empty()) {
+            for (const int cpu : CpuAffinity::availableCpus()) {
+                if (std::find(m_fastLane.cpus.begin(), m_fastLane.cpus.end(), cpu) == m_fastLane.cpus.end()) {
+                    m_mainLane.cpus.push_back(cpu);
+                }
+            }
+            if (m_mainLane.cpus.empty()) {
+                Logger::getInstance().warn("Fast lane reserves every available CPU; main lane workers are left unpinned.");
+            }
+        }
+    }
+}
 
 JobProcessor::~JobProcessor() {
     stop();
 }
 
-void JobProcessor::addJob(const std::shared_ptr<Job>& job) {
+bool JobProcessor::addJob(const std::shared_ptr<Job>& job) {
+    job->setEstimatedRuntime(m_runtimeEstimator.estimate(*job));
+    Lane& lane = laneFor(*job);
     {
         std::lock_guard<std::mutex> lock(m_queueMutex);
-        m_jobQueue.push(job);
-        Logger::getInstance().info("Job added to queue with ID: " + std::to_string(job->getId()));
+        if (!lane.queue->push(job)) {
+            ++m_jobsRejected;
+            Logger::getInstance().warn("Job rejected, deadline cannot be met: ID " + std::to_string(job->getId()));
+            return false;
+        }
+        ++m_jobsAdmitted;
+        if (&lane == &m_fastLane) {
+            ++m_fastLaneJobs;
+        }
+        Logger::getInstance().info("Job added to " + lane.name + " queue with ID: " + std::to_string(job->getId()));
     }
-    m_condition.notify_one();  // Notify the processing thread
+    lane.condition.notify_one();  // Notify one of the lane's workers
+    return true;
 }
 
 void JobProcessor::start() {
@@ -26,8 +75,17 @@ void JobProcessor::start() {
     }
 
     m_running.store(true);
-    m_processingThread = std::thread(&JobProcessor::processJobs, this);
-    Logger::getInstance().info("JobProcessor started.");
+    for (Lane* lane : {&m_mainLane, &m_fastLane}) {
+        if (!lane->queue) {
+            continue;
+        }
+        lane->workers.reserve(lane->workerCount);
+        for (std::size_t i = 0; i < lane->workerCount; ++i) {
+            lane->workers.emplace_back(&JobProcessor::processJobs, this, std::ref(*lane), placeWorker(*lane, i));
+        }
+        Logger::getInstance().info("JobProcessor " + lane->name + " lane started with " +
+                                   std::to_string(lane->workerCount) + " worker(s).");
+    }
 }
 
 void JobProcessor::stop() {
@@ -40,45 +98,173 @@ void JobProcessor::stop() {
         std::lock_guard<std::mutex> lock(m_queueMutex);
         m_running.store(false);
     }
-    m_condition.notify_all();  // Wake up the processing thread to exit
 
-    if (m_processingThread.joinable()) {
-        m_processingThread.join();
+    for (Lane* lane : {&m_mainLane, &m_fastLane}) {
+        lane->condition.notify_all();  // Wake up the lane's workers to exit
+        for (auto& worker : lane->workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        lane->workers.clear();
     }
     Logger::getInstance().info("JobProcessor stopped.");
 }
 
-void JobProcessor::processJobs() {
+JobProcessor::Metrics JobProcessor::getMetrics() const {
+    Metrics metrics;
+    metrics.jobsAdmitted = m_jobsAdmitted.load();
+    metrics.jobsRejected = m_jobsRejected.load();
+    metrics.deadlinesMet = m_deadlinesMet.load();
+    metrics.deadlinesMissed = m_deadlinesMissed.load();
+    metrics.fastLaneJobs = m_fastLaneJobs.load();
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        metrics.fastLaneQueuedJobs = m_fastLane.queue ? m_fastLane.queue->size() : 0;
+        metrics.queuedJobs = m_mainLane.queue->size() + metrics.fastLaneQueuedJobs;
+    }
+    return metrics;
+}
+
+JobProcessor::SchedulingMode JobProcessor::schedulingModeFromString(const std::string& mode) {
+    if (mode == "edf") return SchedulingMode::EDF;
+    if (mode != "fifo") {
+        Logger::getInstance().warn("Unknown scheduling mode '" + mode + "', falling back to fifo.");
+    }
+    return SchedulingMode::FIFO;
+}
+
+JobProcessor::Settings JobProcessor::loadSettings(const ConfigManager& config) {
+    Settings settings;
+    settings.schedulingMode = schedulingModeFromString(config.get<std::string>("scheduler.mode", "fifo"));
+    settings.workerCount = config.get<std::size_t>("ffmpeg.max_processes", 1);
+    settings.fairShare = config.get<bool>("scheduler.fair_share.enabled", false);
+    settings.tenantWeights = config.get<std::unordered_map<std::string, double>>("scheduler.fair_share.tenant_weights", {});
+    settings.defaultTenantWeight = config.get<double>("scheduler.fair_share.default_weight", 1.0);
+    settings.fairShareQuantum = std::chrono::seconds(config.get<int>("scheduler.fair_share.quantum_seconds", 60));
+    settings.fastLane = config.get<bool>("scheduler.fast_lane.enabled", false);
+    settings.fastLaneWorkerCount = config.get<std::size_t>("scheduler.fast_lane.workers", 1);
+    settings.fastLaneMaxRuntime = std::chrono::seconds(config.get<int>("scheduler.fast_lane.max_runtime_seconds", 120));
+    settings.fastLaneCpus = config.get<std::vector<int>>("scheduler.fast_lane.cpus", {});
+    settings.numaAware = config.get<bool>("scheduler.numa_aware", true);
+    settings.maxRetries = config.get<int>("ffmpeg.max_retries", 0);
+    settings.retryDelay = std::chrono::seconds(config.get<int>("ffmpeg.retry_delay_seconds", 5));
+    return settings;
+}
+
+JobProcessor::WorkerPlacement JobProcessor::placeWorker(const Lane& lane, const std::size_t workerIndex) const {
+    if (!m_numaTopology.isMultiNode()) {
+        return {-1, lane.cpus};
+    }
+
+    // Nodes the lane may use, restricted to the lane's own CPUs when it has a reservation
+    std::vector<WorkerPlacement> candidates;
+    for (const auto& node : m_numaTopology.nodes()) {
+        WorkerPlacement placement{node.id, {}};
+        for (const int cpu : node.cpus) {
+            if (lane.cpus.empty() || std::find(lane.cpus.begin(), lane.cpus.end(), cpu) != lane.cpus.end()) {
+                placement.cpus.push_back(cpu);
+            }
+        }
+        if (!placement.cpus.empty()) {
+            candidates.push_back(std::move(placement));
+        }
+    }
+
+    if (candidates.empty()) {
+        return {-1, lane.cpus};
+    }
+    return candidates[workerIndex % candidates.size()];
+}
+
+std::unique_ptr<IJobQueue> JobProcessor::createLaneQueue(const Lane& lane) const {
+    if (m_settings.fairShare) {
+        return std::make_unique<FairShareJobQueue>([this, &lane] { return createQueue(lane); },
+                                                   m_settings.tenantWeights,
+                                                   m_settings.defaultTenantWeight,
+                                                   m_settings.fairShareQuantum);
+    }
+    return createQueue(lane);
+}
+
+std::unique_ptr<IJobQueue> JobProcessor::createQueue(const Lane& lane) const {
+    if (m_settings.schedulingMode == SchedulingMode::EDF) {
+        // Admission runs inside addJob, which already holds m_queueMutex
+        return std::make_unique<EdfJobQueue>(lane.workerCount, [&lane] { return remainingWork(lane); });
+    }
+    return std::make_unique<FifoJobQueue>();
+}
+
+std::chrono::duration<double> JobProcessor::remainingWork(const Lane& lane) {
+    const auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> remaining{0};
+    for (const auto& [jobId, expectedFinish] : lane.running) {
+        if (expectedFinish > now) {
+            remaining += expectedFinish - now;
+        }
+    }
+    return remaining;
+}
+
+JobProcessor::Lane& JobProcessor::laneFor(const Job& job) {
+    if (m_fastLane.queue && m_jobClassifier.classify(job, m_runtimeEstimator.isCalibrated(job)) == JobClassifier::CostClass::LIGHT) {
+        return m_fastLane;
+    }
+    return m_mainLane;
+}
+
+void JobProcessor::processJobs(Lane& lane, const WorkerPlacement& placement) {
+    CpuAffinity::pinCurrentThread(placement.cpus);
+    if (placement.numaNode >= 0) {
+        NumaTopology::preferNodeMemory(placement.numaNode);
+        Logger::getInstance().info("JobProcessor " + lane.name + " lane worker placed on NUMA node " +
+                                   std::to_string(placement.numaNode));
+    }
+
     while (m_running.load()) {
         std::unique_lock<std::mutex> lock(m_queueMutex);
 
         // Wait until there is a job in the queue or until stop() is called
-        m_condition.wait(lock, [this] { return !m_jobQueue.empty() || !m_running.load(); });
+        lane.condition.wait(lock, [this, &lane] { return !lane.queue->empty() || !m_running.load(); });
 
         // Exit if stop() was called
         if (!m_running.load()) break;
 
-        if (!m_jobQueue.empty()) {
-            auto job = m_jobQueue.front();
-            m_jobQueue.pop();
+        if (auto job = lane.queue->pop()) {
+            lane.running[job->getId()] = std::chrono::steady_clock::now() + job->getEstimatedRuntime();
             lock.unlock();  // Unlock the queue while processing the job
 
             processJob(job);
+
+            lock.lock();
+            lane.running.erase(job->getId());
         }
     }
 }
 
-void JobProcessor::processJob(const std::shared_ptr<Job>& job) const {
-    // Update job status to "IN_PROGRESS" in the repository
-    bool success = m_jobRepository->updateJobStatus(job->getId(), JobStatusUtils::toString(JobStatus::IN_PROGRESS));
+void JobProcessor::processJob(const std::shared_ptr<Job>& job) {
+    // A job whose deadline has already passed cannot meet its SLA; don't spend encoder time on it
+    if (job->hasDeadline() && std::chrono::system_clock::now() > *job->getDeadline()) {
+        ++m_deadlinesMissed;
+        m_statusWriter->updateJobStatus(job->getId(), JobStatus::FAILED, "Deadline expired before the job was dispatched");
+        Logger::getInstance().warn("Job deadline expired in queue: ID " + std::to_string(job->getId()));
+        return;
+    }
+
+    // Update job status to "IN_PROGRESS"; the writer coalesces it with the final status if the encode is quick
+    m_statusWriter->updateJobStatus(job->getId(), JobStatus::IN_PROGRESS);
     Logger::getInstance().info("Processing job ID: " + std::to_string(job->getId()));
 
     // Perform the encoding task using the encoding service
-    success = m_encodingService->encode(job->getInputFile(), job->getOutputFile(), job->getOptions());
+    const auto startedAt = std::chrono::steady_clock::now();
+    const bool success = encodeWithRetries(*job);
+    if (success && job->getAttemptCount() == 0) {
+        m_runtimeEstimator.record(*job, std::chrono::steady_clock::now() - startedAt);
+    }
+    recordDeadlineOutcome(*job, success);
 
-    // Update job status based on the encoding result
-    const JobStatus newStatus = success ? JobStatus::COMPLETED : JobStatus::FAILED;
-    success = m_jobRepository->updateJobStatus(job->getId(), JobStatusUtils::toString(newStatus));
+    // Update job status based on the encoding result; terminal statuses are written without waiting for the interval
+    m_statusWriter->updateJobStatus(job->getId(), success ? JobStatus::COMPLETED : JobStatus::FAILED);
 
     // Log the outcome
     if (success) {
@@ -87,3 +273,73 @@ void JobProcessor::processJob(const std::shared_ptr<Job>& job) const {
         Logger::getInstance().error("Job failed: ID " + std::to_string(job->getId()));
     }
 }
+
+bool JobProcessor::encodeWithRetries(Job& job) {
+    const bool resumable = SegmentResume::isResumable(job.getOptions());
+    if (!resumable && SegmentResume::isSegmented(job.getOptions())) {
+        Logger::getInstance().info("Job " + std::to_string(job.getId()) +
+                                   " sets its own -segment_list; failed attempts restart from the beginning");
+    }
+    std::optional<KeyframeIndex> keyframes;
+
+    while (true) {
+        bool success;
+        if (resumable) {
+            // Resumed attempts seek the input; the keyframe index makes that seek land exactly on a segment boundary
+            if (!job.getCheckpoint().empty() && !keyframes && m_metadataMerger) {
+                try {
+                    keyframes = m_metadataMerger->getKeyframeIndex(job.getInputFile());
+                } catch (const std::exception& e) {
+                    Logger::getInstance().warn("No keyframe index for job " + std::to_string(job.getId()) + ": " + e.what());
+                    keyframes = KeyframeIndex();
+                }
+            }
+            const auto plan = SegmentResume::planAttempt(job, keyframes ? &*keyframes : nullptr);
+            success = m_encodingService->encode(job.getInputFile(), job.getOutputFile(), plan.outputOptions, plan.inputOptions);
+
+            if (!success) {
+                // Checkpoint what this attempt finished so the retry (or a later recovery) skips it
+                if (const auto checkpoint = SegmentResume::advanceCheckpoint(job.getCheckpoint(), plan.segmentListPath);
+                    checkpoint.completedSegments != job.getCheckpoint().completedSegments) {
+                    job.setCheckpoint(checkpoint);
+                    (void) m_jobRepository->updateJobCheckpoint(job.getId(), checkpoint.serialize());
+                    Logger::getInstance().info("Job " + std::to_string(job.getId()) + " checkpointed at segment " +
+                                               std::to_string(checkpoint.completedSegments));
+                }
+            }
+        } else {
+            success = m_encodingService->encode(job.getInputFile(), job.getOutputFile(), job.getOptions());
+        }
+
+        if (success) {
+            if (resumable) {
+                // The per-attempt segment lists are only needed to resume
+                for (int attempt = 0; attempt <= job.getAttemptCount(); ++attempt) {
+                    std::error_code ec;
+                    std::filesystem::remove(SegmentResume::segmentListPath(job, attempt), ec);
+                }
+            }
+            return true;
+        }
+
+        if (job.getAttemptCount() >= m_settings.maxRetries) {
+            return false;
+        }
+        job.incrementAttemptCount();
+        Logger::getInstance().warn("Retrying job ID " + std::to_string(job.getId()) + " (attempt " +
+                                   std::to_string(job.getAttemptCount() + 1) + ")");
+        std::this_thread::sleep_for(m_settings.retryDelay);
+    }
+}
+
+void JobProcessor::recordDeadlineOutcome(const Job& job, const bool success) {
+    if (!job.hasDeadline()) {
+        return;
+    }
+    if (success && std::chrono::system_clock::now() <= *job.getDeadline()) {
+        ++m_deadlinesMet;
+    } else {
+        ++m_deadlinesMissed;
+        Logger::getInstance().warn("Job missed its deadline: ID " + std::to_string(job.getId()));
+    }
+}
@@ -1,69 +1,247 @@
 #pragma once
 
-#include <queue>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 #include <condition_variable>
 #include "interfaces/IEncodingService.hpp"
+#include "interfaces/IJobQueue.hpp"
+#include "metadata/MetadataMerger.hpp"
 #include "models/Job.hpp"
 #include "repositories/JobRepository.hpp"
+#include "repositories/JobStatusWriter.hpp"
+#include "scheduling/JobClassifier.hpp"
+#include "scheduling/RuntimeEstimator.hpp"
+#include "utils/ConfigManager.hpp"
+#include "utils/NumaTopology.hpp"
 
 /**
  * @class JobProcessor
- * @brief Manages the processing of encoding jobs in a background thread.
+ * @brief Manages the processing of encoding jobs on a pool of background worker threads.
  *
  * The JobProcessor class maintains a queue of jobs to be processed and uses an encoding service
- * to perform encoding tasks. Job states are updated in the JobRepository.
+ * to perform encoding tasks. Job states are recorded through a JobStatusWriter, so workers never wait
+ * on the database to report progress; checkpoints go straight to the JobRepository. With fair-share
+ * enabled, each tenant gets its own sub-queue and workers are fed by weighted deficit round-robin.
+ *
+ * Jobs are split into two lanes, each with its own queue and workers: the main lane for regular
+ * encodes and, when enabled, a fast lane for cheap jobs (audio-only, remux, thumbnails, or short
+ * estimated runtime) so they never wait behind long video encodes. The fast lane can reserve
+ * CPUs, in which case the main lane is kept off them.
+ *
+ * On multi-socket hosts each worker is assigned to a NUMA node, round-robin within its lane, and
+ * pinned to that node's CPUs and memory; the ffmpeg processes it spawns inherit the placement.
  */
 class JobProcessor {
 public:
+    /**
+     * @brief Order in which queued jobs are dispatched.
+     */
+    enum class SchedulingMode {
+        FIFO,  ///< Submission order; every job is admitted.
+        EDF    ///< Earliest deadline first, rejecting jobs whose deadline cannot be met.
+    };
+
+    /**
+     * @brief Scheduling and worker pool configuration.
+     */
+    struct Settings {
+        SchedulingMode schedulingMode = SchedulingMode::FIFO;        ///< Order within a queue (or within each tenant).
+        std::size_t workerCount = 1;                                 ///< Number of jobs encoded concurrently.
+        bool fairShare = false;                                      ///< Whether to split the queue per tenant.
+        std::unordered_map<std::string, double> tenantWeights;       ///< Fair-share weight per tenant.
+        double defaultTenantWeight = 1.0;                            ///< Weight for tenants not listed in tenantWeights.
+        std::chrono::seconds fairShareQuantum{60};                   ///< Encoder time granted per unit of weight per round.
+        bool fastLane = false;                                       ///< Whether cheap jobs get their own worker pool.
+        std::size_t fastLaneWorkerCount = 1;                         ///< Number of fast lane workers.
+        std::chrono::seconds fastLaneMaxRuntime{120};                ///< Measured runtime estimate under which a job is cheap.
+        std::vector<int> fastLaneCpus;                               ///< CPUs reserved for the fast lane; empty for no reservation.
+        bool numaAware = true;                                       ///< Whether to pin workers to NUMA nodes on multi-node hosts.
+        int maxRetries = 0;                                          ///< Extra attempts after a failed encode.
+        std::chrono::seconds retryDelay{5};                          ///< Pause before each retry.
+    };
+
+    /**
+     * @brief Snapshot of the scheduler counters.
+     */
+    struct Metrics {
+        std::uint64_t jobsAdmitted = 0;        ///< Jobs accepted into the queue.
+        std::uint64_t jobsRejected = 0;        ///< Jobs refused at admission because their deadline cannot be met.
+        std::uint64_t deadlinesMet = 0;        ///< Jobs with a deadline that completed in time.
+        std::uint64_t deadlinesMissed = 0;     ///< Jobs with a deadline that completed late, failed, or expired in the queue.
+        std::uint64_t queuedJobs = 0;          ///< Jobs currently waiting for dispatch, across both lanes.
+        std::uint64_t fastLaneJobs = 0;        ///< Jobs routed to the fast lane.
+        std::uint64_t fastLaneQueuedJobs = 0;  ///< Jobs currently waiting in the fast lane.
+    };
+
     /**
      * @brief Constructs a JobProcessor with the specified encoding service and job repository.
      *
      * @param encodingService A shared pointer to an encoding service used to process jobs.
-     * @param jobRepository A shared pointer to the job repository used to manage job states.
+     * @param jobRepository A shared pointer to the job repository used to store checkpoints.
+     * @param statusWriter Write-behind buffer the job status changes are recorded in.
+     * @param settings Scheduling and worker pool configuration.
+     * @param metadataMerger Source of input keyframe indexes used to plan resumed attempts; may be null.
      */
-    JobProcessor(std::shared_ptr<IEncodingService> encodingService, std::shared_ptr<JobRepository> jobRepository);
+    JobProcessor(std::shared_ptr<IEncodingService> encodingService, std::shared_ptr<JobRepository> jobRepository,
+                 std::shared_ptr<JobStatusWriter> statusWriter, const Settings& settings, std::shared_ptr<MetadataMerger> metadataMerger = nullptr);
 
     /**
-     * @brief Destructor that stops the job processing thread if it's running.
+     * @brief Destructor that stops the worker threads if they are running.
      */
     ~JobProcessor();
 
     /**
      * @brief Adds a new job to the processing queue.
      *
+     * The job's runtime is estimated and the job is routed to the fast or main lane before it is
+     * offered to that lane's queue. In EDF mode a job whose deadline cannot be met given the
+     * lane's backlog, including the remaining work of the jobs its workers are running, is rejected.
+     *
      * @param job A shared pointer to the job to add to the queue.
+     * @return true if the job was queued; false if it was rejected.
      */
-    void addJob(const std::shared_ptr<Job>& job);
+    bool addJob(const std::shared_ptr<Job>& job);
 
     /**
-     * @brief Starts the job processing in a background thread.
+     * @brief Starts the job processing on the worker threads.
      */
     void start();
 
     /**
-     * @brief Stops the job processing, blocking until the background thread exits.
+     * @brief Stops the job processing, blocking until every worker thread exits.
      */
     void stop();
 
+    /**
+     * @brief Returns the current scheduler counters.
+     */
+    [[nodiscard]] Metrics getMetrics() const;
+
+    /**
+     * @brief Parses a scheduling mode name ("fifo" or "edf").
+     *
+     * @param mode The mode name, case-sensitive.
+     * @return The matching SchedulingMode, FIFO for unknown names.
+     */
+    static SchedulingMode schedulingModeFromString(const std::string& mode);
+
+    /**
+     * @brief Reads the processor settings from the "scheduler" and "ffmpeg" configuration sections.
+     *
+     * @param config Reference to the ConfigManager instance.
+     * @return The resulting Settings, with defaults for missing keys.
+     */
+    static Settings loadSettings(const ConfigManager& config);
+
 private:
     /**
-     * @brief Continuously processes jobs from the queue until stopped.
+     * @brief A queue together with the workers that drain it.
+     */
+    struct Lane {
+        std::string name;                       ///< Lane name used in logs.
+        std::size_t workerCount = 1;            ///< Number of worker threads.
+        std::vector<int> cpus;                  ///< CPUs the workers are pinned to; empty for no pinning.
+        std::unique_ptr<IJobQueue> queue;       ///< Jobs waiting for this lane. Guarded by m_queueMutex.
+        std::unordered_map<int, std::chrono::steady_clock::time_point> running;  ///< Expected finish per running job ID. Guarded by m_queueMutex.
+        std::condition_variable condition;      ///< Signals the lane's workers.
+        std::vector<std::thread> workers;       ///< The lane's worker threads.
+    };
+
+    /**
+     * @brief CPUs and NUMA node a worker thread runs on.
      */
-    void processJobs();
+    struct WorkerPlacement {
+        int numaNode = -1;       ///< Node whose memory is preferred; -1 for no memory policy.
+        std::vector<int> cpus;   ///< CPUs the worker is pinned to; empty for no pinning.
+    };
+
+    /**
+     * @brief Computes where a lane's worker runs, spreading the lane's workers across NUMA nodes.
+     *
+     * @param lane The worker's lane.
+     * @param workerIndex Index of the worker within the lane.
+     */
+    [[nodiscard]] WorkerPlacement placeWorker(const Lane& lane, std::size_t workerIndex) const;
+
+    /**
+     * @brief Creates the lane's queue, wrapped in per-tenant fair-share if enabled.
+     * @param lane The lane whose workers and running jobs EDF admission accounts for.
+     */
+    [[nodiscard]] std::unique_ptr<IJobQueue> createLaneQueue(const Lane& lane) const;
+
+    /**
+     * @brief Creates an empty queue ordered by the configured scheduling mode.
+     * @param lane The lane whose workers and running jobs EDF admission accounts for.
+     */
+    [[nodiscard]] std::unique_ptr<IJobQueue> createQueue(const Lane& lane) const;
+
+    /**
+     * @brief Estimated work left on the lane's running jobs; a job past its estimate counts as done.
+     *
+     * The caller must hold m_queueMutex.
+     */
+    [[nodiscard]] static std::chrono::duration<double> remainingWork(const Lane& lane);
+
+    /**
+     * @brief Selects the lane a job is dispatched on.
+     */
+    [[nodiscard]] Lane& laneFor(const Job& job);
+
+    /**
+     * @brief Continuously processes jobs from a lane's queue until stopped. Run by every worker thread.
+     *
+     * @param lane The lane whose queue the worker drains.
+     * @param placement CPUs and NUMA node the worker is bound to before it starts.
+     */
+    void processJobs(Lane& lane, const WorkerPlacement& placement);
 
     /**
      * @brief Processes a single job, updating its status based on encoding success or failure.
      *
      * @param job A shared pointer to the job to process.
      */
-    void processJob(const std::shared_ptr<Job>& job) const;
+    void processJob(const std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Runs the encode, retrying failed attempts up to the configured limit.
+     *
+     * Segmented jobs record their completed segments after a failed attempt, both on the job and
+     * in the repository, and the next attempt resumes from the last completed segment.
+     *
+     * @param job The job to encode.
+     * @return true if an attempt succeeded.
+     */
+    bool encodeWithRetries(Job& job);
+
+    /**
+     * @brief Records whether a job with a deadline completed in time.
+     *
+     * @param job The finished job.
+     * @param success Whether the encode succeeded.
+     */
+    void recordDeadlineOutcome(const Job& job, bool success);
 
     std::shared_ptr<IEncodingService> m_encodingService;  ///< Encoding service for processing jobs.
-    std::shared_ptr<JobRepository> m_jobRepository;       ///< Job repository for managing job states.
-    std::queue<std::shared_ptr<Job>> m_jobQueue;          ///< Queue of jobs to be processed.
-    std::mutex m_queueMutex;                              ///< Mutex for synchronizing access to the job queue.
-    std::condition_variable m_condition;                  ///< Condition variable for signaling the processing thread.
-    std::thread m_processingThread;                       ///< Thread for processing jobs in the background.
+    std::shared_ptr<JobRepository> m_jobRepository;       ///< Job repository for storing checkpoints.
+    std::shared_ptr<JobStatusWriter> m_statusWriter;      ///< Buffered writer for job status changes.
+    Settings m_settings;                                  ///< Scheduling and worker pool configuration.
+    std::shared_ptr<MetadataMerger> m_metadataMerger;     ///< Keyframe indexes for planning resumed attempts.
+    Lane m_mainLane;                                      ///< Lane for regular encodes.
+    Lane m_fastLane;                                      ///< Lane for cheap jobs; unused unless enabled.
+    RuntimeEstimator m_runtimeEstimator;                  ///< Runtime model used for admission, EDF, fair-share and lane routing.
+    JobClassifier m_jobClassifier;                        ///< Decides which jobs are cheap enough for the fast lane.
+    NumaTopology m_numaTopology;                          ///< Host NUMA layout used for worker placement.
+    mutable std::mutex m_queueMutex;                      ///< Mutex for synchronizing access to both lane queues.
     std::atomic<bool> m_running;                          ///< Flag to control the processing thread.
-};
\ No newline at end of file
+
+    std::atomic<std::uint64_t> m_jobsAdmitted{0};         ///< Counter behind Metrics::jobsAdmitted.
+    std::atomic<std::uint64_t> m_jobsRejected{0};         ///< Counter behind Metrics::jobsRejected.
+    std::atomic<std::uint64_t> m_deadlinesMet{0};         ///< Counter behind Metrics::deadlinesMet.
+    std::atomic<std::uint64_t> m_deadlinesMissed{0};      ///< Counter behind Metrics::deadlinesMissed.
+    std::atomic<std::uint64_t> m_fastLaneJobs{0};         ///< Counter behind Metrics::fastLaneJobs.
+};
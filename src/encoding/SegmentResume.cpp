@@ -0,0 +1,131 @@
+#include "SegmentResume.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include "utils/ProcessRunner.hpp"
+
+namespace SegmentResume {
+
+namespace {
+    // Options may arrive as whole command-line fragments; split them into individual arguments
+    std::vector<std::string> tokenize(const std::vector<std::string>& options) {
+        std::vector<std::string> tokens;
+        for (const auto& option : options) {
+            auto arguments = ProcessRunner::splitArguments(option);
+            tokens.insert(tokens.end(), std::make_move_iterator(arguments.begin()), std::make_move_iterator(arguments.end()));
+        }
+        return tokens;
+    }
+
+    bool hasSegmentMuxer(const std::vector<std::string>& tokens) {
+        for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+            if (tokens[i] == "-f" && tokens[i + 1] == "segment") {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string formatSeconds(const double seconds) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.6f", seconds);
+        return buffer;
+    }
+
+    // Segment boundaries are keyframes, so a resume offset should sit on one up to list rounding
+    constexpr double kKeyframeSnapToleranceSeconds = 0.5;
+
+    double snapToKeyframe(const double offset, const KeyframeIndex* keyframes) {
+        if (!keyframes) {
+            return offset;
+        }
+        const auto keyframe = keyframes->keyframeAtOrBefore(offset + 0.001);
+        return keyframe && offset - *keyframe < kKeyframeSnapToleranceSeconds ? *keyframe : offset;
+    }
+}
+
+bool isSegmented(const std::vector<std::string>& options) {
+    try {
+        return hasSegmentMuxer(tokenize(options));
+    } catch (const std::invalid_argument&) {
+        return false;  // Unbalanced quotes; the encode itself reports them
+    }
+}
+
+bool isResumable(const std::vector<std::string>& options) {
+    try {
+        const auto tokens = tokenize(options);
+        return hasSegmentMuxer(tokens) && std::find(tokens.begin(), tokens.end(), "-segment_list") == tokens.end();
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+}
+
+std::string segmentListPath(const Job& job, const int attempt) {
+    const auto outputDir = std::filesystem::path(job.getOutputFile()).parent_path();
+    return (outputDir / ("job_" + std::to_string(job.getId()) + ".segments." + std::to_string(attempt) + ".csv")).string();
+}
+
+AttemptPlan planAttempt(const Job& job, const KeyframeIndex* keyframes) {
+    AttemptPlan plan;
+    plan.segmentListPath = segmentListPath(job, job.getAttemptCount());
+
+    plan.outputOptions = tokenize(job.getOptions());
+    plan.outputOptions.insert(plan.outputOptions.end(), {"-segment_list", plan.segmentListPath, "-segment_list_type", "csv"});
+
+    if (const auto& checkpoint = job.getCheckpoint(); !checkpoint.empty()) {
+        const auto offset = formatSeconds(snapToKeyframe(checkpoint.resumeOffsetSeconds, keyframes));
+        plan.inputOptions = {"-ss", offset};
+        plan.outputOptions.insert(plan.outputOptions.end(), {
+            "-segment_start_number", std::to_string(checkpoint.completedSegments),
+            "-output_ts_offset", offset
+        });
+    }
+    return plan;
+}
+
+SegmentCheckpoint advanceCheckpoint(const SegmentCheckpoint& previous, const std::string& segmentListPath) {
+    std::ifstream list(segmentListPath);
+    if (!list) {
+        return previous;
+    }
+
+    int segments = 0;
+    double firstStart = 0.0;
+    double lastEnd = 0.0;
+    std::string line;
+    while (std::getline(list, line)) {
+        // Each line is "filename,start,end"; the filename may itself contain commas
+        const auto endComma = line.rfind(',');
+        const auto startComma = endComma == std::string::npos ? std::string::npos : line.rfind(',', endComma - 1);
+        if (startComma == std::string::npos) {
+            continue;
+        }
+        try {
+            const double start = std::stod(line.substr(startComma + 1, endComma - startComma - 1));
+            const double end = std::stod(line.substr(endComma + 1));
+            if (segments == 0) {
+                firstStart = start;
+            }
+            lastEnd = end;
+            ++segments;
+        } catch (const std::exception&) {
+            // Partially written line from an interrupted attempt
+        }
+    }
+
+    if (segments == 0) {
+        return previous;
+    }
+
+    // Use the span covered by this attempt so the result does not depend on whether list times include the offset
+    SegmentCheckpoint next;
+    next.completedSegments = previous.completedSegments + segments;
+    next.resumeOffsetSeconds = previous.resumeOffsetSeconds + (lastEnd - firstStart);
+    return next;
+}
+
+} // namespace SegmentResume
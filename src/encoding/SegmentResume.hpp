@@ -0,0 +1,65 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "metadata/KeyframeIndex.hpp"
+#include "models/Job.hpp"
+
+/**
+ * @brief Checkpoint and resume support for encodes written with ffmpeg's segment muxer.
+ *
+ * Every attempt of a segmented job writes its own CSV segment list ("name,start,end" per finished
+ * segment), which ffmpeg appends to as each segment is closed. After a failure the lists tell how
+ * many segments are complete and where the last one ended, and the retry seeks the input to that
+ * point, continues the segment numbering and shifts output timestamps so the segments line up.
+ * A job that names its own -segment_list (e.g. an HLS playlist) is not resumable: ffmpeg takes a
+ * single list, and replacing the job's would silently drop its playlist.
+ */
+namespace SegmentResume {
+
+ /**
+  * @brief Ffmpeg arguments for one attempt of a segmented job.
+  */
+ struct AttemptPlan {
+  std::vector<std::string> inputOptions;   ///< Placed before -i (input seeking).
+  std::vector<std::string> outputOptions;  ///< The job options, split into arguments, plus segment list and numbering arguments.
+  std::string segmentListPath;             ///< CSV list this attempt writes.
+ };
+
+ /**
+  * @brief Checks whether the options select the segment muxer (-f segment).
+  */
+ bool isSegmented(const std::vector<std::string>& options);
+
+ /**
+  * @brief Checks whether a job with these options can be checkpointed and resumed: it is segmented
+  * and does not set its own -segment_list. Options that cannot be split into arguments are not.
+  */
+ bool isResumable(const std::vector<std::string>& options);
+
+ /**
+  * @brief Path of the CSV segment list written by one attempt of a job, next to the job's output.
+  * @param job The segmented job.
+  * @param attempt Zero-based attempt number.
+  */
+ std::string segmentListPath(const Job& job, int attempt);
+
+ /**
+  * @brief Builds the arguments for the job's next attempt, resuming from its checkpoint.
+  * @param job A resumable job; see isResumable.
+  * @param keyframes Optional keyframe index of the input; when given, the resume offset is snapped
+  *                  to the keyframe it was derived from, undoing rounding in the segment lists.
+  * @return The attempt's input options, output options and segment list path.
+  */
+ AttemptPlan planAttempt(const Job& job, const KeyframeIndex* keyframes = nullptr);
+
+ /**
+  * @brief Adds the segments finished by an attempt to the job's previous checkpoint.
+  * @param previous Checkpoint the attempt resumed from.
+  * @param segmentListPath CSV list written by the attempt.
+  * @return The updated checkpoint; unchanged if the attempt finished no segment.
+  */
+ SegmentCheckpoint advanceCheckpoint(const SegmentCheckpoint& previous, const std::string& segmentListPath);
+
+} // namespace SegmentResume
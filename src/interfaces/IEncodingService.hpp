@@ -7,4 +7,10 @@ public:
     virtual ~IEncodingService() = default;
 
     virtual bool encode(const std::string& inputFilePath, const std::string& outputFilePath, const std::vector<std::string>& options) = 0;
+
+    // Encodes with options applied to the input (e.g. -ss for input seeking); services without input options only accept an empty list
+    virtual bool encode(const std::string& inputFilePath, const std::string& outputFilePath, const std::vector<std::string>& options,
+                        const std::vector<std::string>& inputOptions) {
+        return inputOptions.empty() && encode(inputFilePath, outputFilePath, options);
+    }
 };
\ No newline at end of file
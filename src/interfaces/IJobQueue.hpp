@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include "models/Job.hpp"
+
+/**
+ * Ordering policy for jobs waiting to be dispatched by the JobProcessor.
+ * Implementations are not thread-safe; the JobProcessor serializes access with its queue mutex.
+ */
+class IJobQueue {
+public:
+    virtual ~IJobQueue() = default;
+
+    /**
+     * Offers a job to the queue.
+     * @return false if the queue's admission policy rejected the job.
+     */
+    virtual bool push(const std::shared_ptr<Job>& job) = 0;
+
+    /**
+     * Removes the next job to dispatch.
+     * @return The next job, or nullptr if the queue is empty.
+     */
+    virtual std::shared_ptr<Job> pop() = 0;
+
+    [[nodiscard]] virtual bool empty() const = 0;
+    [[nodiscard]] virtual std::size_t size() const = 0;
+};
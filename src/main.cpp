@@ -4,6 +4,7 @@
 #include "app/PluginManager.hpp"
 #include "utils/logger/LoggerMacros.hpp"
 #include "utils/logger/FileLogSink.hpp"
+#include <curl/curl.h>
 #include <iostream>
 
 #include "absl/log/initialize.h"
@@ -33,6 +34,12 @@ int main(int argc, const char * argv[]) {
     // Initialize Oat++ Environment
     oatpp::base::Environment::init();
 
+    // libcurl's global state is not thread-safe to set up, so do it before any probe thread starts
+    if (curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK) {
+        std::cerr << "Failed to initialize libcurl" << std::endl;
+        return 1;
+    }
+
     // Initialize logging to file
     const auto fileSink = std::make_unique<FileLogSink>("app.log");
     absl::AddLogSink(fileSink.get());
@@ -47,6 +54,8 @@ int main(int argc, const char * argv[]) {
     LOG_INFO("objectsCount = %d",oatpp::base::Environment::getObjectsCount());
     LOG_INFO("objectsCreated = %d",oatpp::base::Environment::getObjectsCreated());
 
+    curl_global_cleanup();
+
     // Destroy Oat++ Environment
     oatpp::base::Environment::destroy();
 
@@ -1,19 +1,34 @@
 #include "JobManager.hpp"
+#include "utils/ConfigManager.hpp"
 #include "utils/Logger.hpp"
 
+#include <algorithm>
+
 JobManager::JobManager(const std::shared_ptr<JobRepository>& jobRepository,
                        const std::shared_ptr<IEncodingService>& encodingService,
                        const std::shared_ptr<JobProcessor>& jobProcessor)
     : m_jobRepository(jobRepository),
       m_encodingService(encodingService),
-      m_jobProcessor(jobProcessor) {}
+      m_jobProcessor(jobProcessor),
+      m_maxPageSize(std::max<size_t>(1, ConfigManager::getInstance().get<size_t>("jobs.max_page_size", 1000))),
+      m_maxBatchSize(ConfigManager::getInstance().get<size_t>("jobs.batch.max_items", 10000)) {}
 
-oatpp::Int32 JobManager::createJob(const std::string& inputFile, const std::string& outputFile, const std::string& options) const {
-    if (int jobId = m_jobRepository->createJob(inputFile, outputFile, options, "PENDING"); jobId != -1) {
+oatpp::Int32 JobManager::createJob(const std::string& inputFile, const std::string& outputFile, const std::string& options,
+                                   const std::optional<std::chrono::system_clock::time_point>& deadline,
+                                   const std::string& tenant, const std::string& templateId) const {
+    if (int jobId = m_jobRepository->createJob(inputFile, outputFile, options, "PENDING", templateId, deadline); jobId != -1) {
         Logger::getInstance().info("Job created with ID: " + std::to_string(jobId));
 
         // Convert options to a vector and create the Job instance
-        m_jobProcessor->addJob(std::make_shared<Job>(jobId, inputFile, outputFile, std::vector<std::string>{options}));
+        const auto job = std::make_shared<Job>(jobId, inputFile, outputFile, std::vector<std::string>{options});
+        job->setDeadline(deadline);
+        job->setTenant(tenant);
+
+        if (!m_jobProcessor->addJob(job)) {
+            const std::string reason = "Rejected: deadline cannot be met with the current backlog";
+            (void) m_jobRepository->updateJobStatus(jobId, JobStatusUtils::toString(JobStatus::FAILED), reason);
+            throw JobRejectedException("Job " + std::to_string(jobId) + " " + reason);
+        }
 
         return jobId;
     } else {
@@ -22,6 +37,88 @@ oatpp::Int32 JobManager::createJob(const std::string& inputFile, const std::stri
     }
 }
 
+std::vector<std::shared_ptr<JobDto>> JobManager::createJobs(const std::vector<JobSubmission>& submissions,
+                                                            const std::string& tenant) const {
+    if (submissions.empty()) {
+        throw std::invalid_argument("No jobs to create");
+    }
+    if (submissions.size() > m_maxBatchSize) {
+        throw std::invalid_argument("Batch of " + std::to_string(submissions.size()) + " jobs exceeds the limit of " +
+                                    std::to_string(m_maxBatchSize));
+    }
+
+    std::vector<NewJob> jobs;
+    jobs.reserve(submissions.size());
+    for (const auto& submission : submissions) {
+        jobs.push_back(submission.job);
+    }
+    const auto jobIds = m_jobRepository->createJobs(jobs, "PENDING");
+    Logger::getInstance().info("Created " + std::to_string(jobIds.size()) + " jobs in one batch");
+
+    std::vector<std::shared_ptr<JobDto>> jobDtos;
+    jobDtos.reserve(jobIds.size());
+    std::vector<int> rejected;
+    for (size_t i = 0; i < jobIds.size(); ++i) {
+        const auto& submission = submissions[i];
+        const auto job = std::make_shared<Job>(jobIds[i], submission.job.inputFile, submission.job.outputFile,
+                                               std::vector<std::string>{submission.job.options});
+        job->setDeadline(submission.job.deadline);
+        job->setTenant(tenant);
+
+        auto jobDto = JobDto::createShared();
+        jobDto->id = jobIds[i];
+        jobDto->inputFile = submission.job.inputFile;
+        jobDto->outputFile = submission.job.outputFile;
+        jobDto->status = JobStatus::PENDING;
+        if (!m_jobProcessor->addJob(job)) {
+            rejected.push_back(jobIds[i]);
+            jobDto->status = JobStatus::FAILED;
+        }
+        jobDtos.push_back(jobDto.getPtr());
+    }
+
+    // Rejected jobs are never picked up by a worker, so they can all be marked in one transaction.
+    if (!rejected.empty()) {
+        const std::string reason = "Rejected: deadline cannot be met with the current backlog";
+        if (!m_jobRepository->updateJobStatuses(rejected, JobStatusUtils::toString(JobStatus::FAILED), reason)) {
+            Logger::getInstance().error("Failed to mark " + std::to_string(rejected.size()) + " rejected jobs as FAILED");
+        }
+    }
+    return jobDtos;
+}
+
+size_t JobManager::recoverJobs() const {
+    size_t queued = 0;
+    std::vector<int> rejected;
+    for (const auto& unfinished : m_jobRepository->getUnfinishedJobs()) {
+        const auto job = std::make_shared<Job>(unfinished.id, unfinished.inputFile, unfinished.outputFile,
+                                               std::vector<std::string>{unfinished.options});
+        job->setDeadline(unfinished.deadline);
+        if (!unfinished.checkpoint.empty()) {
+            if (const auto checkpoint = SegmentCheckpoint::parse(unfinished.checkpoint)) {
+                job->setCheckpoint(*checkpoint);
+            } else {
+                Logger::getInstance().warn("Ignoring unreadable checkpoint of job " + std::to_string(unfinished.id));
+            }
+        }
+
+        if (m_jobProcessor->addJob(job)) {
+            ++queued;
+        } else {
+            rejected.push_back(unfinished.id);
+        }
+    }
+
+    if (!rejected.empty() &&
+        !m_jobRepository->updateJobStatuses(rejected, JobStatusUtils::toString(JobStatus::FAILED), "Rejected on recovery")) {
+        Logger::getInstance().error("Failed to mark " + std::to_string(rejected.size()) + " unrecoverable jobs as FAILED");
+    }
+    if (queued > 0) {
+        Logger::getInstance().info("Recovered " + std::to_string(queued) + " unfinished jobs");
+    }
+    return queued;
+}
+
 std::shared_ptr<JobDto> JobManager::getJob(int jobId) const {
     if (const auto job = m_jobRepository->getJobById(jobId)) {
         auto jobDto = JobDto::createShared();
@@ -51,10 +148,30 @@ std::vector<std::shared_ptr<JobDto>> JobManager::getAllJobs() const {
     return jobDtos;
 }
 
+JobPage JobManager::listJobs(JobPageRequest request) const {
+    request.limit = std::min(request.limit, m_maxPageSize);
+    return m_jobRepository->getJobPage(request);
+}
+
+std::unique_ptr<JobRepository::PageCursor> JobManager::exportJobs(const std::string& status) const {
+    JobPageRequest request;
+    request.status = status;
+    request.limit = m_maxPageSize;
+    return std::make_unique<JobRepository::PageCursor>(m_jobRepository, std::move(request));
+}
+
 bool JobManager::updateJobStatus(const int jobId, const JobStatus status, const std::string& message) const {
     return m_jobRepository->updateJobStatus(jobId, JobStatusUtils::toString(status), message);
 }
 
 bool JobManager::deleteJob(const int jobId) const {
     return m_jobRepository->deleteJob(jobId);
+}
+
+JobProcessor::Metrics JobManager::getSchedulerMetrics() const {
+    return m_jobProcessor->getMetrics();
+}
+
+std::optional<ConnectionPoolMetrics> JobManager::getDatabasePoolMetrics() const {
+    return m_jobRepository->getPoolMetrics();
 }
\ No newline at end of file
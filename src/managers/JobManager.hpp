@@ -1,6 +1,9 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <vector>
 #include "dto/JobDto.hpp"
 #include "encoding/JobProcessor.hpp"
@@ -8,6 +11,21 @@
 #include "repositories//JobRepository.hpp"
 #include "oatpp/core/Types.hpp"
 
+/**
+ * @brief Thrown when the JobProcessor refuses to queue a job, e.g. because its deadline cannot be met.
+ */
+class JobRejectedException final : public std::runtime_error {
+public:
+    explicit JobRejectedException(const std::string& message) : std::runtime_error(message) {}
+};
+
+/**
+ * @brief One job of a batch submitted through JobManager::createJobs.
+ */
+struct JobSubmission {
+    NewJob job;  ///< Fields stored in the repository, including the optional deadline.
+};
+
 /**
  * @class JobManager
  * @brief Manages job creation, retrieval, and updates, coordinating between JobRepository, JobProcessor, and encoding service.
@@ -29,10 +47,42 @@ public:
      * @param inputFile The input file path for the job.
      * @param outputFile The output file path for the job.
      * @param options Additional options for job processing.
+     * @param deadline Optional time by which the job must complete.
+     * @param tenant Tenant name used for fair-share scheduling, as resolved by TenantResolver.
+     * @param templateId ID of the encoding template the job was created from, if any.
      * @return The ID assigned to the created job.
+     * @throws JobRejectedException if the job was stored but refused by the processor; it is marked FAILED.
      * @throws std::runtime_error if the job cannot be created.
      */
-    [[nodiscard]] oatpp::Int32 createJob(const std::string& inputFile, const std::string& outputFile, const std::string& options) const;
+    [[nodiscard]] oatpp::Int32 createJob(const std::string& inputFile, const std::string& outputFile, const std::string& options,
+                                         const std::optional<std::chrono::system_clock::time_point>& deadline = std::nullopt,
+                                         const std::string& tenant = "", const std::string& templateId = "") const;
+
+    /**
+     * @brief Creates many jobs with a single bulk insert, then queues each of them for processing.
+     *
+     * Jobs the processor refuses are marked FAILED instead of failing the whole batch.
+     *
+     * @param submissions Jobs to create; at most `jobs.batch.max_items`.
+     * @param tenant Tenant name used for fair-share scheduling, as resolved by TenantResolver.
+     * @return One JobDto per submission, in order, with its ID and PENDING or FAILED status.
+     * @throws std::invalid_argument if the batch is empty or too large.
+     * @throws std::runtime_error if the jobs cannot be created; none is then.
+     */
+    [[nodiscard]] std::vector<std::shared_ptr<JobDto>> createJobs(const std::vector<JobSubmission>& submissions,
+                                                                  const std::string& tenant = "") const;
+
+    /**
+     * @brief Queues again the jobs left PENDING or IN_PROGRESS by a previous run of the service.
+     *
+     * Segmented jobs resume from their stored checkpoint, skipping the segments already written.
+     * Jobs keep the deadline they were submitted with, so EDF admission may refuse a job whose
+     * deadline passed while the service was down; refused jobs are marked FAILED. Tenants are not
+     * stored, so recovered jobs are queued without one.
+     *
+     * @return The number of jobs queued.
+     */
+    size_t recoverJobs() const;
 
     /**
      * @brief Retrieves a specific job by ID.
@@ -48,6 +98,25 @@ public:
      */
     [[nodiscard]] std::vector<std::shared_ptr<JobDto>> getAllJobs() const;
 
+    /**
+     * @brief Retrieves one page of jobs, filtered and projected as requested.
+     * @param request Filters, position and projection of the page; the limit is capped at `jobs.max_page_size`.
+     * @return The jobs of the page and the position of the next one.
+     * @throws std::invalid_argument if the request names an unknown field or has a zero limit.
+     */
+    [[nodiscard]] JobPage listJobs(JobPageRequest request) const;
+
+    /**
+     * @brief Opens a cursor over every job, for exporting the job table without loading it into memory.
+     *
+     * Jobs are read in keyset pages of `jobs.max_page_size`, so no database connection is held while
+     * the caller works through a page.
+     *
+     * @param status Optional filter for job status.
+     * @return A cursor yielding one JobDto at a time, in ID order.
+     */
+    [[nodiscard]] std::unique_ptr<JobRepository::PageCursor> exportJobs(const std::string& status = "") const;
+
     /**
      * @brief Updates the status and message for a specified job.
      * @param jobId The ID of the job to update.
@@ -64,8 +133,22 @@ public:
      */
     [[nodiscard]] bool deleteJob(int jobId) const;
 
+    /**
+     * @brief Retrieves the scheduler counters of the job processor.
+     * @return A snapshot of the JobProcessor metrics.
+     */
+    [[nodiscard]] JobProcessor::Metrics getSchedulerMetrics() const;
+
+    /**
+     * @brief Retrieves the connection pool counters of the job database.
+     * @return The counters, or std::nullopt if the database backend has no connection pool.
+     */
+    [[nodiscard]] std::optional<ConnectionPoolMetrics> getDatabasePoolMetrics() const;
+
 private:
     std::shared_ptr<JobRepository> m_jobRepository;           ///< Job repository for managing job data.
     std::shared_ptr<IEncodingService> m_encodingService;      ///< Encoding service for processing jobs.
     std::shared_ptr<JobProcessor> m_jobProcessor;             ///< Processor for managing background job execution.
+    size_t m_maxPageSize;                                     ///< Upper bound on the limit of a job listing page.
+    size_t m_maxBatchSize;                                    ///< Largest batch accepted by createJobs.
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+
+/**
+ * @class MetadataBatch
+ * @brief Results of one batch probe, handed from the probing threads to the HTTP response stream.
+ *
+ * Each result is a single NDJSON line. Lines become available in completion order, not request order,
+ * so the response makes progress as soon as any file is probed.
+ */
+class MetadataBatch {
+public:
+    /**
+     * @param expected Number of results the batch will produce.
+     */
+    explicit MetadataBatch(std::size_t expected) : m_remaining(expected) {}
+
+    /**
+     * @brief Adds a finished result line. Called by the probing threads.
+     */
+    void publish(std::string line) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lines.push_back(std::move(line) + "\n");
+            --m_remaining;
+        }
+        m_condition.notify_one();
+    }
+
+    /**
+     * @brief Accounts for an item that was skipped without producing a result.
+     */
+    void skip() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_remaining;
+        }
+        m_condition.notify_one();
+    }
+
+    /**
+     * @brief Blocks until the next result line is available.
+     * @return The line, or std::nullopt once every result has been returned.
+     */
+    std::optional<std::string> next() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return !m_lines.empty() || m_remaining == 0; });
+        if (m_lines.empty()) {
+            return std::nullopt;
+        }
+        std::string line = std::move(m_lines.front());
+        m_lines.pop_front();
+        return line;
+    }
+
+    /**
+     * @brief Marks the batch as abandoned (e.g. the client went away); items not yet started are skipped.
+     */
+    void cancel() { m_cancelled = true; }
+
+    [[nodiscard]] bool isCancelled() const { return m_cancelled; }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::string> m_lines;
+    std::size_t m_remaining;
+    std::atomic<bool> m_cancelled{false};
+};
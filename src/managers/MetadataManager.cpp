@@ -0,0 +1,54 @@
+#include "MetadataManager.hpp"
+
+#include <json/json.h>
+#include "validation/ValidationUtils.hpp"
+
+MetadataManager::MetadataManager(std::shared_ptr<MetadataMerger> metadataMerger, const std::size_t threadCount,
+                                 const std::size_t maxBatchSize, Validation::InputAllowList allowList)
+    : m_metadataMerger(std::move(metadataMerger)),
+      m_maxBatchSize(maxBatchSize),
+      m_allowList(std::move(allowList)),
+      m_threadPool(threadCount) {}
+
+std::shared_ptr<MetadataBatch> MetadataManager::probeBatch(const std::vector<std::string>& paths) {
+    if (paths.empty()) {
+        throw InvalidBatchException("No paths to probe");
+    }
+    if (paths.size() > m_maxBatchSize) {
+        throw InvalidBatchException("Batch of " + std::to_string(paths.size()) + " paths exceeds the limit of " +
+                                    std::to_string(m_maxBatchSize));
+    }
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        try {
+            m_allowList.check(paths[i]);
+        } catch (const Validation::ValidationException& e) {
+            throw InvalidBatchException("paths[" + std::to_string(i) + "]: " + e.what());
+        }
+    }
+
+    auto batch = std::make_shared<MetadataBatch>(paths.size());
+    for (const auto& path : paths) {
+        m_threadPool.submit([this, batch, path] {
+            if (batch->isCancelled()) {
+                batch->skip();
+                return;
+            }
+            batch->publish(probe(path));
+        });
+    }
+    return batch;
+}
+
+std::string MetadataManager::probe(const std::string& path) const {
+    Json::Value result(Json::objectValue);
+    result["path"] = path;
+    try {
+        result["metadata"] = m_metadataMerger->getMergedMetadata(path).toJson();
+    } catch (const std::exception& e) {
+        result["error"] = e.what();
+    }
+
+    Json::StreamWriterBuilder writerBuilder;
+    writerBuilder["indentation"] = "";
+    return Json::writeString(writerBuilder, result);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "MetadataBatch.hpp"
+#include "metadata/MetadataMerger.hpp"
+#include "utils/ThreadPool.hpp"
+#include "validation/InputAllowList.hpp"
+
+/**
+ * @brief Thrown when a batch request is empty, exceeds the configured item limit or names a disallowed input.
+ */
+class InvalidBatchException final : public std::runtime_error {
+public:
+    explicit InvalidBatchException(const std::string& message) : std::runtime_error(message) {}
+};
+
+/**
+ * @class MetadataManager
+ * @brief Probes media metadata through MetadataMerger on a dedicated, bounded thread pool.
+ *
+ * Batch probes run their items in parallel, so a batch takes about as long as its slowest file
+ * rather than the sum of all of them, while the pool size caps the number of concurrent probes.
+ */
+class MetadataManager {
+public:
+    /**
+     * @brief Constructs a MetadataManager.
+     * @param metadataMerger Merger used for every probe.
+     * @param threadCount Number of probing threads.
+     * @param maxBatchSize Largest accepted number of paths per batch.
+     * @param allowList Inputs a batch may name.
+     */
+    MetadataManager(std::shared_ptr<MetadataMerger> metadataMerger, std::size_t threadCount, std::size_t maxBatchSize,
+                    Validation::InputAllowList allowList);
+
+    /**
+     * @brief Queues every path for probing and returns immediately.
+     * @param paths Files to probe.
+     * @return The batch whose result lines become available as probes finish.
+     * @throws InvalidBatchException if the batch is empty, larger than the configured limit, or has a path
+     *         outside the allow-list; nothing is probed then.
+     */
+    [[nodiscard]] std::shared_ptr<MetadataBatch> probeBatch(const std::vector<std::string>& paths);
+
+private:
+    /**
+     * @brief Probes one file and formats its NDJSON result line.
+     */
+    [[nodiscard]] std::string probe(const std::string& path) const;
+
+    std::shared_ptr<MetadataMerger> m_metadataMerger;
+    std::size_t m_maxBatchSize;
+    Validation::InputAllowList m_allowList;
+    ThreadPool m_threadPool;
+};
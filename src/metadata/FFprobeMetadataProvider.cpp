@@ -1,8 +1,16 @@
 #include "FFprobeMetadataProvider.hpp"
+#include "utils/ProcessRunner.hpp"
 
-Json::Value FFprobeMetadataProvider::getMetadata(const std::string& filePath) {
-    std::string command = "ffprobe -v quiet -print_format json -show_format -show_streams \"" + filePath + "\"";
-    std::string result = runCommand(command);
+MediaInfo FFprobeMetadataProvider::getMetadata(const std::string& filePath) {
+    return getMetadata(filePath, std::chrono::steady_clock::time_point::max(), nullptr);
+}
+
+MediaInfo FFprobeMetadataProvider::getMetadata(const std::string& filePath,
+                                               const std::chrono::steady_clock::time_point deadline,
+                                               const std::atomic<bool>* cancelled) {
+    const std::vector<std::string> command = {"ffprobe", "-v", "quiet", "-print_format", "json",
+                                              "-show_format", "-show_streams", filePath};
+    std::string result = runCommand(command, deadline, cancelled);
 
     Json::Value metadata;
     Json::CharReaderBuilder readerBuilder;
@@ -12,32 +20,21 @@ Json::Value FFprobeMetadataProvider::getMetadata(const std::string& filePath) {
         handleError("FFprobe JSON parsing failed: " + errs);
     }
 
-    return metadata;
+    return MediaInfo::fromFfprobeJson(metadata);
 }
 
-std::string FFprobeMetadataProvider::runCommand(const std::string& command) {
-    std::string result;
+std::string FFprobeMetadataProvider::runCommand(const std::vector<std::string>& command,
+                                                const std::chrono::steady_clock::time_point deadline,
+                                                const std::atomic<bool>* cancelled) {
+    // Run ffprobe without a shell, in its own process group so it can be killed if it hangs
+    const auto result = ProcessRunner::run(command, deadline, cancelled);
 
-    // Open the pipe using popen and wrap it with unique_ptr for automatic closure
-    const std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(command.c_str(), "r"), pclose);
-    if (!pipe) {
-        handleError("Failed to run FFprobe command");
-        return result;  // Return an empty result if the command fails
+    if (result.timedOut) {
+        handleError("FFprobe timed out");
     }
-
-    // Read output from the command
-    while (true) {
-        // Define buffer within the loop to avoid any potential memory escape warnings
-        char buffer[128];
-
-        // Read data from the pipe into the buffer
-        if (fgets(buffer, sizeof(buffer), pipe.get()) == nullptr) {
-            break;  // Stop reading if no more data
-        }
-
-        // Append buffer content to the result
-        result += buffer;
+    if (result.cancelled) {
+        handleError("FFprobe was cancelled");
     }
 
-    return result;  // Return the accumulated result
-}
\ No newline at end of file
+    return result.output;  // Return the accumulated output
+}
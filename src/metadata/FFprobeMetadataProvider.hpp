@@ -8,6 +8,7 @@
 #include <stdexcept>
 #include <sstream>
 #include <string>
+#include <vector>
 
 /**
  * FFprobeMetadataProvider uses FFprobe to retrieve metadata for a media file.
@@ -18,19 +19,35 @@ public:
     /**
      * Retrieves metadata for the specified file using FFprobe.
      * @param filePath The path to the media file.
-     * @return JSON representation of the metadata.
+     * @return The probed metadata.
      * @throws std::runtime_error if FFprobe fails or JSON parsing fails.
      */
-    Json::Value getMetadata(const std::string& filePath) override;
+    MediaInfo getMetadata(const std::string& filePath) override;
+
+    /**
+     * Retrieves metadata for the specified file using FFprobe, killing the probe if it runs too long.
+     * @param filePath The path to the media file.
+     * @param deadline Point in time after which the probe is abandoned.
+     * @param cancelled Optional flag that abandons the probe when raised.
+     * @return The probed metadata.
+     * @throws std::runtime_error if FFprobe fails, times out, is cancelled or JSON parsing fails.
+     */
+    MediaInfo getMetadata(const std::string& filePath,
+                          std::chrono::steady_clock::time_point deadline,
+                          const std::atomic<bool>* cancelled) override;
 
 private:
     /**
-     * Executes the FFprobe command and returns the raw JSON output as a string.
-     * @param command The FFprobe command to execute.
+     * Executes FFprobe and returns the raw JSON output as a string.
+     * @param command FFprobe's argument vector, program name first.
+     * @param deadline Point in time after which the command is killed.
+     * @param cancelled Optional flag that kills the command when raised.
      * @return The raw JSON string output from FFprobe.
-     * @throws std::runtime_error if the command execution fails.
+     * @throws std::runtime_error if the command execution fails, times out or is cancelled.
      */
-    static std::string runCommand(const std::string& command);
+    static std::string runCommand(const std::vector<std::string>& command,
+                                  std::chrono::steady_clock::time_point deadline,
+                                  const std::atomic<bool>* cancelled);
 
     /**
      * Helper function to handle errors during FFprobe execution.
@@ -0,0 +1,119 @@
+#include "HeaderProbe.hpp"
+#include "Mp4HeaderParser.hpp"
+
+#include <stdexcept>
+
+#ifdef HAVE_LIBAVFORMAT
+#include "LibavformatMetadataProvider.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavutil/mem.h>
+}
+
+namespace {
+
+    constexpr int kAvioBufferSize = 32 * 1024;
+
+    struct AvioState {
+        RangeReader* reader;
+        std::uint64_t position = 0;
+        bool budgetExceeded = false;
+    };
+
+    int readPacket(void* opaque, std::uint8_t* buffer, const int size) {
+        auto* state = static_cast<AvioState*>(opaque);
+        try {
+            const std::string data = state->reader->read(state->position, static_cast<std::uint64_t>(size));
+            if (data.empty()) {
+                return AVERROR_EOF;
+            }
+            std::memcpy(buffer, data.data(), data.size());
+            state->position += data.size();
+            return static_cast<int>(data.size());
+        } catch (const ByteBudgetExceeded&) {
+            state->budgetExceeded = true;
+            return AVERROR(EIO);
+        } catch (const std::exception&) {
+            return AVERROR(EIO);
+        }
+    }
+
+    std::int64_t seekPacket(void* opaque, const std::int64_t offset, const int whence) {
+        auto* state = static_cast<AvioState*>(opaque);
+        const auto size = static_cast<std::int64_t>(state->reader->size());
+        std::int64_t target;
+        switch (whence & ~AVSEEK_FORCE) {
+            case AVSEEK_SIZE: return size;
+            case SEEK_SET: target = offset; break;
+            case SEEK_CUR: target = static_cast<std::int64_t>(state->position) + offset; break;
+            case SEEK_END: target = size + offset; break;
+            default: return AVERROR(EINVAL);
+        }
+        if (target < 0) {
+            return AVERROR(EINVAL);
+        }
+        state->position = static_cast<std::uint64_t>(target);
+        return target;
+    }
+
+    MediaInfo probeWithLibavformat(RangeReader& reader) {
+        AvioState state{&reader};
+
+        auto* buffer = static_cast<unsigned char*>(av_malloc(kAvioBufferSize));
+        AVIOContext* avio = buffer ? avio_alloc_context(buffer, kAvioBufferSize, 0, &state, readPacket, nullptr, seekPacket) : nullptr;
+        if (!avio) {
+            av_free(buffer);
+            throw std::runtime_error("Failed to allocate libavformat I/O context");
+        }
+        const auto freeAvio = [](AVIOContext* context) {
+            av_freep(&context->buffer);
+            avio_context_free(&context);
+        };
+        const std::unique_ptr<AVIOContext, decltype(freeAvio)> avioGuard(avio, freeAvio);
+
+        AVFormatContext* context = avformat_alloc_context();
+        if (!context) {
+            throw std::runtime_error("Failed to allocate libavformat context");
+        }
+        context->pb = avio;
+        context->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+        // Keep stream analysis well inside the budget; the rest is left for header seeks
+        AVDictionary* options = nullptr;
+        av_dict_set_int(&options, "probesize", 32 * 1024, 0);
+        av_dict_set_int(&options, "analyzeduration", 0, 0);
+        const int openResult = avformat_open_input(&context, nullptr, nullptr, &options);
+        av_dict_free(&options);
+        if (openResult < 0) {
+            if (state.budgetExceeded) {
+                throw ByteBudgetExceeded("Container header does not fit in the probe budget");
+            }
+            throw std::runtime_error("libavformat could not open the remote header");
+        }
+        const std::unique_ptr<AVFormatContext*, void (*)(AVFormatContext**)> contextGuard(&context, avformat_close_input);
+
+        if (avformat_find_stream_info(context, nullptr) < 0 && state.budgetExceeded) {
+            throw ByteBudgetExceeded("Stream parameters do not fit in the probe budget");
+        }
+        return LibavformatMetadataProvider::toMediaInfo(context);
+    }
+
+} // namespace
+
+#endif // HAVE_LIBAVFORMAT
+
+MediaInfo HeaderProbe::probe(RangeReader& reader) {
+    if (Mp4HeaderParser::isMp4(reader.read(0, 16))) {
+        return Mp4HeaderParser::parse(reader);
+    }
+#ifdef HAVE_LIBAVFORMAT
+    return probeWithLibavformat(reader);
+#else
+    throw std::runtime_error("Header-only probing of this container needs libavformat");
+#endif
+}
@@ -0,0 +1,26 @@
+#ifndef HEADER_PROBE_HPP
+#define HEADER_PROBE_HPP
+
+#include "MediaInfo.hpp"
+#include "RangeReader.hpp"
+
+/**
+ * HeaderProbe reads metadata from a remote object's container header alone, through ranged reads.
+ * MP4/MOV files are handled by Mp4HeaderParser (header boxes and moov only). Other containers are
+ * opened by libavformat over the RangeReader when the build has it (HAVE_LIBAVFORMAT), which reads
+ * e.g. the Matroska segment info and tracks; otherwise they are rejected so the caller can fall back
+ * to a full probe.
+ */
+class HeaderProbe {
+public:
+    /**
+     * Probes the object behind the reader.
+     * @param reader Reader over the object; its byte budget bounds the probe's I/O.
+     * @return The metadata found in the header; streams may lack fields the header does not carry.
+     * @throws ByteBudgetExceeded if the header does not fit in the budget.
+     * @throws std::runtime_error if the container is unsupported or malformed.
+     */
+    static MediaInfo probe(RangeReader& reader);
+};
+
+#endif // HEADER_PROBE_HPP
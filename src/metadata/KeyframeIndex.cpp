@@ -0,0 +1,169 @@
+#include "KeyframeIndex.hpp"
+
+#include <algorithm>
+
+namespace {
+
+    // Version 2 added the stream start time; older indexes fail to decode and are rebuilt
+    constexpr char kMagic[] = {'K', 'F', 'I', '2'};
+
+    void writeVarint(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    void writeSigned(std::string& out, const std::int64_t value) {
+        // Zigzag so that small negative deltas stay small
+        writeVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    class Reader {
+    public:
+        explicit Reader(const std::string& data) : m_data(data) {}
+
+        bool readVarint(std::uint64_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (m_offset >= m_data.size()) {
+                    return false;
+                }
+                const auto byte = static_cast<unsigned char>(m_data[m_offset++]);
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool readSigned(std::int64_t& value) {
+            std::uint64_t encoded = 0;
+            if (!readVarint(encoded)) {
+                return false;
+            }
+            value = static_cast<std::int64_t>(encoded >> 1) ^ -static_cast<std::int64_t>(encoded & 1);
+            return true;
+        }
+
+        bool readMagic() {
+            if (m_data.size() < sizeof(kMagic) || !std::equal(std::begin(kMagic), std::end(kMagic), m_data.begin())) {
+                return false;
+            }
+            m_offset = sizeof(kMagic);
+            return true;
+        }
+
+        [[nodiscard]] bool atEnd() const { return m_offset == m_data.size(); }
+
+    private:
+        const std::string& m_data;
+        std::size_t m_offset = 0;
+    };
+
+} // namespace
+
+const StreamKeyframes* KeyframeIndex::stream(const int streamIndex) const {
+    const auto it = std::find_if(streams.begin(), streams.end(),
+                                 [streamIndex](const StreamKeyframes& s) { return s.streamIndex == streamIndex; });
+    return it == streams.end() ? nullptr : &*it;
+}
+
+const StreamKeyframes* KeyframeIndex::primaryStream() const {
+    const auto it = std::max_element(streams.begin(), streams.end(), [](const StreamKeyframes& a, const StreamKeyframes& b) {
+        return a.keyframes.size() < b.keyframes.size();
+    });
+    return it == streams.end() ? nullptr : &*it;
+}
+
+std::optional<double> KeyframeIndex::keyframeAtOrBefore(const double seconds) const {
+    const StreamKeyframes* primary = primaryStream();
+    if (!primary || primary->keyframes.empty()) {
+        return std::nullopt;
+    }
+
+    const auto& keyframes = primary->keyframes;
+    const auto after = std::upper_bound(keyframes.begin(), keyframes.end(), seconds,
+                                        [primary](const double time, const KeyframeEntry& entry) {
+                                            return time < primary->toSeconds(entry.pts);
+                                        });
+    if (after == keyframes.begin()) {
+        return std::nullopt;
+    }
+    return primary->toSeconds(std::prev(after)->pts);
+}
+
+std::string KeyframeIndex::serialize() const {
+    std::string out(std::begin(kMagic), std::end(kMagic));
+    writeVarint(out, streams.size());
+
+    for (const auto& stream : streams) {
+        writeVarint(out, static_cast<std::uint64_t>(stream.streamIndex));
+        writeVarint(out, static_cast<std::uint64_t>(stream.timeBaseNum));
+        writeVarint(out, static_cast<std::uint64_t>(stream.timeBaseDen));
+        writeSigned(out, stream.startPts);
+        writeVarint(out, stream.keyframes.size());
+
+        std::int64_t previousPts = 0;
+        std::int64_t previousPosition = 0;
+        for (const auto& entry : stream.keyframes) {
+            writeSigned(out, entry.pts - previousPts);
+            writeSigned(out, entry.position - previousPosition);
+            writeVarint(out, entry.packetCount);
+            writeVarint(out, entry.bytes);
+            previousPts = entry.pts;
+            previousPosition = entry.position;
+        }
+    }
+    return out;
+}
+
+std::optional<KeyframeIndex> KeyframeIndex::deserialize(const std::string& data) {
+    Reader reader(data);
+    if (!reader.readMagic()) {
+        return std::nullopt;
+    }
+
+    std::uint64_t streamCount = 0;
+    if (!reader.readVarint(streamCount)) {
+        return std::nullopt;
+    }
+
+    KeyframeIndex index;
+    for (std::uint64_t s = 0; s < streamCount; ++s) {
+        std::uint64_t streamIndex = 0, timeBaseNum = 0, timeBaseDen = 0, count = 0;
+        std::int64_t startPts = 0;
+        if (!reader.readVarint(streamIndex) || !reader.readVarint(timeBaseNum) || !reader.readVarint(timeBaseDen) ||
+            !reader.readSigned(startPts) || !reader.readVarint(count) || timeBaseDen == 0) {
+            return std::nullopt;
+        }
+
+        StreamKeyframes stream;
+        stream.streamIndex = static_cast<int>(streamIndex);
+        stream.timeBaseNum = static_cast<int>(timeBaseNum);
+        stream.timeBaseDen = static_cast<int>(timeBaseDen);
+        stream.startPts = startPts;
+
+        std::int64_t pts = 0;
+        std::int64_t position = 0;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::int64_t ptsDelta = 0, positionDelta = 0;
+            std::uint64_t packetCount = 0, bytes = 0;
+            if (!reader.readSigned(ptsDelta) || !reader.readSigned(positionDelta) ||
+                !reader.readVarint(packetCount) || !reader.readVarint(bytes)) {
+                return std::nullopt;
+            }
+            pts += ptsDelta;
+            position += positionDelta;
+            stream.keyframes.push_back({pts, position, static_cast<std::uint32_t>(packetCount), bytes});
+        }
+        index.streams.push_back(std::move(stream));
+    }
+
+    if (!reader.atEnd()) {
+        return std::nullopt;
+    }
+    return index;
+}
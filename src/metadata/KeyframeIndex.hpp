@@ -0,0 +1,75 @@
+#ifndef KEYFRAME_INDEX_HPP
+#define KEYFRAME_INDEX_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * A keyframe starting a group of pictures, with the size of the packets up to the next keyframe.
+ */
+struct KeyframeEntry {
+    std::int64_t pts = 0;        // Presentation timestamp in the stream's time base
+    std::int64_t position = -1;  // Byte offset of the keyframe packet in the file, -1 if unknown
+    std::uint32_t packetCount = 0;  // Packets from this keyframe up to the next one
+    std::uint64_t bytes = 0;        // Total size of those packets
+};
+
+/**
+ * Keyframe and packet-size index of one stream.
+ */
+struct StreamKeyframes {
+    int streamIndex = 0;
+    int timeBaseNum = 1;
+    int timeBaseDen = 1;
+    std::int64_t startPts = 0;             // Stream start time in the time base; MPEG-TS rarely starts at 0
+    std::vector<KeyframeEntry> keyframes;  // Ordered by pts
+
+    /**
+     * Converts a pts to seconds from the start of the stream, the time ffmpeg seeks and segments by.
+     */
+    [[nodiscard]] double toSeconds(const std::int64_t pts) const {
+        return static_cast<double>(pts - startPts) * timeBaseNum / timeBaseDen;
+    }
+};
+
+/**
+ * KeyframeIndex records where the keyframes of each stream are, so chunking, thumbnailing and
+ * seeking can work without rescanning the input. It is built in a single demux pass by
+ * KeyframeIndexer and persisted in a compact delta-encoded binary form.
+ */
+class KeyframeIndex {
+public:
+    std::vector<StreamKeyframes> streams;
+
+    /**
+     * Returns the index of the given stream, or nullptr if it was not indexed.
+     */
+    [[nodiscard]] const StreamKeyframes* stream(int streamIndex) const;
+
+    /**
+     * Returns the stream with the most keyframes (normally the main video stream), or nullptr.
+     */
+    [[nodiscard]] const StreamKeyframes* primaryStream() const;
+
+    /**
+     * Finds the last keyframe of the primary stream at or before a time.
+     * @param seconds Input time to seek to, counted from the start of the stream.
+     * @return The keyframe time in seconds from the start of the stream, or std::nullopt if the index has no keyframe before it.
+     */
+    [[nodiscard]] std::optional<double> keyframeAtOrBefore(double seconds) const;
+
+    /**
+     * Encodes the index as varints, with pts and positions stored as zigzag deltas.
+     */
+    [[nodiscard]] std::string serialize() const;
+
+    /**
+     * Decodes serialize() output.
+     * @return The index, or std::nullopt if the data is truncated or has an unknown version.
+     */
+    static std::optional<KeyframeIndex> deserialize(const std::string& data);
+};
+
+#endif // KEYFRAME_INDEX_HPP
@@ -0,0 +1,207 @@
+#include "KeyframeIndexer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#ifdef HAVE_LIBAVFORMAT
+extern "C" {
+#include <libavformat/avformat.h>
+}
+#else
+#include "utils/ProcessRunner.hpp"
+#endif
+
+namespace {
+
+    // Accumulates packets of one stream into keyframe entries
+    struct StreamBuilder {
+        StreamKeyframes stream;
+
+        void addPacket(const std::int64_t pts, const std::int64_t position, const std::uint64_t size, const bool keyframe) {
+            if (keyframe) {
+                stream.keyframes.push_back({pts, position, 0, 0});
+            }
+            if (!stream.keyframes.empty()) {  // Packets before the first keyframe are not seekable
+                auto& current = stream.keyframes.back();
+                ++current.packetCount;
+                current.bytes += size;
+            }
+        }
+
+        StreamKeyframes finish() {
+            std::stable_sort(stream.keyframes.begin(), stream.keyframes.end(),
+                             [](const KeyframeEntry& a, const KeyframeEntry& b) { return a.pts < b.pts; });
+            return std::move(stream);
+        }
+    };
+
+    KeyframeIndex collect(std::map<int, StreamBuilder>& builders) {
+        KeyframeIndex index;
+        for (auto& [streamIndex, builder] : builders) {
+            if (!builder.stream.keyframes.empty()) {
+                index.streams.push_back(builder.finish());
+            }
+        }
+        return index;
+    }
+
+#ifdef HAVE_LIBAVFORMAT
+    int interruptCallback(void* opaque) {
+        return std::chrono::steady_clock::now() >= *static_cast<std::chrono::steady_clock::time_point*>(opaque) ? 1 : 0;
+    }
+#else
+    // Parses "key=value|key=value" fields of one ffprobe compact-format line
+    std::map<std::string, std::string> parseCompactLine(const std::string& line) {
+        std::map<std::string, std::string> fields;
+        std::istringstream stream(line);
+        for (std::string field; std::getline(stream, field, '|');) {
+            if (const auto equals = field.find('='); equals != std::string::npos) {
+                fields[field.substr(0, equals)] = field.substr(equals + 1);
+            }
+        }
+        return fields;
+    }
+
+    std::int64_t toInt64(const std::map<std::string, std::string>& fields, const std::string& key, const std::int64_t fallback) {
+        const auto it = fields.find(key);
+        if (it == fields.end() || it->second.empty() || it->second == "N/A") {
+            return fallback;
+        }
+        return std::strtoll(it->second.c_str(), nullptr, 10);
+    }
+
+    // Indexes ffprobe compact output line by line as it is read. ffprobe prints every packet before the
+    // stream sections, so packets go straight into per-stream builders, which keep only keyframe entries;
+    // the stream lines that follow supply time bases and start times and rule out attached pictures.
+    class CompactOutputParser {
+    public:
+        void feed(const std::string_view chunk) {
+            m_pending.append(chunk);
+            std::size_t start = 0;
+            for (std::size_t end; (end = m_pending.find('\n', start)) != std::string::npos; start = end + 1) {
+                parseLine(m_pending.substr(start, end - start));
+            }
+            m_pending.erase(0, start);
+        }
+
+        KeyframeIndex finish() {
+            if (!m_pending.empty()) {
+                parseLine(m_pending);
+                m_pending.clear();
+            }
+            for (auto it = m_builders.begin(); it != m_builders.end();) {
+                it = m_videoStreams.count(it->first) ? std::next(it) : m_builders.erase(it);
+            }
+            return collect(m_builders);
+        }
+
+    private:
+        void parseLine(const std::string& line) {
+            if (line.rfind("packet|", 0) == 0) {
+                const auto fields = parseCompactLine(line);
+                const std::int64_t pts = toInt64(fields, "pts", toInt64(fields, "dts", 0));
+                const auto flags = fields.find("flags");
+                m_builders[static_cast<int>(toInt64(fields, "stream_index", -1))].addPacket(
+                    pts, toInt64(fields, "pos", -1), static_cast<std::uint64_t>(toInt64(fields, "size", 0)),
+                    flags != fields.end() && flags->second.find('K') != std::string::npos);
+            } else if (line.rfind("stream|", 0) == 0) {
+                const auto fields = parseCompactLine(line);
+                if (toInt64(fields, "disposition:attached_pic", 0) != 0) {
+                    return;
+                }
+                const auto streamIndex = static_cast<int>(toInt64(fields, "index", -1));
+                m_videoStreams.insert(streamIndex);
+                auto& stream = m_builders[streamIndex].stream;
+                stream.streamIndex = streamIndex;
+                stream.startPts = toInt64(fields, "start_pts", 0);
+                const auto timeBase = fields.count("time_base") ? fields.at("time_base") : std::string("1/1");
+                std::sscanf(timeBase.c_str(), "%d/%d", &stream.timeBaseNum, &stream.timeBaseDen);
+            }
+        }
+
+        std::string m_pending;                 // Output after the last complete line
+        std::map<int, StreamBuilder> m_builders;
+        std::set<int> m_videoStreams;          // Streams described by a stream line, minus attached pictures
+    };
+#endif
+
+} // namespace
+
+#ifdef HAVE_LIBAVFORMAT
+
+KeyframeIndex KeyframeIndexer::build(const std::string& filePath, std::chrono::steady_clock::time_point deadline) const {
+    AVFormatContext* context = avformat_alloc_context();
+    if (!context) {
+        throw std::runtime_error("Failed to allocate libavformat context");
+    }
+    context->interrupt_callback.callback = interruptCallback;
+    context->interrupt_callback.opaque = &deadline;
+
+    if (avformat_open_input(&context, filePath.c_str(), nullptr, nullptr) < 0) {
+        throw std::runtime_error("Failed to open input for keyframe indexing: " + filePath);
+    }
+    const std::unique_ptr<AVFormatContext*, void (*)(AVFormatContext**)> guard(&context, avformat_close_input);
+
+    std::map<int, StreamBuilder> builders;
+    for (unsigned int i = 0; i < context->nb_streams; ++i) {
+        const AVStream* stream = context->streams[i];
+        if (stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && !(stream->disposition & AV_DISPOSITION_ATTACHED_PIC)) {
+            auto& builder = builders[stream->index];
+            builder.stream.streamIndex = stream->index;
+            builder.stream.timeBaseNum = stream->time_base.num;
+            builder.stream.timeBaseDen = stream->time_base.den;
+            builder.stream.startPts = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        } else {
+            context->streams[i]->discard = AVDISCARD_ALL;  // Skip reading packets of streams we do not index
+        }
+    }
+
+    AVPacket* packet = av_packet_alloc();
+    if (!packet) {
+        throw std::runtime_error("Failed to allocate packet");
+    }
+    int result;
+    while ((result = av_read_frame(context, packet)) >= 0) {
+        if (const auto it = builders.find(packet->stream_index); it != builders.end()) {
+            const std::int64_t pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+            it->second.addPacket(pts, packet->pos, static_cast<std::uint64_t>(packet->size), packet->flags & AV_PKT_FLAG_KEY);
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+
+    if (result != AVERROR_EOF) {
+        throw std::runtime_error(std::chrono::steady_clock::now() >= deadline ? "Keyframe indexing timed out"
+                                                                               : "Failed to read packets while indexing " + filePath);
+    }
+    return collect(builders);
+}
+
+#else // HAVE_LIBAVFORMAT
+
+KeyframeIndex KeyframeIndexer::build(const std::string& filePath, const std::chrono::steady_clock::time_point deadline) const {
+    const std::vector<std::string> command = {
+        "ffprobe", "-v", "error", "-select_streams", "v", "-show_entries",
+        "stream=index,time_base,start_pts,disposition:packet=stream_index,pts,dts,pos,size,flags",
+        "-of", "compact", filePath};
+
+    CompactOutputParser parser;
+    const auto result = ProcessRunner::run(command, deadline, nullptr,
+                                           [&parser](const std::string_view chunk) { parser.feed(chunk); });
+    if (result.timedOut) {
+        throw std::runtime_error("Keyframe indexing timed out");
+    }
+    if (result.exitCode != 0) {
+        throw std::runtime_error("ffprobe failed to index keyframes of " + filePath);
+    }
+    return parser.finish();
+}
+
+#endif // HAVE_LIBAVFORMAT
@@ -0,0 +1,28 @@
+#ifndef KEYFRAME_INDEXER_HPP
+#define KEYFRAME_INDEXER_HPP
+
+#include "KeyframeIndex.hpp"
+#include <chrono>
+#include <string>
+
+/**
+ * KeyframeIndexer builds a KeyframeIndex for the video streams of a file in a single demux pass.
+ * It reads packets in-process with libavformat when the build has it (HAVE_LIBAVFORMAT) and
+ * otherwise parses `ffprobe -show_packets`; either way no frame is decoded.
+ * Audio streams are not indexed: every audio packet is a keyframe, so the index would only
+ * repeat the packet list.
+ */
+class KeyframeIndexer {
+public:
+    /**
+     * Indexes the keyframes of every video stream.
+     * @param filePath The path or URL of the media file.
+     * @param deadline Point in time after which indexing is abandoned.
+     * @return The index; streams without packets are omitted.
+     * @throws std::runtime_error if the file cannot be read or indexing times out.
+     */
+    KeyframeIndex build(const std::string& filePath,
+                        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()) const;
+};
+
+#endif // KEYFRAME_INDEXER_HPP
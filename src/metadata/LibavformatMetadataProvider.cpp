@@ -0,0 +1,168 @@
+#include "LibavformatMetadataProvider.hpp"
+
+#ifdef HAVE_LIBAVFORMAT
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/dict.h>
+#include <libavutil/error.h>
+}
+
+namespace {
+
+    struct InterruptState {
+        std::chrono::steady_clock::time_point deadline;
+        const std::atomic<bool>* cancelled;
+        bool timedOut = false;
+        bool wasCancelled = false;
+    };
+
+    // Polled by libavformat during blocking I/O; non-zero aborts the operation
+    int interruptCallback(void* opaque) {
+        auto* state = static_cast<InterruptState*>(opaque);
+        if (state->cancelled && state->cancelled->load()) {
+            state->wasCancelled = true;
+            return 1;
+        }
+        if (std::chrono::steady_clock::now() >= state->deadline) {
+            state->timedOut = true;
+            return 1;
+        }
+        return 0;
+    }
+
+    std::string failureMessage(const InterruptState& state, const std::string& operation, const int errorCode) {
+        if (state.timedOut) {
+            return "libavformat probe timed out";
+        }
+        if (state.wasCancelled) {
+            return "libavformat probe was cancelled";
+        }
+        char buffer[AV_ERROR_MAX_STRING_SIZE] = {};
+        av_strerror(errorCode, buffer, sizeof(buffer));
+        return "libavformat failed to " + operation + ": " + buffer;
+    }
+
+    double toFrameRate(const AVRational rate) {
+        return rate.num > 0 && rate.den > 0 ? av_q2d(rate) : 0.0;
+    }
+
+    StreamInfo toStreamInfo(const AVStream* stream) {
+        const AVCodecParameters* codecpar = stream->codecpar;
+        StreamInfo info;
+
+        info.index = stream->index;
+        info.codecName = avcodec_get_name(codecpar->codec_id);
+        if (const char* type = av_get_media_type_string(codecpar->codec_type)) {
+            info.codecType = type;
+        }
+        info.bitRate = codecpar->bit_rate > 0 ? codecpar->bit_rate : 0;
+
+        if (codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+            info.width = codecpar->width;
+            info.height = codecpar->height;
+            info.frameRate = toFrameRate(stream->avg_frame_rate);
+            if (info.frameRate <= 0) {
+                info.frameRate = toFrameRate(stream->r_frame_rate);
+            }
+        } else if (codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+            info.sampleRate = codecpar->sample_rate;
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(59, 37, 100)
+            info.channels = codecpar->ch_layout.nb_channels;
+#else
+            info.channels = codecpar->channels;
+#endif
+        }
+
+        if (stream->duration != AV_NOPTS_VALUE) {
+            info.duration = static_cast<double>(stream->duration) * av_q2d(stream->time_base);
+        }
+        if (const AVDictionaryEntry* language = av_dict_get(stream->metadata, "language", nullptr, 0)) {
+            info.language = language->value;
+        }
+        return info;
+    }
+
+} // namespace
+
+LibavformatMetadataProvider::LibavformatMetadataProvider(const std::int64_t probeSize, const std::int64_t analyzeDurationMicros)
+  : probeSize(probeSize), analyzeDurationMicros(analyzeDurationMicros) {}
+
+MediaInfo LibavformatMetadataProvider::getMetadata(const std::string& filePath) {
+    return getMetadata(filePath, std::chrono::steady_clock::time_point::max(), nullptr);
+}
+
+MediaInfo LibavformatMetadataProvider::getMetadata(const std::string& filePath,
+                                                   const std::chrono::steady_clock::time_point deadline,
+                                                   const std::atomic<bool>* cancelled) {
+    InterruptState interruptState{deadline, cancelled};
+
+    AVFormatContext* rawContext = avformat_alloc_context();
+    if (!rawContext) {
+        throw std::runtime_error("Failed to allocate libavformat context");
+    }
+    rawContext->interrupt_callback.callback = interruptCallback;
+    rawContext->interrupt_callback.opaque = &interruptState;
+
+    AVDictionary* options = nullptr;
+    av_dict_set_int(&options, "probesize", probeSize, 0);
+    av_dict_set_int(&options, "analyzeduration", analyzeDurationMicros, 0);
+
+    // avformat_open_input frees the context on failure
+    const int openResult = avformat_open_input(&rawContext, filePath.c_str(), nullptr, &options);
+    av_dict_free(&options);
+    if (openResult < 0) {
+        throw std::runtime_error(failureMessage(interruptState, "open input", openResult));
+    }
+
+    const std::unique_ptr<AVFormatContext*, void (*)(AVFormatContext**)> context(&rawContext, avformat_close_input);
+
+    if (const int infoResult = avformat_find_stream_info(rawContext, nullptr); infoResult < 0) {
+        throw std::runtime_error(failureMessage(interruptState, "read stream info", infoResult));
+    }
+
+    return toMediaInfo(rawContext);
+}
+
+MediaInfo LibavformatMetadataProvider::toMediaInfo(const AVFormatContext* context) {
+    MediaInfo metadata;
+    metadata.streams.reserve(context->nb_streams);
+    for (unsigned int i = 0; i < context->nb_streams; ++i) {
+        metadata.streams.push_back(toStreamInfo(context->streams[i]));
+    }
+
+    metadata.format.formatName = context->iformat->name;
+    if (context->duration != AV_NOPTS_VALUE) {
+        metadata.format.duration = static_cast<double>(context->duration) / AV_TIME_BASE;
+    }
+    metadata.format.bitRate = context->bit_rate > 0 ? context->bit_rate : 0;
+    if (context->pb) {
+        metadata.format.size = std::max<std::int64_t>(avio_size(context->pb), 0);
+    }
+
+    return metadata;
+}
+
+#else // HAVE_LIBAVFORMAT
+
+#include <stdexcept>
+
+LibavformatMetadataProvider::LibavformatMetadataProvider(const std::int64_t probeSize, const std::int64_t analyzeDurationMicros)
+  : probeSize(probeSize), analyzeDurationMicros(analyzeDurationMicros) {}
+
+MediaInfo LibavformatMetadataProvider::getMetadata(const std::string& filePath) {
+    return getMetadata(filePath, std::chrono::steady_clock::time_point::max(), nullptr);
+}
+
+MediaInfo LibavformatMetadataProvider::getMetadata(const std::string&,
+                                                   std::chrono::steady_clock::time_point,
+                                                   const std::atomic<bool>*) {
+    throw std::runtime_error("libavformat support was not compiled in");
+}
+
+#endif // HAVE_LIBAVFORMAT
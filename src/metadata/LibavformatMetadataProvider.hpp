@@ -0,0 +1,60 @@
+#ifndef LIBAVFORMAT_METADATA_PROVIDER_HPP
+#define LIBAVFORMAT_METADATA_PROVIDER_HPP
+
+#include "MediaMetadataProvider.hpp"
+#include <cstdint>
+#include <string>
+
+struct AVFormatContext;
+
+/**
+ * LibavformatMetadataProvider opens the media file with libavformat in-process and fills the
+ * MediaInfo directly from the demuxer's stream parameters.
+ * It avoids spawning a process and re-parsing JSON, so a probe costs milliseconds.
+ * Only available when the build found libavformat (HAVE_LIBAVFORMAT).
+ */
+class LibavformatMetadataProvider final : public MediaMetadataProvider {
+public:
+    /**
+     * Constructor for LibavformatMetadataProvider.
+     * @param probeSize Maximum number of bytes read while detecting the container and streams.
+     * @param analyzeDurationMicros Maximum stream duration, in microseconds, analyzed for codec parameters.
+     */
+    explicit LibavformatMetadataProvider(std::int64_t probeSize = 5000000, std::int64_t analyzeDurationMicros = 5000000);
+
+    /**
+     * Retrieves metadata for the specified file using libavformat.
+     * @param filePath The path or URL of the media file.
+     * @return The probed metadata.
+     * @throws std::runtime_error if the file cannot be opened or its streams cannot be read.
+     */
+    MediaInfo getMetadata(const std::string& filePath) override;
+
+    /**
+     * Retrieves metadata, aborting blocking I/O once the deadline passes or the cancel flag is raised.
+     * @param filePath The path or URL of the media file.
+     * @param deadline Point in time after which the probe is abandoned.
+     * @param cancelled Optional flag that abandons the probe when raised.
+     * @return The probed metadata.
+     * @throws std::runtime_error if the probe fails, times out or is cancelled.
+     */
+    MediaInfo getMetadata(const std::string& filePath,
+                          std::chrono::steady_clock::time_point deadline,
+                          const std::atomic<bool>* cancelled) override;
+
+#ifdef HAVE_LIBAVFORMAT
+    /**
+     * Fills a MediaInfo from a context that went through avformat_find_stream_info.
+     * Shared with probes that open inputs through custom I/O.
+     * @param context The opened format context.
+     * @return The probed metadata.
+     */
+    static MediaInfo toMediaInfo(const AVFormatContext* context);
+#endif
+
+private:
+    std::int64_t probeSize;
+    std::int64_t analyzeDurationMicros;
+};
+
+#endif // LIBAVFORMAT_METADATA_PROVIDER_HPP
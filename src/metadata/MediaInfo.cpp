@@ -0,0 +1,228 @@
+#include "MediaInfo.hpp"
+
+#include <cstdlib>
+#include <map>
+
+namespace {
+
+    // ffprobe and mediainfo report most numbers as strings; toJson() writes real numbers
+    double toDouble(const Json::Value& value) {
+        if (value.isNumeric()) {
+            return value.asDouble();
+        }
+        if (value.isString()) {
+            return std::strtod(value.asCString(), nullptr);
+        }
+        return 0.0;
+    }
+
+    std::int64_t toInt64(const Json::Value& value) {
+        if (value.isIntegral()) {
+            return value.asInt64();
+        }
+        return static_cast<std::int64_t>(toDouble(value));
+    }
+
+    // "30000/1001" -> 29.97; plain numbers are accepted as well
+    double toFrameRate(const Json::Value& value) {
+        if (!value.isString()) {
+            return toDouble(value);
+        }
+        const std::string text = value.asString();
+        if (const auto slash = text.find('/'); slash != std::string::npos) {
+            const double denominator = std::strtod(text.c_str() + slash + 1, nullptr);
+            return denominator > 0 ? std::strtod(text.c_str(), nullptr) / denominator : 0.0;
+        }
+        return std::strtod(text.c_str(), nullptr);
+    }
+
+    template <typename T>
+    void fillMissing(T& target, const T& source) {
+        if (target == T{}) {
+            target = source;
+        }
+    }
+
+    void fillMissing(StreamInfo& target, const StreamInfo& source) {
+        fillMissing(target.codecName, source.codecName);
+        fillMissing(target.width, source.width);
+        fillMissing(target.height, source.height);
+        fillMissing(target.frameRate, source.frameRate);
+        fillMissing(target.bitRate, source.bitRate);
+        fillMissing(target.duration, source.duration);
+        fillMissing(target.language, source.language);
+        fillMissing(target.sampleRate, source.sampleRate);
+        fillMissing(target.channels, source.channels);
+    }
+
+    bool streamHasField(const StreamInfo& stream, const std::string& field) {
+        if (field == "index") return stream.index >= 0;
+        if (field == "codec_type") return !stream.codecType.empty();
+        if (field == "codec_name") return !stream.codecName.empty();
+        if (field == "language") return !stream.language.empty();
+        if (field == "bit_rate") return stream.bitRate > 0;
+        if (field == "duration") return stream.duration > 0;
+        // Dimension and rate fields only apply to the matching stream type
+        if (field == "width") return stream.codecType != "video" || stream.width > 0;
+        if (field == "height") return stream.codecType != "video" || stream.height > 0;
+        if (field == "frame_rate") return stream.codecType != "video" || stream.frameRate > 0;
+        if (field == "sample_rate") return stream.codecType != "audio" || stream.sampleRate > 0;
+        if (field == "channels") return stream.codecType != "audio" || stream.channels > 0;
+        return false;
+    }
+
+} // namespace
+
+void MediaInfo::mergeFrom(const MediaInfo& other) {
+    fillMissing(format.formatName, other.format.formatName);
+    fillMissing(format.duration, other.format.duration);
+    fillMissing(format.bitRate, other.format.bitRate);
+    fillMissing(format.size, other.format.size);
+
+    // Pair streams by (type, ordinal within type)
+    std::map<std::string, std::vector<StreamInfo*>> byType;
+    for (auto& stream : streams) {
+        byType[stream.codecType].push_back(&stream);
+    }
+
+    std::map<std::string, std::size_t> seen;
+    std::vector<StreamInfo> unmatched;
+    for (const auto& stream : other.streams) {
+        const std::size_t ordinal = seen[stream.codecType]++;
+        if (const auto it = byType.find(stream.codecType); it != byType.end() && ordinal < it->second.size()) {
+            fillMissing(*it->second[ordinal], stream);
+        } else {
+            unmatched.push_back(stream);
+        }
+    }
+
+    for (auto& stream : unmatched) {
+        stream.index = static_cast<int>(streams.size());
+        streams.push_back(std::move(stream));
+    }
+}
+
+bool MediaInfo::hasField(const std::string& field) const {
+    if (field == "format.format_name") return !format.formatName.empty();
+    if (field == "format.duration") return format.duration > 0;
+    if (field == "format.bit_rate") return format.bitRate > 0;
+    if (field == "format.size") return format.size > 0;
+
+    constexpr const char* streamPrefix = "streams.";
+    if (field.rfind(streamPrefix, 0) != 0 || streams.empty()) {
+        return false;
+    }
+    const std::string streamField = field.substr(std::char_traits<char>::length(streamPrefix));
+    for (const auto& stream : streams) {
+        if (!streamHasField(stream, streamField)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Json::Value MediaInfo::toJson() const {
+    Json::Value json(Json::objectValue);
+
+    Json::Value& formatJson = json["format"] = Json::Value(Json::objectValue);
+    if (!format.formatName.empty()) formatJson["format_name"] = format.formatName;
+    if (format.duration > 0) formatJson["duration"] = format.duration;
+    if (format.bitRate > 0) formatJson["bit_rate"] = static_cast<Json::Int64>(format.bitRate);
+    if (format.size > 0) formatJson["size"] = static_cast<Json::Int64>(format.size);
+    formatJson["nb_streams"] = static_cast<Json::UInt>(streams.size());
+
+    Json::Value& streamsJson = json["streams"] = Json::Value(Json::arrayValue);
+    for (const auto& stream : streams) {
+        Json::Value streamJson(Json::objectValue);
+        streamJson["index"] = stream.index;
+        if (!stream.codecType.empty()) streamJson["codec_type"] = stream.codecType;
+        if (!stream.codecName.empty()) streamJson["codec_name"] = stream.codecName;
+        if (stream.width > 0) streamJson["width"] = stream.width;
+        if (stream.height > 0) streamJson["height"] = stream.height;
+        if (stream.frameRate > 0) streamJson["frame_rate"] = stream.frameRate;
+        if (stream.bitRate > 0) streamJson["bit_rate"] = static_cast<Json::Int64>(stream.bitRate);
+        if (stream.duration > 0) streamJson["duration"] = stream.duration;
+        if (!stream.language.empty()) streamJson["language"] = stream.language;
+        if (stream.sampleRate > 0) streamJson["sample_rate"] = stream.sampleRate;
+        if (stream.channels > 0) streamJson["channels"] = stream.channels;
+        streamsJson.append(std::move(streamJson));
+    }
+
+    return json;
+}
+
+MediaInfo MediaInfo::fromFfprobeJson(const Json::Value& json) {
+    MediaInfo info;
+
+    if (const Json::Value& format = json["format"]; format.isObject()) {
+        info.format.formatName = format.get("format_name", "").asString();
+        info.format.duration = toDouble(format["duration"]);
+        info.format.bitRate = toInt64(format["bit_rate"]);
+        info.format.size = toInt64(format["size"]);
+    }
+
+    for (const auto& streamJson : json["streams"]) {
+        StreamInfo stream;
+        stream.index = streamJson.get("index", static_cast<int>(info.streams.size())).asInt();
+        stream.codecType = streamJson.get("codec_type", "").asString();
+        stream.codecName = streamJson.get("codec_name", "").asString();
+        stream.width = streamJson.get("width", 0).asInt();
+        stream.height = streamJson.get("height", 0).asInt();
+        stream.bitRate = toInt64(streamJson["bit_rate"]);
+        stream.duration = toDouble(streamJson["duration"]);
+        stream.sampleRate = static_cast<int>(toInt64(streamJson["sample_rate"]));
+        stream.channels = streamJson.get("channels", 0).asInt();
+
+        // ffprobe reports rationals and keeps the language in tags; toJson() flattens both
+        stream.frameRate = toFrameRate(streamJson["frame_rate"]);
+        if (stream.frameRate <= 0) stream.frameRate = toFrameRate(streamJson["avg_frame_rate"]);
+        if (stream.frameRate <= 0) stream.frameRate = toFrameRate(streamJson["r_frame_rate"]);
+        stream.language = streamJson.get("language", "").asString();
+        if (stream.language.empty()) stream.language = streamJson["tags"].get("language", "").asString();
+
+        info.streams.push_back(std::move(stream));
+    }
+
+    return info;
+}
+
+MediaInfo MediaInfo::fromMediaInfoJson(const Json::Value& json) {
+    static const std::map<std::string, std::string> kTrackTypes = {
+        {"Video", "video"}, {"Audio", "audio"}, {"Text", "subtitle"}, {"Other", "data"}};
+
+    MediaInfo info;
+
+    for (const auto& track : json["media"]["track"]) {
+        const std::string type = track.get("@type", "").asString();
+
+        if (type == "General") {
+            info.format.formatName = track.get("Format", "").asString();
+            info.format.duration = toDouble(track["Duration"]);
+            info.format.bitRate = toInt64(track["OverallBitRate"]);
+            info.format.size = toInt64(track["FileSize"]);
+            continue;
+        }
+
+        const auto trackType = kTrackTypes.find(type);
+        if (trackType == kTrackTypes.end()) {
+            continue;
+        }
+
+        StreamInfo stream;
+        stream.index = track.isMember("StreamOrder") ? static_cast<int>(toInt64(track["StreamOrder"]))
+                                                     : static_cast<int>(info.streams.size());
+        stream.codecType = trackType->second;
+        stream.codecName = track.get("Format", "").asString();
+        stream.width = static_cast<int>(toInt64(track["Width"]));
+        stream.height = static_cast<int>(toInt64(track["Height"]));
+        stream.frameRate = toDouble(track["FrameRate"]);
+        stream.bitRate = toInt64(track["BitRate"]);
+        stream.duration = toDouble(track["Duration"]);
+        stream.language = track.get("Language", "").asString();
+        stream.sampleRate = static_cast<int>(toInt64(track["SamplingRate"]));
+        stream.channels = static_cast<int>(toInt64(track["Channels"]));
+        info.streams.push_back(std::move(stream));
+    }
+
+    return info;
+}
@@ -0,0 +1,78 @@
+#ifndef MEDIA_INFO_HPP
+#define MEDIA_INFO_HPP
+
+#include <json/json.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Container-level properties of a probed file. Zero or empty means unknown.
+ */
+struct FormatInfo {
+    std::string formatName;
+    double duration = 0.0;     // Seconds
+    std::int64_t bitRate = 0;  // Bits per second
+    std::int64_t size = 0;     // Bytes
+};
+
+/**
+ * Properties of a single elementary stream. Zero or empty means unknown.
+ */
+struct StreamInfo {
+    int index = -1;
+    std::string codecType;     // "video", "audio", "subtitle", "data"
+    std::string codecName;
+    int width = 0;
+    int height = 0;
+    double frameRate = 0.0;    // Frames per second
+    std::int64_t bitRate = 0;  // Bits per second
+    double duration = 0.0;     // Seconds
+    std::string language;
+    int sampleRate = 0;        // Hz
+    int channels = 0;
+};
+
+/**
+ * MediaInfo is the typed, compact result of a metadata probe.
+ * Providers fill it directly; it is converted to JSON only when returned through the API.
+ */
+struct MediaInfo {
+    FormatInfo format;
+    std::vector<StreamInfo> streams;
+
+    [[nodiscard]] bool empty() const { return format.formatName.empty() && streams.empty(); }
+
+    /**
+     * Fills fields that are unknown here from another probe's result, stream by stream.
+     * Streams are paired by type and order of appearance (first video with first video, ...);
+     * streams only the other result knows about are appended.
+     * @param other The lower-priority result.
+     */
+    void mergeFrom(const MediaInfo& other);
+
+    /**
+     * Checks a required field such as "format.duration" or "streams.codec_name".
+     * A "streams." field must be known on every stream, and there must be at least one stream.
+     * @return True if the field is known; false for unknown field names.
+     */
+    [[nodiscard]] bool hasField(const std::string& field) const;
+
+    /**
+     * Converts to an ffprobe-like JSON layout: {"format": {...}, "streams": [...]}.
+     * Unknown fields are omitted.
+     */
+    [[nodiscard]] Json::Value toJson() const;
+
+    /**
+     * Reads ffprobe -show_format -show_streams output, or the output of toJson().
+     */
+    static MediaInfo fromFfprobeJson(const Json::Value& json);
+
+    /**
+     * Reads `mediainfo --Output=JSON` output.
+     */
+    static MediaInfo fromMediaInfoJson(const Json::Value& json);
+};
+
+#endif // MEDIA_INFO_HPP
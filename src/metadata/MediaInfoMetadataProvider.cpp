@@ -1,13 +1,17 @@
 #include "MediaInfoMetadataProvider.hpp"
-#include <array>
-#include <memory>
+#include "utils/ProcessRunner.hpp"
 #include <stdexcept>
 #include <sstream>
-#include <cstdio> // for popen and pclose
 
-Json::Value MediaInfoMetadataProvider::getMetadata(const std::string& filePath) {
-    std::string command = "mediainfo --Output=JSON \"" + filePath + "\"";
-    std::string result = runCommand(command);
+MediaInfo MediaInfoMetadataProvider::getMetadata(const std::string& filePath) {
+    return getMetadata(filePath, std::chrono::steady_clock::time_point::max(), nullptr);
+}
+
+MediaInfo MediaInfoMetadataProvider::getMetadata(const std::string& filePath,
+                                                 const std::chrono::steady_clock::time_point deadline,
+                                                 const std::atomic<bool>* cancelled) {
+    const std::vector<std::string> command = {"mediainfo", "--Output=JSON", filePath};
+    std::string result = runCommand(command, deadline, cancelled);
 
     Json::Value metadata;
     std::string errs;
@@ -17,24 +21,22 @@ Json::Value MediaInfoMetadataProvider::getMetadata(const std::string& filePath)
         throw std::runtime_error("MediaInfo JSON parsing failed: " + errs);
     }
 
-    return metadata;
+    return MediaInfo::fromMediaInfoJson(metadata);
 }
 
-std::string MediaInfoMetadataProvider::runCommand(const std::string& command) {
-    std::string result;
-    const std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(command.c_str(), "r"), pclose);
+std::string MediaInfoMetadataProvider::runCommand(const std::vector<std::string>& command,
+                                                  const std::chrono::steady_clock::time_point deadline,
+                                                  const std::atomic<bool>* cancelled) {
+    const auto result = ProcessRunner::run(command, deadline, cancelled);
 
-    if (!pipe) {
-        handleError("Failed to run MediaInfo command");
+    if (result.timedOut) {
+        handleError("MediaInfo timed out");
     }
-
-    while (true) {
-        char buffer[128];
-        if (fgets(buffer, sizeof(buffer), pipe.get()) == nullptr) break;
-        result += buffer;
+    if (result.cancelled) {
+        handleError("MediaInfo was cancelled");
     }
 
-    return result;
+    return result.output;
 }
 
 void MediaInfoMetadataProvider::handleError(const std::string& errorMessage) {
@@ -4,6 +4,7 @@
 #include "MediaMetadataProvider.hpp"
 #include <json/json.h>
 #include <string>
+#include <vector>
 
 /**
  * MediaInfoMetadataProvider uses MediaInfo to retrieve metadata for a media file.
@@ -14,19 +15,35 @@ public:
     /**
      * Retrieves metadata for the specified file using MediaInfo.
      * @param filePath The path to the media file.
-     * @return JSON representation of the metadata.
+     * @return The probed metadata.
      * @throws std::runtime_error if MediaInfo fails or JSON parsing fails.
      */
-    Json::Value getMetadata(const std::string& filePath) override;
+    MediaInfo getMetadata(const std::string& filePath) override;
+
+    /**
+     * Retrieves metadata for the specified file using MediaInfo, killing the probe if it runs too long.
+     * @param filePath The path to the media file.
+     * @param deadline Point in time after which the probe is abandoned.
+     * @param cancelled Optional flag that abandons the probe when raised.
+     * @return The probed metadata.
+     * @throws std::runtime_error if MediaInfo fails, times out, is cancelled or JSON parsing fails.
+     */
+    MediaInfo getMetadata(const std::string& filePath,
+                          std::chrono::steady_clock::time_point deadline,
+                          const std::atomic<bool>* cancelled) override;
 
 private:
     /**
-     * Executes the MediaInfo command and returns the raw JSON output as a string.
-     * @param command The MediaInfo command to execute.
+     * Executes MediaInfo and returns the raw JSON output as a string.
+     * @param command MediaInfo's argument vector, program name first.
+     * @param deadline Point in time after which the command is killed.
+     * @param cancelled Optional flag that kills the command when raised.
      * @return The raw JSON string output from MediaInfo.
-     * @throws std::runtime_error if the command execution fails.
+     * @throws std::runtime_error if the command execution fails, times out or is cancelled.
      */
-    static std::string runCommand(const std::string& command);
+    static std::string runCommand(const std::vector<std::string>& command,
+                                  std::chrono::steady_clock::time_point deadline,
+                                  const std::atomic<bool>* cancelled);
 
     /**
      * Helper function to handle errors during MediaInfo execution.
@@ -1,15 +1,25 @@
 #ifndef MEDIA_METADATA_PROVIDER_HPP
 #define MEDIA_METADATA_PROVIDER_HPP
 
-#include <json/json.h>
+#include "MediaInfo.hpp"
+#include <atomic>
+#include <chrono>
 #include <string>
 
 class MediaMetadataProvider {
 public:
     virtual ~MediaMetadataProvider() = default;
 
-    // Method to retrieve metadata as a JSON object
-    virtual Json::Value getMetadata(const std::string& filePath) = 0;
+    // Method to retrieve metadata as a typed MediaInfo
+    virtual MediaInfo getMetadata(const std::string& filePath) = 0;
+
+    // Bounded variant: gives up once the deadline passes or the cancel flag is raised.
+    // Providers that cannot be interrupted fall back to the unbounded call.
+    virtual MediaInfo getMetadata(const std::string& filePath,
+                                    std::chrono::steady_clock::time_point /*deadline*/,
+                                    const std::atomic<bool>* /*cancelled*/) {
+        return getMetadata(filePath);
+    }
 };
 
 #endif // MEDIA_METADATA_PROVIDER_HPP
\ No newline at end of file
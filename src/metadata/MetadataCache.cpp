@@ -0,0 +1,169 @@
+#include "MetadataCache.hpp"
+#include "utils/Logger.hpp"
+
+#include <sstream>
+#include <sys/stat.h>
+
+MetadataCache::MetadataCache(const std::size_t capacity, std::shared_ptr<MetadataCacheRepository> repository,
+                             const std::chrono::seconds maxAge)
+    : m_capacity(capacity > 0 ? capacity : 1), m_repository(std::move(repository)), m_maxAge(maxAge) {}
+
+std::optional<std::string> MetadataCache::fileKey(const std::string& filePath) {
+    struct stat info {};
+    if (stat(filePath.c_str(), &info) != 0) {
+        return std::nullopt;
+    }
+
+#ifdef __APPLE__
+    const long long mtimeNanos = static_cast<long long>(info.st_mtimespec.tv_sec) * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+    const long long mtimeNanos = static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+
+    std::ostringstream key;
+    key << "file:" << filePath << '|' << info.st_size << '|' << mtimeNanos << '|' << info.st_ino;
+    return key.str();
+}
+
+std::string MetadataCache::objectKey(const std::string& uri, const std::string& etag) {
+    return "object:" + uri + '|' + etag;
+}
+
+std::optional<MediaInfo> MetadataCache::get(const std::string& key) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (const auto it = m_index.find(key); it != m_index.end()) {
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            ++m_memoryHits;
+            return it->second->second;
+        }
+    }
+
+    if (m_repository) {
+        try {
+            if (const auto stored = m_repository->getMetadata(key)) {
+                Json::Value json;
+                std::string errs;
+                std::istringstream stream(*stored);
+                if (Json::CharReaderBuilder readerBuilder; Json::parseFromStream(readerBuilder, stream, &json, &errs)) {
+                    MediaInfo metadata = MediaInfo::fromFfprobeJson(json);
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    insertLocked(key, metadata);
+                    ++m_persistentHits;
+                    return metadata;
+                }
+                Logger::getInstance().warn("Discarding unreadable cached metadata: " + errs);
+            }
+        } catch (const std::exception& e) {
+            Logger::getInstance().warn("Metadata cache lookup failed: " + std::string(e.what()));
+        }
+    }
+
+    ++m_misses;
+    return std::nullopt;
+}
+
+void MetadataCache::put(const std::string& key, const MediaInfo& metadata) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        insertLocked(key, metadata);
+    }
+
+    if (m_repository) {
+        Json::StreamWriterBuilder writerBuilder;
+        writerBuilder["indentation"] = "";
+        try {
+            // The entry is already served from memory, so the probe need not wait for the write
+            m_repository->saveMetadataAsync(key, Json::writeString(writerBuilder, metadata.toJson()),
+                                            [](const bool stored) {
+                                                if (!stored) {
+                                                    Logger::getInstance().warn("Failed to persist metadata cache entry.");
+                                                }
+                                            });
+        } catch (const std::exception& e) {
+            Logger::getInstance().warn("Failed to persist metadata cache entry: " + std::string(e.what()));
+        }
+        pruneIfDue();
+    }
+}
+
+std::optional<KeyframeIndex> MetadataCache::getKeyframeIndex(const std::string& key) const {
+    if (!m_repository) {
+        return std::nullopt;
+    }
+    try {
+        if (const auto stored = m_repository->getKeyframeIndex(key)) {
+            if (auto index = KeyframeIndex::deserialize(*stored)) {
+                return index;
+            }
+            Logger::getInstance().warn("Discarding unreadable keyframe index.");
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().warn("Keyframe index lookup failed: " + std::string(e.what()));
+    }
+    return std::nullopt;
+}
+
+void MetadataCache::putKeyframeIndex(const std::string& key, const KeyframeIndex& index) const {
+    if (!m_repository) {
+        return;
+    }
+    try {
+        if (!m_repository->saveKeyframeIndex(key, index.serialize())) {
+            Logger::getInstance().warn("Failed to persist keyframe index.");
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().warn("Failed to persist keyframe index: " + std::string(e.what()));
+    }
+    pruneIfDue();
+}
+
+MetadataCache::Stats MetadataCache::getStats() const {
+    Stats stats;
+    stats.memoryHits = m_memoryHits.load();
+    stats.persistentHits = m_persistentHits.load();
+    stats.misses = m_misses.load();
+    return stats;
+}
+
+void MetadataCache::insertLocked(const std::string& key, const MediaInfo& metadata) {
+    if (const auto it = m_index.find(key); it != m_index.end()) {
+        it->second->second = metadata;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+
+    m_entries.emplace_front(key, metadata);
+    m_index[key] = m_entries.begin();
+
+    if (m_entries.size() > m_capacity) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+}
+
+void MetadataCache::pruneIfDue() const {
+    if (m_maxAge.count() <= 0) {
+        return;
+    }
+
+    // Only the caller that advances the timestamp prunes; concurrent writers skip it
+    const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto last = m_lastPrune.load();
+    const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::hours(1)).count();
+    if ((last != 0 && now - last < interval) || !m_lastPrune.compare_exchange_strong(last, now)) {
+        return;
+    }
+
+    try {
+        m_repository->prune(std::chrono::system_clock::now() - m_maxAge, [](const int removed) {
+            if (removed < 0) {
+                Logger::getInstance().warn("Failed to prune the metadata cache.");
+            } else if (removed > 0) {
+                Logger::getInstance().info("Pruned " + std::to_string(removed) + " unused metadata cache entries.");
+            }
+        });
+    } catch (const std::exception& e) {
+        Logger::getInstance().warn("Failed to prune the metadata cache: " + std::string(e.what()));
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef METADATA_CACHE_HPP
+#define METADATA_CACHE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include "KeyframeIndex.hpp"
+#include "MediaInfo.hpp"
+#include "repositories/MetadataCacheRepository.hpp"
+
+/**
+ * MetadataCache keeps merged metadata in an in-memory LRU, backed by an optional persistent table
+ * that stores it as JSON.
+ * Entries are keyed by the identity of the probed content (path, size, mtime and inode for local
+ * files, or the object ETag for remote objects), so a modified file simply misses the cache.
+ * The rows such misses leave behind in the persistent store are deleted once unused for the
+ * configured max age; at most once an hour, a write to the store starts that pruning.
+ * Thread-safe.
+ */
+class MetadataCache {
+public:
+    /**
+     * Counters describing cache effectiveness.
+     */
+    struct Stats {
+        std::uint64_t memoryHits = 0;
+        std::uint64_t persistentHits = 0;
+        std::uint64_t misses = 0;
+    };
+
+    /**
+     * Constructs a MetadataCache.
+     * @param capacity Maximum number of entries kept in memory.
+     * @param repository Persistent store consulted on a memory miss; nullptr for memory only.
+     * @param maxAge Persistent entries unused for longer are deleted; zero keeps them forever.
+     */
+    explicit MetadataCache(std::size_t capacity, std::shared_ptr<MetadataCacheRepository> repository = nullptr,
+                           std::chrono::seconds maxAge = std::chrono::seconds(0));
+
+    /**
+     * Builds the cache key of a local file from its path, size, modification time and inode.
+     * @param filePath The path to the media file.
+     * @return The key, or std::nullopt if the file cannot be stat'ed.
+     */
+    static std::optional<std::string> fileKey(const std::string& filePath);
+
+    /**
+     * Builds the cache key of a remote object from its URI and ETag.
+     */
+    static std::string objectKey(const std::string& uri, const std::string& etag);
+
+    /**
+     * Looks up metadata, promoting persistent hits into memory.
+     * @param key Cache key from fileKey() or objectKey().
+     * @return The cached metadata, or std::nullopt on a miss.
+     */
+    std::optional<MediaInfo> get(const std::string& key);
+
+    /**
+     * Stores metadata in memory and in the persistent store, without waiting for the latter.
+     * Persistence failures are logged and otherwise ignored.
+     */
+    void put(const std::string& key, const MediaInfo& metadata);
+
+    /**
+     * Looks up a keyframe index. Indexes are kept only in the persistent store, next to the
+     * metadata, since they are large and read once per planned job rather than per request.
+     * @param key Cache key from fileKey() or objectKey().
+     * @return The index, or std::nullopt if absent, unreadable or there is no persistent store.
+     */
+    std::optional<KeyframeIndex> getKeyframeIndex(const std::string& key) const;
+
+    /**
+     * Stores a keyframe index in the persistent store; a no-op without one.
+     */
+    void putKeyframeIndex(const std::string& key, const KeyframeIndex& index) const;
+
+    Stats getStats() const;
+
+private:
+    using Entry = std::pair<std::string, MediaInfo>;
+
+    /**
+     * Inserts or refreshes an in-memory entry, evicting the least recently used one if full.
+     * The caller must hold m_mutex.
+     */
+    void insertLocked(const std::string& key, const MediaInfo& metadata);
+
+    /**
+     * Deletes expired persistent entries, without waiting, if the last pruning is over an hour old.
+     */
+    void pruneIfDue() const;
+
+    std::size_t m_capacity;
+    std::shared_ptr<MetadataCacheRepository> m_repository;
+    std::chrono::seconds m_maxAge;
+    mutable std::atomic<std::int64_t> m_lastPrune{0};  // steady_clock ticks of the last pruning; 0 before the first
+    std::list<Entry> m_entries;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    mutable std::mutex m_mutex;
+
+    std::atomic<std::uint64_t> m_memoryHits{0};
+    std::atomic<std::uint64_t> m_persistentHits{0};
+    std::atomic<std::uint64_t> m_misses{0};
+};
+
+#endif // METADATA_CACHE_HPP
@@ -1,41 +1,167 @@
 #include "MetadataMerger.hpp"
+#include "utils/ConfigManager.hpp"
 #include "utils/Logger.hpp"
+#include "HeaderProbe.hpp"
+#include <algorithm>
+#include <future>
 
-MetadataMerger::MetadataMerger()
-  : ffprobeProvider(std::make_unique<FFprobeMetadataProvider>()),
-    mediaInfoProvider(std::make_unique<MediaInfoMetadataProvider>()) {}
+namespace {
 
-Json::Value MetadataMerger::getMergedMetadata(const std::string& filePath) const {
-    Json::Value ffprobeMetadata;
-    Json::Value mediaInfoMetadata;
+    std::unique_ptr<MediaMetadataProvider> createPrimaryProvider([[maybe_unused]] const MetadataMerger::Settings& settings) {
+#ifdef HAVE_LIBAVFORMAT
+        if (settings.inProcessProbe) {
+            return std::make_unique<LibavformatMetadataProvider>(settings.probeSize, settings.analyzeDurationMicros);
+        }
+#endif
+        return std::make_unique<FFprobeMetadataProvider>();
+    }
 
-    try {
-        ffprobeMetadata = ffprobeProvider->getMetadata(filePath);
-    } catch (const std::exception& e) {
-        Logger::getInstance().error("FFprobe failed: {}. Attempting MediaInfo.", e.what());
+} // namespace
+
+MetadataMerger::MetadataMerger(std::shared_ptr<MetadataCache> cache)
+  : MetadataMerger(std::move(cache), Settings{}) {}
+
+MetadataMerger::MetadataMerger(std::shared_ptr<MetadataCache> cache, const Settings& settings,
+                               HttpRangeReader::RedirectCheck checkRedirect)
+  : ffprobeProvider(createPrimaryProvider(settings)),
+    mediaInfoProvider(std::make_unique<MediaInfoMetadataProvider>()),
+    cache(std::move(cache)),
+    settings(settings),
+    checkRedirect(std::move(checkRedirect)) {}
+
+MetadataMerger::Settings MetadataMerger::loadSettings(const ConfigManager& config) {
+    Settings settings;
+    settings.ffprobeTimeout = std::chrono::milliseconds(config.get<int>("metadata.probe.ffprobe_timeout_ms", 10000));
+    settings.mediaInfoTimeout = std::chrono::milliseconds(config.get<int>("metadata.probe.mediainfo_timeout_ms", 10000));
+    settings.requiredFields = config.get<std::vector<std::string>>("metadata.probe.required_fields", {});
+    settings.inProcessProbe = config.get<bool>("metadata.probe.in_process", true);
+    settings.probeSize = config.get<std::int64_t>("metadata.probe.probesize", 5000000);
+    settings.analyzeDurationMicros = config.get<std::int64_t>("metadata.probe.analyzeduration_us", 5000000);
+    settings.remoteFastProbe = config.get<bool>("metadata.probe.remote.fast_probe", true);
+    settings.remoteByteBudget = config.get<std::uint64_t>("metadata.probe.remote.byte_budget", 1048576);
+    settings.remoteBlockSize = config.get<std::uint64_t>("metadata.probe.remote.block_size", 65536);
+    settings.keyframeIndexTimeout = std::chrono::milliseconds(config.get<int>("metadata.probe.keyframe_index_timeout_ms", 120000));
+    return settings;
+}
+
+MediaInfo MetadataMerger::getMergedMetadata(const std::string& filePath) const {
+    std::optional<std::string> cacheKey;
+    if (settings.remoteFastProbe && HttpRangeReader::isRemote(filePath)) {
+        if (auto header = probeRemoteHeader(filePath, cacheKey)) {
+            return *header;
+        }
+    } else if (cache) {
+        // Local files that cannot be stat'ed are probed every time
+        cacheKey = MetadataCache::fileKey(filePath);
+        if (cacheKey) {
+            if (auto cached = cache->get(*cacheKey)) {
+                return *cached;
+            }
+        }
     }
 
+    MediaInfo ffprobeMetadata;
+    MediaInfo mediaInfoMetadata;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<bool> mediaInfoCancelled{false};
+
+    // MediaInfo runs alongside FFprobe; the future is always waited on before returning
+    auto mediaInfoFuture = std::async(std::launch::async, [&] {
+        return mediaInfoProvider->getMetadata(filePath, start + settings.mediaInfoTimeout, &mediaInfoCancelled);
+    });
+
     try {
-        mediaInfoMetadata = mediaInfoProvider->getMetadata(filePath);
+        ffprobeMetadata = ffprobeProvider->getMetadata(filePath, start + settings.ffprobeTimeout, nullptr);
     } catch (const std::exception& e) {
-        Logger::getInstance().error("MediaInfo failed:  {}. Using FFprobe data only.", e.what());
+        Logger::getInstance().error("FFprobe failed: ", e.what(), ". Attempting MediaInfo.");
+    }
+
+    if (!ffprobeMetadata.empty() && coversRequiredFields(ffprobeMetadata)) {
+        // FFprobe already has everything needed; stop MediaInfo rather than wait for it
+        mediaInfoCancelled = true;
+        mediaInfoFuture.wait();
+    } else {
+        try {
+            mediaInfoMetadata = mediaInfoFuture.get();
+        } catch (const std::exception& e) {
+            Logger::getInstance().error("MediaInfo failed: ", e.what(), ". Using FFprobe data only.");
+        }
+    }
+
+    if (ffprobeMetadata.empty() && mediaInfoMetadata.empty()) {
+        throw std::runtime_error("Neither FFprobe nor MediaInfo returned metadata in time.");
     }
 
-    if (ffprobeMetadata.isNull() && mediaInfoMetadata.isNull()) {
-        throw std::runtime_error("Both FFprobe and MediaInfo failed to retrieve metadata.");
+    ffprobeMetadata.mergeFrom(mediaInfoMetadata);
+    if (cacheKey) {
+        cache->put(*cacheKey, ffprobeMetadata);
     }
+    return ffprobeMetadata;
+}
 
-    return mergeStreamData(ffprobeMetadata, mediaInfoMetadata);
+std::optional<MediaInfo> MetadataMerger::probeRemoteHeader(const std::string& url, std::optional<std::string>& cacheKey) const {
+    try {
+        HttpRangeReader reader(url, settings.remoteByteBudget, settings.remoteBlockSize,
+                               std::chrono::steady_clock::now() + settings.ffprobeTimeout, checkRedirect);
+
+        // The ETag identifies the object version; the query string (e.g. a URL signature) does not
+        if (cache && !reader.etag().empty()) {
+            cacheKey = MetadataCache::objectKey(url.substr(0, url.find('?')), reader.etag());
+            if (auto cached = cache->get(*cacheKey)) {
+                return cached;
+            }
+        }
+
+        MediaInfo header = HeaderProbe::probe(reader);
+        if (isComplete(header)) {
+            Logger::getInstance().debug("Header probe of ", url, " read ", reader.bytesFetched(), " bytes");
+            if (cacheKey) {
+                cache->put(*cacheKey, header);
+            }
+            return header;
+        }
+        Logger::getInstance().info("Header probe of ", url, " is missing stream info, running a full probe");
+    } catch (const RedirectRefused&) {
+        throw;
+    } catch (const std::exception& e) {
+        Logger::getInstance().info("Header probe of ", url, " failed: ", e.what(), ". Running a full probe.");
+    }
+    return std::nullopt;
 }
 
-Json::Value MetadataMerger::mergeStreamData(const Json::Value& primary, const Json::Value& secondary) {
-    Json::Value merged = primary;
+bool MetadataMerger::isComplete(const MediaInfo& metadata) const {
+    if (!settings.requiredFields.empty()) {
+        return coversRequiredFields(metadata);
+    }
+    return !metadata.streams.empty() &&
+           std::all_of(metadata.streams.begin(), metadata.streams.end(),
+                       [](const StreamInfo& stream) { return !stream.codecName.empty(); });
+}
 
-    for (const auto& key : secondary.getMemberNames()) {
-        if (!merged.isMember(key) || merged[key].isNull()) {
-            merged[key] = secondary[key];
+KeyframeIndex MetadataMerger::getKeyframeIndex(const std::string& filePath) const {
+    const auto cacheKey = cache ? MetadataCache::fileKey(filePath) : std::nullopt;
+    if (cacheKey) {
+        if (auto cached = cache->getKeyframeIndex(*cacheKey)) {
+            return std::move(*cached);
         }
     }
 
-    return merged;
-}
\ No newline at end of file
+    KeyframeIndex index = keyframeIndexer.build(filePath, std::chrono::steady_clock::now() + settings.keyframeIndexTimeout);
+    if (cacheKey) {
+        cache->putKeyframeIndex(*cacheKey, index);
+    }
+    return index;
+}
+
+bool MetadataMerger::coversRequiredFields(const MediaInfo& metadata) const {
+    if (settings.requiredFields.empty()) {
+        return false;
+    }
+    for (const auto& field : settings.requiredFields) {
+        if (!metadata.hasField(field)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -3,41 +3,117 @@
 
 #include "FFprobeMetadataProvider.hpp"
 #include "MediaInfoMetadataProvider.hpp"
-#include <json/json.h>
+#include "LibavformatMetadataProvider.hpp"
+#include "KeyframeIndexer.hpp"
+#include "MetadataCache.hpp"
+#include "RangeReader.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+class ConfigManager;
 
 /**
  * MetadataMerger is a utility class for retrieving and merging metadata from multiple providers.
  * It uses both FFprobe and MediaInfo providers to retrieve metadata and then merges them,
- * allowing for more complete metadata coverage.
+ * allowing for more complete metadata coverage. Merged results can be memoized in a MetadataCache
+ * so that repeated requests for an unchanged file skip both probes.
+ *
+ * Both providers run concurrently, each under its own deadline; a provider that misses its deadline
+ * is killed and the merge proceeds with whatever arrived in time. When FFprobe alone already covers
+ * the required fields, MediaInfo is cancelled instead of waited for.
+ *
+ * Remote http(s) inputs are first probed from their container header through ranged reads under a
+ * byte budget; the full probe runs only when the header lacks the needed stream information.
  */
 class MetadataMerger {
 public:
+    /**
+     * Probe limits and the fields that make MediaInfo unnecessary.
+     */
+    struct Settings {
+        std::chrono::milliseconds ffprobeTimeout{10000};
+        std::chrono::milliseconds mediaInfoTimeout{10000};
+        /// Fields such as "format.duration" or "streams.codec_name" (checked on every stream), see MediaInfo::hasField.
+        /// Empty means MediaInfo is always merged in.
+        std::vector<std::string> requiredFields;
+        /// Probe with libavformat in-process instead of spawning ffprobe (needs HAVE_LIBAVFORMAT).
+        bool inProcessProbe = true;
+        std::int64_t probeSize = 5000000;               ///< Bytes libavformat may read to detect streams
+        std::int64_t analyzeDurationMicros = 5000000;   ///< Stream duration libavformat may analyze
+        bool remoteFastProbe = true;              ///< Probe http(s) inputs from their header via ranged reads first
+        std::uint64_t remoteByteBudget = 1048576;  ///< Most bytes a header probe may fetch before falling back
+        std::uint64_t remoteBlockSize = 65536;     ///< Size of each ranged read
+        std::chrono::milliseconds keyframeIndexTimeout{120000};  ///< Budget for the demux pass of getKeyframeIndex()
+    };
+
     /**
      * Constructor for MetadataMerger, initializing with specific metadata providers.
+     * @param cache Optional cache of merged metadata; nullptr disables caching.
+     */
+    explicit MetadataMerger(std::shared_ptr<MetadataCache> cache = nullptr);
+
+    /**
+     * Constructor for MetadataMerger with explicit probe settings.
+     * @param cache Optional cache of merged metadata; nullptr disables caching.
+     * @param settings Probe deadlines and required fields.
+     * @param checkRedirect Accepts or refuses each redirect a remote header probe meets; empty refuses all.
+     */
+    MetadataMerger(std::shared_ptr<MetadataCache> cache, const Settings& settings,
+                   HttpRangeReader::RedirectCheck checkRedirect = {});
+
+    /**
+     * Reads probe settings from the "metadata.probe" configuration section.
      */
-    MetadataMerger();
+    static Settings loadSettings(const ConfigManager& config);
 
     /**
-     * Retrieves and merges metadata for the specified file by calling both FFprobe and MediaInfo.
-     * Any missing fields in one provider's metadata will be filled by the other.
+     * Retrieves and merges metadata for the specified file by calling both FFprobe and MediaInfo concurrently.
+     * Any missing fields in one provider's metadata will be filled by the other, stream by stream.
      * @param filePath The path to the media file.
-     * @return The merged JSON metadata object.
-     * @throws std::runtime_error if both providers fail to retrieve metadata.
+     * @return The merged metadata; convert with MediaInfo::toJson() at the API boundary.
+     * @throws std::runtime_error if neither provider returns metadata before its deadline.
      */
-    Json::Value getMergedMetadata(const std::string& filePath) const;
+    MediaInfo getMergedMetadata(const std::string& filePath) const;
+
+    /**
+     * Returns the keyframe index of the file, building it with a single demux pass on first use.
+     * Built indexes are stored next to the cached metadata, keyed by the same file identity.
+     * @param filePath The path to the media file.
+     * @return The keyframe and packet-size index of the file's video streams.
+     * @throws std::runtime_error if the file cannot be indexed before the deadline.
+     */
+    KeyframeIndex getKeyframeIndex(const std::string& filePath) const;
 
 private:
-    std::unique_ptr<FFprobeMetadataProvider> ffprobeProvider;
+    std::unique_ptr<MediaMetadataProvider> ffprobeProvider;  ///< ffprobe, or libavformat in-process
     std::unique_ptr<MediaInfoMetadataProvider> mediaInfoProvider;
+    KeyframeIndexer keyframeIndexer;
+    std::shared_ptr<MetadataCache> cache;
+    Settings settings;
+    HttpRangeReader::RedirectCheck checkRedirect;
+
+    /**
+     * Probes a remote input from its container header within the byte budget.
+     * @param url The http(s) URL of the input.
+     * @param cacheKey Receives the object's cache key when its ETag is known, for the full probe to reuse.
+     * @return The metadata, or std::nullopt if a full probe is needed.
+     * @throws RedirectRefused if the server redirected to a refused target; the full probe would follow it too.
+     */
+    std::optional<MediaInfo> probeRemoteHeader(const std::string& url, std::optional<std::string>& cacheKey) const;
+
+    /**
+     * Checks whether a header probe found enough to skip the full probe: the required fields if any are
+     * configured, otherwise at least one stream and a codec for every stream.
+     */
+    bool isComplete(const MediaInfo& metadata) const;
 
     /**
-     * Helper function to merge two JSON objects for specific stream or format data.
-     * Fields from the secondary object will only be added if they are missing or null in the primary object.
-     * @param primaryStream The primary JSON object for a specific stream or format.
-     * @param secondaryStream The secondary JSON object for a specific stream or format.
-     * @return The merged JSON object for the specific stream or format.
+     * Checks whether the metadata contains every required field.
+     * @param metadata Metadata returned by a provider.
+     * @return True if requiredFields is non-empty and all of them are known.
      */
-    static Json::Value mergeStreamData(const Json::Value& primaryStream, const Json::Value& secondaryStream);
+    bool coversRequiredFields(const MediaInfo& metadata) const;
 };
 
 #endif // METADATA_MERGER_HPP
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "Mp4HeaderParser.hpp"
+
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    // Largest box payload read into memory; larger boxes of interest are malformed for our purposes
+    constexpr std::uint64_t kMaxPayload = 1 << 20;
+
+    struct Box {
+        std::string type;
+        std::uint64_t payloadOffset = 0;
+        std::uint64_t payloadSize = 0;
+    };
+
+    std::uint64_t readBigEndian(const std::string& data, const std::size_t offset, const std::size_t bytes) {
+        if (offset + bytes > data.size()) {
+            throw std::runtime_error("Truncated MP4 box");
+        }
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < bytes; ++i) {
+            value = value << 8 | static_cast<unsigned char>(data[offset + i]);
+        }
+        return value;
+    }
+
+    // Lists the boxes in [begin, end); each costs one 16-byte header read
+    std::vector<Box> children(RangeReader& reader, std::uint64_t begin, const std::uint64_t end) {
+        std::vector<Box> boxes;
+        while (begin + 8 <= end) {
+            const std::string header = reader.read(begin, 16);
+            if (header.size() < 8) {
+                break;
+            }
+            std::uint64_t size = readBigEndian(header, 0, 4);
+            std::uint64_t headerSize = 8;
+            if (size == 1) {
+                size = readBigEndian(header, 8, 8);
+                headerSize = 16;
+            } else if (size == 0) {
+                size = end - begin;  // Box extends to the end of its parent
+            }
+            if (size < headerSize || begin + size > end) {
+                break;  // Malformed or truncated; keep what was found so far
+            }
+            boxes.push_back({header.substr(4, 4), begin + headerSize, size - headerSize});
+            begin += size;
+        }
+        return boxes;
+    }
+
+    const Box* find(const std::vector<Box>& boxes, const std::string& type) {
+        for (const auto& box : boxes) {
+            if (box.type == type) {
+                return &box;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string payload(RangeReader& reader, const Box& box) {
+        if (box.payloadSize > kMaxPayload) {
+            throw std::runtime_error("MP4 " + box.type + " box too large for a header probe");
+        }
+        return reader.read(box.payloadOffset, box.payloadSize);
+    }
+
+    // Full-box fields after version/flags, with 32- or 64-bit times depending on the version
+    struct TimeInfo {
+        std::uint64_t timescale = 0;
+        std::uint64_t duration = 0;
+        std::size_t next = 0;  // Offset just after the duration field
+    };
+
+    TimeInfo readTimes(const std::string& data) {
+        TimeInfo info;
+        if (readBigEndian(data, 0, 1) == 1) {
+            info.timescale = readBigEndian(data, 20, 4);
+            info.duration = readBigEndian(data, 24, 8);
+            info.next = 32;
+        } else {
+            info.timescale = readBigEndian(data, 12, 4);
+            info.duration = readBigEndian(data, 16, 4);
+            info.next = 20;
+        }
+        return info;
+    }
+
+    std::string codecName(const std::string& fourcc) {
+        static const std::map<std::string, std::string> kCodecs = {
+            {"avc1", "h264"}, {"avc3", "h264"}, {"hvc1", "hevc"}, {"hev1", "hevc"}, {"av01", "av1"},
+            {"vp09", "vp9"}, {"vp08", "vp8"}, {"mp4v", "mpeg4"}, {"apch", "prores"}, {"apcn", "prores"},
+            {"apcs", "prores"}, {"apco", "prores"}, {"ap4h", "prores"}, {"mp4a", "aac"}, {"ac-3", "ac3"},
+            {"ec-3", "eac3"}, {"Opus", "opus"}, {"fLaC", "flac"}, {"alac", "alac"}, {"tx3g", "mov_text"},
+            {"wvtt", "webvtt"}, {"stpp", "ttml"}};
+        const auto it = kCodecs.find(fourcc);
+        return it != kCodecs.end() ? it->second : fourcc;
+    }
+
+    std::string codecType(const std::string& handler) {
+        if (handler == "vide") return "video";
+        if (handler == "soun") return "audio";
+        if (handler == "sbtl" || handler == "subt" || handler == "text") return "subtitle";
+        return "data";
+    }
+
+    // ISO-639-2/T code packed as three 5-bit letters
+    std::string language(const std::uint64_t packed) {
+        std::string code;
+        for (int shift = 10; shift >= 0; shift -= 5) {
+            code.push_back(static_cast<char>(((packed >> shift) & 0x1F) + 0x60));
+        }
+        return code == "und" || code[0] < 'a' || code[0] > 'z' ? std::string() : code;
+    }
+
+    StreamInfo parseTrack(RangeReader& reader, const Box& trak, const int index) {
+        StreamInfo stream;
+        stream.index = index;
+
+        const auto trakChildren = children(reader, trak.payloadOffset, trak.payloadOffset + trak.payloadSize);
+        const Box* mdia = find(trakChildren, "mdia");
+        if (!mdia) {
+            throw std::runtime_error("MP4 track without mdia box");
+        }
+        const auto mdiaChildren = children(reader, mdia->payloadOffset, mdia->payloadOffset + mdia->payloadSize);
+
+        std::uint64_t timescale = 0;
+        std::uint64_t mediaDuration = 0;
+        if (const Box* mdhd = find(mdiaChildren, "mdhd")) {
+            const std::string data = payload(reader, *mdhd);
+            const TimeInfo times = readTimes(data);
+            timescale = times.timescale;
+            mediaDuration = times.duration;
+            stream.language = language(readBigEndian(data, times.next, 2));
+            if (timescale > 0) {
+                stream.duration = static_cast<double>(mediaDuration) / static_cast<double>(timescale);
+            }
+        }
+        if (const Box* hdlr = find(mdiaChildren, "hdlr")) {
+            stream.codecType = codecType(payload(reader, *hdlr).substr(8, 4));
+        }
+
+        const Box* minf = find(mdiaChildren, "minf");
+        const auto minfChildren = minf ? children(reader, minf->payloadOffset, minf->payloadOffset + minf->payloadSize)
+                                       : std::vector<Box>();
+        const Box* stbl = find(minfChildren, "stbl");
+        const auto stblChildren = stbl ? children(reader, stbl->payloadOffset, stbl->payloadOffset + stbl->payloadSize)
+                                       : std::vector<Box>();
+
+        if (const Box* stsd = find(stblChildren, "stsd")) {
+            // Only the first sample entry header is needed: size(4) format(4) then type-specific fields
+            const std::string data = reader.read(stsd->payloadOffset, std::min<std::uint64_t>(stsd->payloadSize, 64));
+            if (readBigEndian(data, 4, 4) > 0) {
+                const std::string entry = data.substr(8);
+                stream.codecName = codecName(entry.substr(4, 4));
+                if (stream.codecType == "video") {
+                    stream.width = static_cast<int>(readBigEndian(entry, 32, 2));
+                    stream.height = static_cast<int>(readBigEndian(entry, 34, 2));
+                } else if (stream.codecType == "audio") {
+                    stream.channels = static_cast<int>(readBigEndian(entry, 24, 2));
+                    stream.sampleRate = static_cast<int>(readBigEndian(entry, 32, 4) >> 16);
+                }
+            }
+        }
+
+        if (const Box* stts = find(stblChildren, "stts");
+            stts && stts->payloadSize <= kMaxPayload && stream.codecType == "video" && timescale > 0) {
+            // Average frame rate = samples / duration; stts is a short run-length table for constant-rate video
+            const std::string data = payload(reader, *stts);
+            const std::uint64_t entries = readBigEndian(data, 4, 4);
+            std::uint64_t samples = 0;
+            std::uint64_t ticks = 0;
+            for (std::uint64_t i = 0; i < entries; ++i) {
+                const std::uint64_t count = readBigEndian(data, 8 + i * 8, 4);
+                samples += count;
+                ticks += count * readBigEndian(data, 12 + i * 8, 4);
+            }
+            if (ticks > 0) {
+                stream.frameRate = static_cast<double>(samples) * static_cast<double>(timescale) / static_cast<double>(ticks);
+            }
+        }
+
+        return stream;
+    }
+
+} // namespace
+
+bool Mp4HeaderParser::isMp4(const std::string& header) {
+    if (header.size() < 8) {
+        return false;
+    }
+    const std::string type = header.substr(4, 4);
+    return type == "ftyp" || type == "moov" || type == "mdat" || type == "free" || type == "wide" || type == "skip";
+}
+
+MediaInfo Mp4HeaderParser::parse(RangeReader& reader) {
+    const auto topLevel = children(reader, 0, reader.size());
+    const Box* moov = find(topLevel, "moov");
+    if (!moov) {
+        throw std::runtime_error("No moov box found");
+    }
+
+    MediaInfo info;
+    info.format.formatName = "mov,mp4,m4a,3gp,3g2,mj2";
+    info.format.size = static_cast<std::int64_t>(reader.size());
+
+    const auto moovChildren = children(reader, moov->payloadOffset, moov->payloadOffset + moov->payloadSize);
+    if (const Box* mvhd = find(moovChildren, "mvhd")) {
+        const TimeInfo times = readTimes(payload(reader, *mvhd));
+        if (times.timescale > 0) {
+            info.format.duration = static_cast<double>(times.duration) / static_cast<double>(times.timescale);
+        }
+    }
+    if (info.format.duration > 0) {
+        info.format.bitRate = static_cast<std::int64_t>(static_cast<double>(info.format.size) * 8.0 / info.format.duration);
+    }
+
+    int index = 0;
+    for (const auto& box : moovChildren) {
+        if (box.type == "trak") {
+            info.streams.push_back(parseTrack(reader, box, index++));
+        }
+    }
+    return info;
+}
@@ -0,0 +1,32 @@
+#ifndef MP4_HEADER_PARSER_HPP
+#define MP4_HEADER_PARSER_HPP
+
+#include "MediaInfo.hpp"
+#include "RangeReader.hpp"
+#include <cstdint>
+#include <string>
+
+/**
+ * Mp4HeaderParser extracts MediaInfo from an ISO-BMFF (MP4/MOV/M4A) file by walking its box
+ * tree through a RangeReader. Only box headers and the small boxes that describe tracks
+ * (mvhd, tkhd, mdhd, hdlr, stsd, stts) are read; sample tables and media data are skipped, so
+ * the I/O stays in the kilobytes wherever the moov box sits in the file.
+ */
+class Mp4HeaderParser {
+public:
+    /**
+     * Checks the first bytes of a file for an ISO-BMFF box signature.
+     */
+    static bool isMp4(const std::string& header);
+
+    /**
+     * Parses the moov box.
+     * @param reader Reader positioned on the file.
+     * @return The container and per-track metadata.
+     * @throws std::runtime_error if the file has no moov box or it is malformed.
+     * @throws ByteBudgetExceeded if reaching the moov box needs more I/O than allowed.
+     */
+    static MediaInfo parse(RangeReader& reader);
+};
+
+#endif // MP4_HEADER_PARSER_HPP
@@ -0,0 +1,240 @@
+#include "RangeReader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <curl/curl.h>
+
+RangeReader::RangeReader(const std::uint64_t byteBudget, const std::uint64_t blockSize)
+    : m_byteBudget(byteBudget), m_blockSize(std::max<std::uint64_t>(blockSize, 512)) {}
+
+std::string RangeReader::read(const std::uint64_t offset, const std::uint64_t length) {
+    const std::uint64_t objectSize = size();
+    if (offset >= objectSize || length == 0) {
+        return {};
+    }
+    const std::uint64_t end = std::min(objectSize, offset + length);
+
+    std::string result;
+    result.reserve(end - offset);
+    for (std::uint64_t position = offset; position < end;) {
+        const std::uint64_t index = position / m_blockSize;
+        const std::string& data = block(index);
+        const std::uint64_t blockOffset = position - index * m_blockSize;
+        if (blockOffset >= data.size()) {
+            break;  // Short block: the object ended early
+        }
+        const std::uint64_t count = std::min<std::uint64_t>(data.size() - blockOffset, end - position);
+        result.append(data, blockOffset, count);
+        position += count;
+    }
+    return result;
+}
+
+const std::string& RangeReader::block(const std::uint64_t index) {
+    if (const auto it = m_blocks.find(index); it != m_blocks.end()) {
+        return it->second;
+    }
+
+    const std::uint64_t offset = index * m_blockSize;
+    const std::uint64_t length = std::min(m_blockSize, size() - offset);
+    if (m_bytesFetched + length > m_byteBudget) {
+        throw ByteBudgetExceeded("Header probe exceeded its budget of " + std::to_string(m_byteBudget) + " bytes");
+    }
+    m_bytesFetched += length;
+    return m_blocks.emplace(index, fetch(offset, length)).first->second;
+}
+
+namespace {
+
+    // Enough for CDN and pre-signed URL hops without letting a server bounce a probe around indefinitely
+    constexpr long kMaxRedirects = 5;
+
+    struct BodySink {
+        std::string data;
+        std::uint64_t limit;
+    };
+
+    std::size_t appendBody(char* data, const std::size_t size, const std::size_t count, void* userdata) {
+        auto* sink = static_cast<BodySink*>(userdata);
+        if (sink->data.size() + size * count > sink->limit) {
+            return 0;  // More than requested: the server ignored the range, abort instead of downloading it all
+        }
+        sink->data.append(data, size * count);
+        return size * count;
+    }
+
+    struct ResponseHeaders {
+        std::string etag;
+        std::string contentRange;
+    };
+
+    std::size_t captureHeader(char* data, const std::size_t size, const std::size_t count, void* userdata) {
+        const std::string line(data, size * count);
+        if (line.rfind("HTTP/", 0) == 0) {
+            *static_cast<ResponseHeaders*>(userdata) = {};  // Status line: a redirect hop's headers do not carry over
+            return size * count;
+        }
+        const auto colon = line.find(':');
+        if (colon == std::string::npos) {
+            return size * count;
+        }
+
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), [](const unsigned char c) { return std::tolower(c); });
+        std::string value = line.substr(colon + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r\n") + 1);
+
+        auto* headers = static_cast<ResponseHeaders*>(userdata);
+        if (name == "etag") {
+            headers->etag = value;
+        } else if (name == "content-range") {
+            headers->contentRange = value;
+        }
+        return size * count;
+    }
+
+} // namespace
+
+HttpRangeReader::HttpRangeReader(const std::string& url, const std::uint64_t byteBudget, const std::uint64_t blockSize,
+                                 const std::chrono::steady_clock::time_point deadline, RedirectCheck checkRedirect)
+    : RangeReader(byteBudget, blockSize), m_url(url), m_location(url), m_checkRedirect(std::move(checkRedirect)),
+      m_blockSize(blockSize), m_deadline(deadline), m_curl(curl_easy_init()) {
+    if (!m_curl) {
+        throw std::runtime_error("Failed to initialize libcurl");
+    }
+    CURL* curl = static_cast<CURL*>(m_curl);
+    curl_easy_setopt(curl, CURLOPT_URL, m_location.c_str());
+    // Only http(s), never file://, scp:// or the like, whether requested directly or through a redirect
+#if LIBCURL_VERSION_NUM >= 0x075500
+    curl_easy_setopt(curl, CURLOPT_PROTOCOLS_STR, "http,https");
+#else
+    curl_easy_setopt(curl, CURLOPT_PROTOCOLS, CURLPROTO_HTTP | CURLPROTO_HTTPS);
+#endif
+    // libcurl would follow a redirect to any host; get() follows them itself after checking each target
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 0L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+    try {
+        fetchFirstBlock();
+    } catch (...) {
+        curl_easy_cleanup(curl);
+        throw;
+    }
+}
+
+void HttpRangeReader::fetchFirstBlock() {
+    // A ranged GET rather than HEAD: pre-signed URLs are only valid for the method they were signed for
+    CURL* curl = static_cast<CURL*>(m_curl);
+    ResponseHeaders headers;
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, captureHeader);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &headers);
+    long status = 0;
+    try {
+        m_firstBlock = get(0, std::max<std::uint64_t>(m_blockSize, 512), status);
+    } catch (...) {
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, nullptr);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, nullptr);
+        throw;
+    }
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, nullptr);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, nullptr);
+
+    m_etag = headers.etag;
+    if (status == 200) {
+        // Object smaller than one block, sent whole
+        m_size = m_firstBlock.size();
+        return;
+    }
+
+    // "bytes 0-65535/123456789"
+    const auto slash = headers.contentRange.rfind('/');
+    if (slash == std::string::npos || headers.contentRange.compare(slash + 1, std::string::npos, "*") == 0) {
+        throw std::runtime_error("Server did not report the size of " + m_url);
+    }
+    m_size = std::stoull(headers.contentRange.substr(slash + 1));
+}
+
+HttpRangeReader::~HttpRangeReader() {
+    curl_easy_cleanup(static_cast<CURL*>(m_curl));
+}
+
+bool HttpRangeReader::isRemote(const std::string& path) {
+    return path.rfind("http://", 0) == 0 || path.rfind("https://", 0) == 0;
+}
+
+std::string HttpRangeReader::fetch(const std::uint64_t offset, const std::uint64_t length) {
+    if (offset == 0 && length <= m_firstBlock.size()) {
+        return m_firstBlock.substr(0, length);
+    }
+
+    long status = 0;
+    std::string body = get(offset, length, status);
+    if (status != 206) {
+        throw std::runtime_error("Server does not support range requests for " + m_url + " (HTTP " + std::to_string(status) + ")");
+    }
+    return body;
+}
+
+std::string HttpRangeReader::get(const std::uint64_t offset, const std::uint64_t length, long& status) {
+    CURL* curl = static_cast<CURL*>(m_curl);
+    const std::string range = std::to_string(offset) + "-" + std::to_string(offset + length - 1);
+
+    curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, appendBody);
+
+    for (long hops = 0;; ++hops) {
+        BodySink body{{}, length};
+        body.data.reserve(length);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+        applyTimeout();
+
+        const CURLcode code = curl_easy_perform(curl);
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        if (code == CURLE_WRITE_ERROR) {
+            // The sink refused a body longer than the requested range
+            throw std::runtime_error("Server does not support range requests for " + m_url);
+        }
+        if (code != CURLE_OK) {
+            throw std::runtime_error("Range request to " + m_url + " failed: " + curl_easy_strerror(code));
+        }
+        if (status >= 400) {
+            throw std::runtime_error("Range request to " + m_url + " failed: HTTP " + std::to_string(status));
+        }
+        if (status < 300) {
+            return std::move(body.data);
+        }
+
+        char* target = nullptr;
+        curl_easy_getinfo(curl, CURLINFO_REDIRECT_URL, &target);
+        if (!target) {
+            throw std::runtime_error("Range request to " + m_url + " failed: HTTP " + std::to_string(status));
+        }
+        followRedirect(target, hops);
+    }
+}
+
+void HttpRangeReader::followRedirect(const std::string& target, const long hops) {
+    if (hops >= kMaxRedirects) {
+        throw RedirectRefused("Range request to " + m_url + " exceeded " + std::to_string(kMaxRedirects) + " redirects");
+    }
+    if (!m_checkRedirect) {
+        throw RedirectRefused("Range request to " + m_url + " was redirected to " + target);
+    }
+    try {
+        m_checkRedirect(target);
+    } catch (const std::exception& e) {
+        throw RedirectRefused("Range request to " + m_url + " was redirected to " + target + ": " + e.what());
+    }
+    // Later blocks go straight to the accepted target instead of repeating the hops
+    m_location = target;
+    curl_easy_setopt(static_cast<CURL*>(m_curl), CURLOPT_URL, m_location.c_str());
+}
+
+void HttpRangeReader::applyTimeout() {
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0) {
+        throw std::runtime_error("Header probe of " + m_url + " timed out");
+    }
+    curl_easy_setopt(static_cast<CURL*>(m_curl), CURLOPT_TIMEOUT_MS, static_cast<long>(remaining.count()));
+}
@@ -0,0 +1,151 @@
+#ifndef RANGE_READER_HPP
+#define RANGE_READER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Thrown when a header probe would need more bytes than its budget allows.
+ */
+class ByteBudgetExceeded final : public std::runtime_error {
+public:
+    explicit ByteBudgetExceeded(const std::string& message) : std::runtime_error(message) {}
+};
+
+/**
+ * Thrown when a server redirects a ranged read to a URL the reader may not follow.
+ */
+class RedirectRefused final : public std::runtime_error {
+public:
+    explicit RedirectRefused(const std::string& message) : std::runtime_error(message) {}
+};
+
+/**
+ * RangeReader gives random access to a remote object through ranged reads.
+ * Reads are served from fixed-size blocks fetched on demand, so the many small reads of a
+ * header parser cost a handful of requests, and every fetched byte is charged against a budget.
+ * Not thread-safe.
+ */
+class RangeReader {
+public:
+    /**
+     * @param byteBudget Maximum number of bytes fetched over the reader's lifetime.
+     * @param blockSize Granularity of fetches.
+     */
+    RangeReader(std::uint64_t byteBudget, std::uint64_t blockSize);
+    virtual ~RangeReader() = default;
+
+    /**
+     * Total size of the object in bytes.
+     */
+    virtual std::uint64_t size() = 0;
+
+    /**
+     * Reads up to length bytes at offset; fewer are returned only at the end of the object.
+     * @throws ByteBudgetExceeded if the read needs blocks beyond the budget.
+     * @throws std::runtime_error if a fetch fails.
+     */
+    std::string read(std::uint64_t offset, std::uint64_t length);
+
+    /**
+     * Bytes fetched so far.
+     */
+    [[nodiscard]] std::uint64_t bytesFetched() const { return m_bytesFetched; }
+
+protected:
+    /**
+     * Fetches [offset, offset + length) from the object; length never crosses the end of the object.
+     */
+    virtual std::string fetch(std::uint64_t offset, std::uint64_t length) = 0;
+
+private:
+    const std::string& block(std::uint64_t index);
+
+    std::uint64_t m_byteBudget;
+    std::uint64_t m_blockSize;
+    std::uint64_t m_bytesFetched = 0;
+    std::map<std::uint64_t, std::string> m_blocks;
+};
+
+/**
+ * HttpRangeReader reads an http(s) URL (e.g. a pre-signed S3 URL) with HTTP Range requests over
+ * one reused libcurl connection. The object's size and ETag come from the response to the first block.
+ * Only http and https are spoken. Redirects are followed one hop at a time, at most five, and only once
+ * the redirect check accepts the target, so an allowed host cannot bounce the probe to an internal
+ * address. main() runs curl_global_init() before any reader is created.
+ */
+class HttpRangeReader final : public RangeReader {
+public:
+    /**
+     * Checks a redirect target before it is followed; throws to refuse it.
+     */
+    using RedirectCheck = std::function<void(const std::string& url)>;
+
+    /**
+     * @param url The object URL; the server must support byte ranges.
+     * @param byteBudget Maximum number of bytes fetched.
+     * @param blockSize Granularity of range requests.
+     * @param deadline Point in time after which requests fail.
+     * @param checkRedirect Accepts or refuses each redirect target; empty refuses every redirect.
+     * @throws RedirectRefused if the server redirects to a target the check refuses.
+     * @throws std::runtime_error if the first request fails or the server does not report a size.
+     */
+    HttpRangeReader(const std::string& url, std::uint64_t byteBudget, std::uint64_t blockSize,
+                    std::chrono::steady_clock::time_point deadline, RedirectCheck checkRedirect = {});
+    ~HttpRangeReader() override;
+
+    std::uint64_t size() override { return m_size; }
+
+    /**
+     * ETag reported by the server, empty if none; identifies the object version for caching.
+     */
+    [[nodiscard]] const std::string& etag() const { return m_etag; }
+
+    /**
+     * Checks whether the path is an http(s) URL.
+     */
+    static bool isRemote(const std::string& path);
+
+protected:
+    std::string fetch(std::uint64_t offset, std::uint64_t length) override;
+
+private:
+    /**
+     * Fetches the first block, filling m_size and m_etag from the response headers.
+     */
+    void fetchFirstBlock();
+
+    /**
+     * Performs one ranged GET.
+     * @param status Receives the HTTP status code.
+     */
+    std::string get(std::uint64_t offset, std::uint64_t length, long& status);
+
+    /**
+     * Runs the redirect check on the target and points the handle at it.
+     * @throws RedirectRefused if the check refuses the target or the hop limit is reached.
+     */
+    void followRedirect(const std::string& target, long hops);
+
+    /**
+     * Applies the remaining time before the deadline as the request timeout.
+     */
+    void applyTimeout();
+
+    std::string m_url;
+    std::string m_location;  // URL the handle currently requests: m_url, or the last accepted redirect target
+    RedirectCheck m_checkRedirect;
+    std::uint64_t m_blockSize;
+    std::chrono::steady_clock::time_point m_deadline;
+    void* m_curl;  // CURL*, kept opaque so callers need not include curl.h
+    std::uint64_t m_size = 0;
+    std::string m_etag;
+    std::string m_firstBlock;  // Fetched by the constructor; handed to the block cache on first read
+};
+
+#endif // RANGE_READER_HPP
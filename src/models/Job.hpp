@@ -1,10 +1,13 @@
 #ifndef JOB_HPP
 #define JOB_HPP
 
+#include <chrono>
+#include <optional>
 #include <string>
 #include <vector>
 #include "utils/Logger.hpp"
 #include "JobStatus.hpp"
+#include "SegmentCheckpoint.hpp"
 
 // Job class representing a job in the system
 class Job {
@@ -12,7 +15,8 @@ public:
     // Constructor
     Job(int id, std::string inputFile, std::string outputFile, std::vector<std::string> options = {}, std::string remotePath = "")
         : id(id), inputFile(std::move(inputFile)), outputFile(std::move(outputFile)), options(std::move(options)),
-          remotePath(std::move(remotePath)), status(JobStatus::PENDING), attemptCount(0) {}
+          remotePath(std::move(remotePath)), status(JobStatus::PENDING), attemptCount(0),
+          submittedAt(std::chrono::system_clock::now()), estimatedRuntime(0) {}
 
     // Getter functions
     [[nodiscard]] int getId() const { return id; }
@@ -24,6 +28,12 @@ public:
     [[nodiscard]] std::string getStatusString() const { return JobStatusUtils::toString(status); }
     [[nodiscard]] int getAttemptCount() const { return attemptCount; }
     [[nodiscard]] std::string getMessage() const { return message; }
+    [[nodiscard]] const std::optional<std::chrono::system_clock::time_point>& getDeadline() const { return deadline; }
+    [[nodiscard]] bool hasDeadline() const { return deadline.has_value(); }
+    [[nodiscard]] std::chrono::system_clock::time_point getSubmittedAt() const { return submittedAt; }
+    [[nodiscard]] std::chrono::seconds getEstimatedRuntime() const { return estimatedRuntime; }
+    [[nodiscard]] const std::string& getTenant() const { return tenant; }
+    [[nodiscard]] const SegmentCheckpoint& getCheckpoint() const { return checkpoint; }
 
     // Setter functions
     void setStatus(JobStatus newStatus) { status = newStatus; }
@@ -32,6 +42,10 @@ public:
     void setOptions(const std::vector<std::string>& opts) { options = opts; }
     void setRemotePath(const std::string& path) { remotePath = path; }
     void incrementAttemptCount() { ++attemptCount; }
+    void setDeadline(const std::optional<std::chrono::system_clock::time_point>& time) { deadline = time; }
+    void setEstimatedRuntime(const std::chrono::seconds runtime) { estimatedRuntime = runtime; }
+    void setTenant(const std::string& name) { tenant = name; }
+    void setCheckpoint(const SegmentCheckpoint& progress) { checkpoint = progress; }
 
     // Logging function to log job details
     void logJobDetails() const {
@@ -48,6 +62,11 @@ private:
     JobStatus status;
     int attemptCount;
     std::string message;  // Error or status message for the job
+    std::optional<std::chrono::system_clock::time_point> deadline;  // Optional SLA completion deadline
+    std::chrono::system_clock::time_point submittedAt;
+    std::chrono::seconds estimatedRuntime;  // Filled in by the JobProcessor at admission
+    std::string tenant;  // Tenant that submitted the job (never a raw API key), used for fair-share scheduling
+    SegmentCheckpoint checkpoint;  // Completed segments of a segmented output, for resuming retries
 };
 
 #endif // JOB_HPP
\ No newline at end of file
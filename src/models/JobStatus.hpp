@@ -1,6 +1,7 @@
 #pragma once
 
 #include "oatpp/core/Types.hpp"
+#include <string_view>
 #include "oatpp/core/macro/codegen.hpp" ///< Include Oat++ codegen macros
 
 #include OATPP_CODEGEN_BEGIN(DTO) ///< Begin DTO codegen section
@@ -19,11 +20,12 @@ ENUM(JobStatus, v_int32,
 
 class JobStatusUtils {
 public:
-    static JobStatus fromString(const std::string& statusStr) {
+    static JobStatus fromString(std::string_view statusStr) {
         if (statusStr == "PENDING") return JobStatus::PENDING;
         if (statusStr == "COMPLETED") return JobStatus::COMPLETED;
         if (statusStr == "FAILED") return JobStatus::FAILED;
         if (statusStr == "IN_PROGRESS") return JobStatus::IN_PROGRESS;
+        if (statusStr == "CANCELLED") return JobStatus::CANCELLED;
         return JobStatus::UNKNOWN;
     }
 
@@ -39,6 +41,7 @@ public:
             case JobStatus::COMPLETED: return "COMPLETED";
             case JobStatus::FAILED: return "FAILED";
             case JobStatus::IN_PROGRESS: return "IN_PROGRESS";
+            case JobStatus::CANCELLED: return "CANCELLED";
             default: return "UNKNOWN";
         }
     }
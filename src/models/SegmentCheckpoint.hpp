@@ -0,0 +1,32 @@
+#ifndef SEGMENT_CHECKPOINT_HPP
+#define SEGMENT_CHECKPOINT_HPP
+
+#include <cstdio>
+#include <optional>
+#include <string>
+
+// Progress of a segmented encode, used to resume after a failed attempt
+struct SegmentCheckpoint {
+    int completedSegments = 0;         // Segments fully written by previous attempts
+    double resumeOffsetSeconds = 0.0;  // Input time at which the next segment starts
+
+    [[nodiscard]] bool empty() const { return completedSegments == 0; }
+
+    // Serialized form stored in the job record, e.g. "segments=12;offset=119.986000"
+    [[nodiscard]] std::string serialize() const {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "segments=%d;offset=%.6f", completedSegments, resumeOffsetSeconds);
+        return buffer;
+    }
+
+    static std::optional<SegmentCheckpoint> parse(const std::string& text) {
+        SegmentCheckpoint checkpoint;
+        if (std::sscanf(text.c_str(), "segments=%d;offset=%lf", &checkpoint.completedSegments,
+                        &checkpoint.resumeOffsetSeconds) != 2) {
+            return std::nullopt;
+        }
+        return checkpoint;
+    }
+};
+
+#endif // SEGMENT_CHECKPOINT_HPP
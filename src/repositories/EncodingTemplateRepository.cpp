@@ -1,4 +1,5 @@
 #include "EncodingTemplateRepository.hpp"
+#include "database/QueryBuilder.hpp"
 #include "utils/Logger.hpp"
 #include <stdexcept>
 #include <nlohmann/json.hpp> // Include JSON library for parsing
@@ -12,14 +13,16 @@ int EncodingTemplateRepository::createTemplate(const oatpp::Object<EncodingTempl
     // Serialize settings if not null
     std::string serializedSettings = encodingTemplate->settings ? serializeSettings(*encodingTemplate->settings.getPtr()) : "";
 
-    const std::string query = "INSERT INTO encoding_templates (id, description, ffmpeg_command, settings) VALUES (?, ?, ?, ?) RETURNING id;";
+    const auto query = QueryBuilder(m_database->dialect())
+                           .insertInto("encoding_templates")
+                           .set("id", encodingTemplate->id ? encodingTemplate->id->c_str() : "")
+                           .set("description", encodingTemplate->description ? encodingTemplate->description->c_str() : "")
+                           .set("ffmpeg_command", encodingTemplate->ffmpeg_command ? encodingTemplate->ffmpeg_command->c_str() : "")
+                           .set("settings", serializedSettings)
+                           .returningId()
+                           .build();
 
-    const int lastInsertId = m_database->executeInsertReturningId(query, {
-                                                                      encodingTemplate->id ? encodingTemplate->id->c_str() : "",
-                                                                      encodingTemplate->description ? encodingTemplate->description->c_str() : "",
-                                                                      encodingTemplate->ffmpeg_command ? encodingTemplate->ffmpeg_command->c_str() : "",
-                                                                      serializedSettings
-                                                                  });
+    const int lastInsertId = m_database->executeInsertReturningId(query.sql(), query.params);
 
     if (lastInsertId != -1) {
         Logger::getInstance().info("Encoding template created with ID: " + std::to_string(lastInsertId));
@@ -31,9 +34,13 @@ int EncodingTemplateRepository::createTemplate(const oatpp::Object<EncodingTempl
 }
 
 std::shared_ptr<EncodingTemplateDTO> EncodingTemplateRepository::getTemplateById(const std::string& templateId) const {
-    const std::string query = "SELECT id, description, ffmpeg_command, settings FROM encoding_templates WHERE id = ?;";
+    const auto query = QueryBuilder(m_database->dialect())
+                           .select({"id", "description", "ffmpeg_command", "settings"})
+                           .from("encoding_templates")
+                           .where("id = ?", {templateId})
+                           .build();
 
-    if (const auto result = m_database->fetchQuery(query, {templateId}); !result.empty()) {
+    if (const auto result = m_database->fetchQuery(query.sql(), query.params); !result.empty()) {
         return mapToEncodingTemplateDto(result[0]);
     }
 
@@ -42,8 +49,11 @@ std::shared_ptr<EncodingTemplateDTO> EncodingTemplateRepository::getTemplateById
 }
 
 std::vector<std::shared_ptr<EncodingTemplateDTO>> EncodingTemplateRepository::getAllTemplates() const {
-    const std::string query = "SELECT id, description, ffmpeg_command, settings FROM encoding_templates;";
-    const auto results = m_database->fetchQuery(query);
+    const auto query = QueryBuilder(m_database->dialect())
+                           .select({"id", "description", "ffmpeg_command", "settings"})
+                           .from("encoding_templates")
+                           .build();
+    const auto results = m_database->fetchQuery(query.sql(), query.params);
 
     std::vector<std::shared_ptr<EncodingTemplateDTO>> templates;
     templates.reserve(results.size());
@@ -59,14 +69,15 @@ bool EncodingTemplateRepository::updateTemplate(const std::string& templateId, c
     // Check if settings is not null before serializing
     std::string serializedSettings = updatedTemplate->settings ? serializeSettings(*updatedTemplate->settings.getPtr()) : "";
 
-    const std::string query = "UPDATE encoding_templates SET description = ?, ffmpeg_command = ?, settings = ? WHERE id = ?;";
+    const auto query = QueryBuilder(m_database->dialect())
+                           .update("encoding_templates")
+                           .set("description", updatedTemplate->description)
+                           .set("ffmpeg_command", updatedTemplate->ffmpeg_command)
+                           .set("settings", serializedSettings)
+                           .where("id = ?", {templateId})
+                           .build();
 
-    const bool success = m_database->executeQuery(query, {
-                                                      updatedTemplate->description,
-                                                      updatedTemplate->ffmpeg_command,
-                                                      serializedSettings,
-                                                      templateId
-                                                  });
+    const bool success = m_database->executeQuery(query.sql(), query.params);
 
     if (success) {
         Logger::getInstance().info("Updated encoding template with ID: " + templateId);
@@ -78,8 +89,11 @@ bool EncodingTemplateRepository::updateTemplate(const std::string& templateId, c
 }
 
 bool EncodingTemplateRepository::deleteTemplate(const std::string& templateId) const {
-    const std::string query = "DELETE FROM encoding_templates WHERE id = ?;";
-    const bool success = m_database->executeQuery(query, {templateId});
+    const auto query = QueryBuilder(m_database->dialect())
+                           .deleteFrom("encoding_templates")
+                           .where("id = ?", {templateId})
+                           .build();
+    const bool success = m_database->executeQuery(query.sql(), query.params);
 
     if (success) {
         Logger::getInstance().info("Deleted encoding template with ID: " + templateId);
@@ -1,5 +1,7 @@
 #include "JobRepository.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <string>
@@ -7,81 +9,366 @@
 #include "dto/JobDto.hpp"
 #include "database/QueryBuilder.hpp"
 
+namespace {
+    /**
+     * @brief JobDto fields that can be projected, and the jobs columns they are loaded from.
+     */
+    struct JobField {
+        const char* name;
+        const char* column;
+    };
+
+    constexpr JobField kJobFields[] = {
+        {"id", "id"},
+        {"inputFile", "inputFile"},
+        {"outputFile", "outputFile"},
+        {"options", "options"},
+        {"status", "status"},
+        {"templateId", "template_id"},
+        {"createdAt", "created_at"},
+    };
+
+    /**
+     * @brief Columns written by createJobs, in the order each row lists its values.
+     */
+    const std::vector<std::string> kInsertColumns = {"inputFile", "outputFile", "options", "status", "template_id", "created_at",
+                                                     "deadline"};
+
+    /**
+     * @brief Converts a status name to the integer stored in the status column.
+     *
+     * Unrecognized names are stored as UNKNOWN, as JobStatusUtils::fromString maps them.
+     */
+    std::string statusCode(const std::string& status) {
+        return std::to_string(static_cast<v_int32>(JobStatusUtils::fromString(status)));
+    }
+
+    BuiltQuery statusUpdate(const SqlDialect dialect, const int jobId, const std::string& status, const std::string& message) {
+        return QueryBuilder(dialect)
+            .update("jobs")
+            .set("status", statusCode(status))
+            .set("message", message)
+            .where("id = ?", {std::to_string(jobId)})
+            .build();
+    }
+
+    std::string nowSeconds() {
+        return std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief Converts a deadline to the value stored in the deadline column: seconds since the Unix epoch, 0 for none.
+     */
+    std::string deadlineValue(const std::optional<std::chrono::system_clock::time_point>& deadline) {
+        if (!deadline) {
+            return "0";
+        }
+        return std::to_string(std::chrono::duration_cast<std::chrono::seconds>(deadline->time_since_epoch()).count());
+    }
+
+    std::vector<std::string> jobColumns(const std::vector<std::string>& fields) {
+        std::vector<std::string> columns;
+        if (fields.empty()) {
+            for (const auto& field : kJobFields) {
+                columns.emplace_back(field.column);
+            }
+            return columns;
+        }
+
+        columns.emplace_back("id");  // Needed for the keyset of the next page
+        for (const auto& name : fields) {
+            const auto field = std::find_if(std::begin(kJobFields), std::end(kJobFields),
+                                            [&](const JobField& candidate) { return name == candidate.name; });
+            if (field == std::end(kJobFields)) {
+                throw std::invalid_argument("Unknown job field: " + name);
+            }
+            if (std::find(columns.begin(), columns.end(), field->column) == columns.end()) {
+                columns.emplace_back(field->column);
+            }
+        }
+        return columns;
+    }
+}
+
 JobRepository::JobRepository(std::shared_ptr<IDatabase> database)
     : m_database(std::move(database)) {}
 
-int JobRepository::createJob(const std::string& inputFile, const std::string& outputFile, const std::string& options, const std::string& status) const {
-        const std::string query = "INSERT INTO jobs (inputFile, outputFile, options, status) VALUES (?, ?, ?, ?);";
-        return m_database->executeInsertReturningId(query, {inputFile, outputFile, options, status});
+int JobRepository::createJob(const std::string& inputFile, const std::string& outputFile, const std::string& options,
+                             const std::string& status, const std::string& templateId,
+                             const std::optional<std::chrono::system_clock::time_point>& deadline) const {
+        const auto query = QueryBuilder(m_database->dialect())
+                               .insertInto("jobs")
+                               .set("inputFile", inputFile)
+                               .set("outputFile", outputFile)
+                               .set("options", options)
+                               .set("status", statusCode(status))
+                               .set("template_id", templateId)
+                               .set("created_at", nowSeconds())
+                               .set("deadline", deadlineValue(deadline))
+                               .returningId()
+                               .build();
+        return m_database->executeInsertReturningId(query.sql(), query.params);
+}
+
+std::vector<int> JobRepository::createJobs(const std::vector<NewJob>& jobs, const std::string& status) const {
+        const auto createdAt = nowSeconds();
+        const auto code = statusCode(status);
+        std::vector<std::vector<std::string>> rows;
+        rows.reserve(jobs.size());
+        for (const auto& job : jobs) {
+            rows.push_back({job.inputFile, job.outputFile, job.options, code, job.templateId, createdAt, deadlineValue(job.deadline)});
+        }
+        return m_database->insertRows("jobs", kInsertColumns, rows);
 }
 
 std::shared_ptr<JobDto> JobRepository::getJobById(const int jobId) const {
-        QueryBuilder builder;
-        builder.select({"id", "inputFile", "outputFile", "options", "status"})
-               .from("jobs")
-               .where("id = " + std::to_string(jobId));
+        const auto query = QueryBuilder(m_database->dialect())
+                               .select(jobColumns({}))
+                               .from("jobs")
+                               .where("id = ?", {std::to_string(jobId)})
+                               .build();
 
-        if (const auto result = m_database->fetchQuery(builder.build()); !result.empty()) {
-            return mapToJobDto(result[0]);
+        if (const auto result = m_database->fetchResult(query.sql(), query.params); !result->empty()) {
+            return mapToJobDto(result->row(0), JobColumns(*result));
         }
         return nullptr;
 }
 
 std::vector<std::shared_ptr<JobDto>> JobRepository::getAllJobs(const std::string& status ) const {
-        QueryBuilder builder;
-        builder.select({"id", "inputFile", "outputFile", "options", "status"})
+        QueryBuilder builder(m_database->dialect());
+        builder.select(jobColumns({}))
                .from("jobs");
-
         if (!status.empty()) {
-            builder.where("status = '" + status + "'");
+            builder.where("status = ?", {statusCode(status)});
         }
 
-        const auto results = m_database->fetchQuery(builder.build());
+        const auto query = builder.build();
+        const auto results = m_database->fetchResult(query.sql(), query.params);
+        const JobColumns columns(*results);
         std::vector<std::shared_ptr<JobDto>> jobs;
-        jobs.reserve(results.size());
-        for (const auto& row : results) {
-            jobs.push_back(mapToJobDto(row));
+        jobs.reserve(results->rowCount());
+        for (const auto row : *results) {
+            jobs.push_back(mapToJobDto(row, columns));
         }
         return jobs;
 }
 
+JobPage JobRepository::getJobPage(const JobPageRequest& request) const {
+        if (request.limit == 0) {
+            throw std::invalid_argument("Page limit must be positive");
+        }
+
+        QueryBuilder builder(m_database->dialect());
+        builder.select(jobColumns(request.fields))
+               .from("jobs")
+               .where("id > ?", {std::to_string(request.afterId)});
+
+        if (!request.status.empty()) {
+            builder.where("status = ?", {statusCode(request.status)});
+        }
+        if (!request.templateId.empty()) {
+            builder.where("template_id = ?", {request.templateId});
+        }
+        if (request.createdFrom) {
+            builder.where("created_at >= ?", {std::to_string(*request.createdFrom)});
+        }
+        if (request.createdUntil) {
+            builder.where("created_at < ?", {std::to_string(*request.createdUntil)});
+        }
+
+        // One extra row tells whether another page follows, without a COUNT query
+        const size_t limit = std::min<size_t>(request.limit, INT32_MAX - 1);
+        builder.orderBy("id").limit(limit + 1);
+
+        const auto query = builder.build();
+        const auto results = m_database->fetchResult(query.sql(), query.params);
+        const JobColumns columns(*results);
+        const size_t rows = std::min(results->rowCount(), limit);
+
+        JobPage page;
+        page.jobs.reserve(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            page.jobs.push_back(mapToJobDto(results->row(i), columns));
+        }
+        if (results->rowCount() > limit) {
+            page.nextAfterId = results->row(limit - 1).getInt64(columns.id);
+        }
+        return page;
+}
+
+JobRepository::PageCursor::PageCursor(std::shared_ptr<const JobRepository> repository, JobPageRequest request)
+    : m_repository(std::move(repository)), m_request(std::move(request)) {}
+
+std::shared_ptr<JobDto> JobRepository::PageCursor::next() {
+        while (m_index >= m_page.size()) {
+            if (m_lastPage) {
+                return nullptr;
+            }
+            auto page = m_repository->getJobPage(m_request);
+            m_page = std::move(page.jobs);
+            m_index = 0;
+            if (page.nextAfterId) {
+                m_request.afterId = *page.nextAfterId;
+            } else {
+                m_lastPage = true;
+            }
+        }
+        return m_page[m_index++];
+}
+
 bool JobRepository::updateJobStatus(const int jobId, const std::string& status, const std::string& message) const {
-        const std::string query = "UPDATE jobs SET status = ?, message = ? WHERE id = ?;";
-        return m_database->executeQuery(query, {status, message, std::to_string(jobId)});
+        const auto query = statusUpdate(m_database->dialect(), jobId, status, message);
+        return m_database->executeQuery(query.sql(), query.params);
+}
+
+bool JobRepository::updateJobStatuses(const std::vector<int>& jobIds, const std::string& status,
+                                      const std::string& message) const {
+        if (jobIds.empty()) {
+            return true;
+        }
+
+        const auto transaction = m_database->beginTransaction();
+        for (const int jobId : jobIds) {
+            const auto query = statusUpdate(m_database->dialect(), jobId, status, message);
+            if (transaction->executeQuery(query.sql(), query.params) <= 0) {
+                Logger::getInstance().warn("Failed to update status of job " + std::to_string(jobId));
+                transaction->rollback();
+                return false;
+            }
+        }
+        transaction->commit();
+        return true;
+}
+
+std::vector<bool> JobRepository::updateJobStatuses(const std::vector<JobStatusUpdate>& updates) const {
+        std::vector<bool> applied;
+        if (updates.empty()) {
+            return applied;
+        }
+
+        std::vector<BatchStatement> statements;
+        statements.reserve(updates.size());
+        for (const auto& update : updates) {
+            auto query = statusUpdate(m_database->dialect(), update.jobId, update.status, update.message);
+            statements.push_back({query.sql(), std::move(query.params)});
+        }
+        const auto results = m_database->executeBatch(statements);
+
+        applied.reserve(updates.size());
+        for (size_t i = 0; i < updates.size(); ++i) {
+            if (results[i] < 0) {
+                Logger::getInstance().warn("Failed to update status of job " + std::to_string(updates[i].jobId));
+            } else if (results[i] == 0) {
+                Logger::getInstance().warn("Status update for missing job " + std::to_string(updates[i].jobId) + " skipped");
+            }
+            applied.push_back(results[i] >= 0);
+        }
+        return applied;
+}
+
+bool JobRepository::updateJobCheckpoint(const int jobId, const std::string& checkpoint) const {
+        const auto query = QueryBuilder(m_database->dialect())
+                               .update("jobs")
+                               .set("checkpoint", checkpoint)
+                               .where("id = ?", {std::to_string(jobId)})
+                               .build();
+        return m_database->executeQuery(query.sql(), query.params);
+}
+
+std::vector<UnfinishedJob> JobRepository::getUnfinishedJobs() const {
+        const auto query = QueryBuilder(m_database->dialect())
+                               .select({"id", "inputFile", "outputFile", "options", "checkpoint", "deadline"})
+                               .from("jobs")
+                               .where("status IN (?, ?)", {statusCode("PENDING"), statusCode("IN_PROGRESS")})
+                               .orderBy("id")
+                               .build();
+        const auto result = m_database->fetchResult(query.sql(), query.params);
+
+        std::vector<UnfinishedJob> jobs;
+        jobs.reserve(result->rowCount());
+        for (size_t i = 0; i < result->rowCount(); ++i) {
+            const auto row = result->row(i);
+            UnfinishedJob job;
+            job.id = static_cast<int>(row.getInt64(0));
+            job.inputFile = std::string(row.getString(1));
+            job.outputFile = std::string(row.getString(2));
+            job.options = std::string(row.getOptionalString(3).value_or(""));
+            job.checkpoint = std::string(row.getOptionalString(4).value_or(""));
+            if (const auto deadline = row.getOptionalInt64(5).value_or(0); deadline > 0) {
+                job.deadline = std::chrono::system_clock::time_point(std::chrono::seconds(deadline));
+            }
+            jobs.push_back(std::move(job));
+        }
+        return jobs;
 }
 
 bool JobRepository::deleteJob(const int jobId) const {
-        const std::string query = "DELETE FROM jobs WHERE id = ?;";
-        return m_database->executeQuery(query, {std::to_string(jobId)});
+        const auto query = QueryBuilder(m_database->dialect())
+                               .deleteFrom("jobs")
+                               .where("id = ?", {std::to_string(jobId)})
+                               .build();
+        return m_database->executeQuery(query.sql(), query.params);
+}
+
+std::optional<ConnectionPoolMetrics> JobRepository::getPoolMetrics() const {
+        return m_database->getPoolMetrics();
 }
 
+JobRepository::JobColumns::JobColumns(const ResultSet& result)
+    : id(result.columnIndex("id")),
+      inputFile(result.findColumn("inputFile")),
+      outputFile(result.findColumn("outputFile")),
+      options(result.findColumn("options")),
+      status(result.findColumn("status")),
+      templateId(result.findColumn("template_id")),
+      createdAt(result.findColumn("created_at")) {}
+
 /**
  * @brief Maps a database row to a JobDto.
  *
- * This function takes a vector of strings representing a database row and maps it to
- * a JobDto object. It converts the ID, inputFile, outputFile, options, and status fields.
+ * This function reads the job fields present in the result straight from its buffers,
+ * without materializing the row as strings first.
  *
- * @param row A vector of strings, with each element representing a column value.
+ * @param row A row of a job query result.
+ * @param columns Positions of the job columns in that result.
  * @return A shared pointer to a JobDto with fields populated from the row.
- * @throws std::runtime_error if the row format is invalid.
+ * @throws std::runtime_error if the ID or status is not an integer.
  */
-std::shared_ptr<JobDto> JobRepository::mapToJobDto(const std::vector<std::string>& row) {
-        if (row.size() < 5) {
-            throw std::runtime_error("Invalid row format for JobDto mapping");
+std::shared_ptr<JobDto> JobRepository::mapToJobDto(const ResultSet::Row& row, const JobColumns& columns) {
+        const auto jobDto = JobDto::createShared();
+        jobDto->id = static_cast<v_int32>(row.getInt64(columns.id));
+        if (columns.inputFile) {
+            jobDto->inputFile = std::string(row.getString(*columns.inputFile));
+        }
+        if (columns.outputFile) {
+            jobDto->outputFile = std::string(row.getString(*columns.outputFile));
+        }
+        if (columns.options) {
+            if (const auto options = row.getOptionalString(*columns.options)) {
+                jobDto->options = std::string(*options);
+            }
+        }
+        if (columns.templateId) {
+            if (const auto templateId = row.getOptionalString(*columns.templateId); templateId && !templateId->empty()) {
+                jobDto->templateId = std::string(*templateId);
+            }
+        }
+        if (columns.createdAt) {
+            if (const auto createdAt = row.getOptionalInt64(*columns.createdAt)) {
+                jobDto->createdAt = *createdAt;
+            }
         }
 
-        const auto jobDto = JobDto::createShared();
-        jobDto->id = std::stoi(row[0]);
-        jobDto->inputFile = row[1];
-        jobDto->outputFile = row[2];
-        jobDto->options = row[3];
-
-        // Convert the status from std::string to JobStatus enum
-        try {
-            jobDto->status = JobStatusUtils::fromString(row[4]);  // Assuming JobStatus::fromString exists
-        } catch (...) {
-            Logger::getInstance().warn("Invalid job status : " + row[4]);
-            jobDto->status = JobStatus::UNKNOWN; // Assign a default value if the status is unrecognized
+        if (columns.status) {
+            // The column holds the JobStatus value; anything outside the enum reads as UNKNOWN
+            const auto status = row.getInt64(*columns.status);
+            if (status >= static_cast<v_int32>(JobStatus::PENDING) && status <= static_cast<v_int32>(JobStatus::UNKNOWN)) {
+                jobDto->status = static_cast<JobStatus>(status);
+            } else {
+                Logger::getInstance().warn("Invalid job status : " + std::to_string(status));
+                jobDto->status = JobStatus::UNKNOWN;
+            }
         }
 
         return jobDto.getPtr(); // Use getPtr() to return std::shared_ptr<JobDto>
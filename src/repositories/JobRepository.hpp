@@ -1,17 +1,75 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <string>
 #include "database/interfaces/IDatabase.hpp"
 #include "dto/JobDto.hpp"
 
+/**
+ * @brief Filters, keyset position and projection of one page of a job listing.
+ */
+struct JobPageRequest {
+    int64_t afterId = 0;                  ///< Only jobs with a greater ID are returned; 0 starts at the beginning.
+    size_t limit = 100;                   ///< Maximum number of jobs in the page.
+    std::string status;                   ///< Status filter; empty for any status.
+    std::string templateId;               ///< Encoding template filter; empty for any template.
+    std::optional<int64_t> createdFrom;   ///< Inclusive lower bound on the creation time, in seconds since the Unix epoch.
+    std::optional<int64_t> createdUntil;  ///< Exclusive upper bound on the creation time, in seconds since the Unix epoch.
+    std::vector<std::string> fields;      ///< JobDto fields to load; empty for all. The ID is always loaded.
+};
+
+/**
+ * @brief Fields of a job created through JobRepository::createJobs.
+ */
+struct NewJob {
+    std::string inputFile;   ///< Input file path.
+    std::string outputFile;  ///< Output file path.
+    std::string options;     ///< Additional encoding options.
+    std::string templateId;  ///< Encoding template the job was created from; empty for none.
+    std::optional<std::chrono::system_clock::time_point> deadline;  ///< Optional time by which the job must complete.
+};
+
+/**
+ * @brief New status of one job, for JobRepository::updateJobStatuses.
+ */
+struct JobStatusUpdate {
+    int jobId = 0;            ///< ID of the job to update.
+    std::string status;       ///< New status for the job.
+    std::string message;      ///< Message to associate with the job.
+};
+
+/**
+ * @brief A job that had not finished when the service stopped, as needed to queue it again.
+ */
+struct UnfinishedJob {
+    int id = 0;               ///< ID of the job.
+    std::string inputFile;    ///< Input file path.
+    std::string outputFile;   ///< Output file path.
+    std::string options;      ///< Additional encoding options.
+    std::string checkpoint;   ///< Serialized SegmentCheckpoint; empty if the job has none.
+    std::optional<std::chrono::system_clock::time_point> deadline;  ///< Deadline given at submission, if any.
+};
+
+/**
+ * @brief One page of a job listing.
+ */
+struct JobPage {
+    std::vector<std::shared_ptr<JobDto>> jobs;  ///< Jobs in ascending ID order.
+    std::optional<int64_t> nextAfterId;         ///< afterId of the next page; empty on the last page.
+};
+
 /**
  * @class JobRepository
  * @brief Manages CRUD operations for job records in the database.
  */
 class JobRepository {
 public:
+    class PageCursor;
+
     /**
      * @brief Constructs a JobRepository with the specified database.
      * @param database Shared pointer to the database interface.
@@ -24,11 +82,24 @@ public:
      * @param outputFile Output file path for the job.
      * @param options Additional options for the job.
      * @param status Initial status of the job.
+     * @param templateId ID of the encoding template the job was created from, if any.
+     * @param deadline Optional time by which the job must complete.
      * @return The ID of the newly created job.
      * @throws std::runtime_error if job creation fails.
      */
     [[nodiscard]] int createJob(const std::string& inputFile, const std::string& outputFile,
-                                const std::string& options, const std::string& status) const;
+                                const std::string& options, const std::string& status,
+                                const std::string& templateId = "",
+                                const std::optional<std::chrono::system_clock::time_point>& deadline = std::nullopt) const;
+
+    /**
+     * @brief Creates many jobs with one bulk insert.
+     * @param jobs Jobs to create.
+     * @param status Initial status of every job.
+     * @return The IDs of the new jobs, in the order of `jobs`.
+     * @throws std::runtime_error if the insert fails; no job is created then.
+     */
+    [[nodiscard]] std::vector<int> createJobs(const std::vector<NewJob>& jobs, const std::string& status) const;
 
     /**
      * @brief Retrieves a job by its ID.
@@ -44,6 +115,18 @@ public:
      */
     [[nodiscard]] std::vector<std::shared_ptr<JobDto>> getAllJobs(const std::string& status = "") const;
 
+    /**
+     * @brief Retrieves one page of jobs in ascending ID order.
+     *
+     * Pages are addressed by the last ID of the previous page rather than by an offset, so each page
+     * is a range scan on one of the job indexes created by SchemaMigrator however deep the listing goes.
+     *
+     * @param request Filters, position and projection of the page.
+     * @return The jobs of the page and the position of the next one.
+     * @throws std::invalid_argument if the request names an unknown field or has a zero limit.
+     */
+    [[nodiscard]] JobPage getJobPage(const JobPageRequest& request) const;
+
     /**
      * @brief Updates the status and message of a job by ID.
      * @param jobId ID of the job to update.
@@ -53,6 +136,43 @@ public:
      */
     [[nodiscard]] bool updateJobStatus(int jobId, const std::string& status, const std::string& message = "") const;
 
+    /**
+     * @brief Sets the same status and message on several jobs in one transaction.
+     * @param jobIds IDs of the jobs to update.
+     * @param status New status for the jobs.
+     * @param message Optional message to associate with the jobs.
+     * @return True if every job was updated and the transaction committed; otherwise, false and no job changes.
+     */
+    [[nodiscard]] bool updateJobStatuses(const std::vector<int>& jobIds, const std::string& status,
+                                         const std::string& message = "") const;
+
+    /**
+     * @brief Applies a different status and message to each job as one IDatabase::executeBatch.
+     *
+     * The backend sends the updates together (a pipeline on PostgreSQL, one commit on SQLite), but each
+     * one succeeds or fails on its own, so a bad row does not hold back the others.
+     *
+     * @param updates The updates to apply.
+     * @return For each update, whether it was applied or skipped because its job no longer exists; false
+     *         for the ones that failed.
+     * @throws std::runtime_error if the batch cannot be run at all.
+     */
+    [[nodiscard]] std::vector<bool> updateJobStatuses(const std::vector<JobStatusUpdate>& updates) const;
+
+    /**
+     * @brief Stores the segment checkpoint of a partially completed segmented job.
+     * @param jobId ID of the job to update.
+     * @param checkpoint Serialized SegmentCheckpoint.
+     * @return True if the job was successfully updated; otherwise, false.
+     */
+    [[nodiscard]] bool updateJobCheckpoint(int jobId, const std::string& checkpoint) const;
+
+    /**
+     * @brief Retrieves the jobs still PENDING or IN_PROGRESS, in ascending ID order.
+     * @return The jobs with their stored checkpoints.
+     */
+    [[nodiscard]] std::vector<UnfinishedJob> getUnfinishedJobs() const;
+
     /**
      * @brief Deletes a job by ID.
      * @param jobId ID of the job to delete.
@@ -60,18 +180,76 @@ public:
      */
     [[nodiscard]] bool deleteJob(int jobId) const;
 
+    /**
+     * @brief Returns the connection pool counters of the database the jobs are stored in.
+     * @return The counters, or std::nullopt if the backend has no connection pool.
+     */
+    [[nodiscard]] std::optional<ConnectionPoolMetrics> getPoolMetrics() const;
+
 private:
     std::shared_ptr<IDatabase> m_database;
 
+    /**
+     * @brief Column positions of the job fields in a result, resolved once per query.
+     *
+     * Only the ID is mandatory; fields left out of a projected query are left unset in the JobDto.
+     */
+    struct JobColumns {
+        size_t id;
+        std::optional<size_t> inputFile;
+        std::optional<size_t> outputFile;
+        std::optional<size_t> options;
+        std::optional<size_t> status;
+        std::optional<size_t> templateId;
+        std::optional<size_t> createdAt;
+
+        /**
+         * @throws std::runtime_error if the result has no ID column.
+         */
+        explicit JobColumns(const ResultSet& result);
+    };
+
     /**
      * @brief Maps a database row to a JobDto.
      *
-     * This function takes a vector of strings representing a database row and maps it to
-     * a JobDto object. It converts the ID, inputFile, outputFile, options, and status fields.
+     * This function reads the job fields present in the result straight from its buffers,
+     * without materializing the row as strings first.
      *
-     * @param row A vector of strings, with each element representing a column value.
+     * @param row A row of a job query result.
+     * @param columns Positions of the job columns in that result.
      * @return A shared pointer to a JobDto with fields populated from the row.
-     * @throws std::runtime_error if the row format is invalid.
+     * @throws std::runtime_error if the ID is not an integer.
+     */
+    [[nodiscard]] static std::shared_ptr<JobDto> mapToJobDto(const ResultSet::Row& row, const JobColumns& columns);
+};
+
+/**
+ * @class JobRepository::PageCursor
+ * @brief Walks a job listing one getJobPage() call at a time, holding no database connection in between.
+ *
+ * Meant for consumers that read at their own pace, such as HTTP clients: a slow reader only delays the
+ * next page query instead of pinning a connection and an open transaction for the whole walk. Pages are
+ * separate queries, so jobs created or deleted meanwhile may or may not be seen.
+ */
+class JobRepository::PageCursor {
+public:
+    /**
+     * @param repository Repository the pages are read from.
+     * @param request Filters, projection and page size; afterId is where the walk starts.
      */
-    [[nodiscard]] static std::shared_ptr<JobDto> mapToJobDto(const std::vector<std::string>& row);
-};
\ No newline at end of file
+    PageCursor(std::shared_ptr<const JobRepository> repository, JobPageRequest request);
+
+    /**
+     * @brief Returns the next job, reading the next page when the current one is used up.
+     * @return The job, or nullptr once all jobs have been returned.
+     * @throws std::runtime_error if reading a page fails.
+     */
+    std::shared_ptr<JobDto> next();
+
+private:
+    std::shared_ptr<const JobRepository> m_repository;
+    JobPageRequest m_request;                     ///< afterId advances past each page read.
+    std::vector<std::shared_ptr<JobDto>> m_page;  ///< Current page.
+    size_t m_index = 0;                           ///< Next job of m_page.
+    bool m_lastPage = false;                      ///< m_page is the last page of the listing.
+};
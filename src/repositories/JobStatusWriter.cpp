@@ -0,0 +1,159 @@
+#include "JobStatusWriter.hpp"
+#include <algorithm>
+#include <vector>
+#include "utils/Logger.hpp"
+
+JobStatusWriter::JobStatusWriter(std::shared_ptr<JobRepository> repository, const Settings& settings)
+    : m_repository(std::move(repository)),
+      m_settings(settings) {
+    m_settings.maxPending = std::max<std::size_t>(1, m_settings.maxPending);
+    m_settings.maxAttempts = std::max<std::size_t>(1, m_settings.maxAttempts);
+    m_thread = std::thread(&JobStatusWriter::run, this);
+}
+
+JobStatusWriter::~JobStatusWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    // The flush thread may have stopped while a retry was pending; give the buffer one last chance
+    if (!flush()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Logger::getInstance().error("Job status writer stopped with " + std::to_string(m_pending.size()) +
+                                    " unwritten status update(s)");
+    }
+}
+
+void JobStatusWriter::updateJobStatus(const int jobId, const JobStatus status, const std::string& message) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const bool wasEmpty = m_pending.empty();
+        auto [it, inserted] = m_pending.try_emplace(jobId);
+        if (!inserted) {
+            ++m_metrics.updatesCoalesced;
+        }
+        it->second.status = JobStatusUtils::toString(status);
+        it->second.message = message;
+        it->second.attempts = 0;
+        ++m_metrics.updatesRecorded;
+
+        const bool flushNow = !m_flushRequested && (isTerminal(status) || m_pending.size() >= m_settings.maxPending);
+        if (flushNow) {
+            m_flushRequested = true;
+        }
+        wake = wasEmpty || flushNow;
+    }
+    if (wake) {
+        m_condition.notify_one();
+    }
+}
+
+bool JobStatusWriter::flush() {
+    // Holding the write lock across the swap keeps batches in the order they were taken
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+
+    PendingMap batch;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        batch.swap(m_pending);
+        m_flushRequested = false;
+    }
+    if (batch.empty()) {
+        return true;
+    }
+
+    std::vector<JobStatusUpdate> updates;
+    updates.reserve(batch.size());
+    for (const auto& [jobId, pending] : batch) {
+        updates.push_back({jobId, pending.status, pending.message});
+    }
+    // Ascending IDs make concurrent writers lock rows in the same order
+    std::sort(updates.begin(), updates.end(),
+              [](const JobStatusUpdate& a, const JobStatusUpdate& b) { return a.jobId < b.jobId; });
+
+    // Each update succeeds or fails on its own, so one bad row cannot hold back the rest
+    std::vector<bool> applied;
+    try {
+        applied = m_repository->updateJobStatuses(updates);
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to write job status updates: " + std::string(e.what()));
+    }
+    for (size_t i = 0; i < applied.size(); ++i) {
+        if (applied[i]) {
+            batch.erase(updates[i].jobId);
+        }
+    }
+    const std::uint64_t written = updates.size() - batch.size();
+
+    if (batch.empty()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_metrics.flushes;
+        m_metrics.updatesWritten += written;
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_metrics.failedFlushes;
+    m_metrics.updatesWritten += written;
+    // Put the rest back; anything recorded since the swap is newer and wins
+    for (auto& [jobId, pending] : batch) {
+        if (m_pending.count(jobId)) {
+            continue;
+        }
+        if (++pending.attempts >= m_settings.maxAttempts) {
+            ++m_metrics.updatesDropped;
+            Logger::getInstance().error("Dropping status " + pending.status + " of job " + std::to_string(jobId) +
+                                        " after " + std::to_string(pending.attempts) + " failed writes");
+            continue;
+        }
+        m_pending.emplace(jobId, std::move(pending));
+    }
+    return batch.empty();
+}
+
+JobStatusWriter::Metrics JobStatusWriter::getMetrics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Metrics metrics = m_metrics;
+    metrics.pending = m_pending.size();
+    return metrics;
+}
+
+JobStatusWriter::Settings JobStatusWriter::loadSettings(const ConfigManager& config) {
+    Settings settings;
+    settings.flushInterval = std::chrono::milliseconds(config.get<int>("jobs.status_writer.flush_interval_ms", 5));
+    settings.maxPending = config.get<std::size_t>("jobs.status_writer.max_pending", 256);
+    settings.retryDelay = std::chrono::milliseconds(config.get<int>("jobs.status_writer.retry_delay_ms", 1000));
+    settings.maxAttempts = config.get<std::size_t>("jobs.status_writer.max_attempts", 30);
+    return settings;
+}
+
+void JobStatusWriter::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+        // Let more updates accumulate for one interval, unless a terminal status or a full buffer cuts it short
+        m_condition.wait_for(lock, m_settings.flushInterval, [this] { return m_stopping || m_flushRequested; });
+        if (m_stopping) {
+            break;
+        }
+
+        lock.unlock();
+        const bool written = flush();
+        lock.lock();
+
+        if (!written) {
+            // Back off so an unreachable database is not hammered every interval
+            m_condition.wait_for(lock, m_settings.retryDelay, [this] { return m_stopping; });
+        }
+    }
+}
+
+bool JobStatusWriter::isTerminal(const JobStatus status) {
+    return status == JobStatus::COMPLETED || status == JobStatus::FAILED || status == JobStatus::CANCELLED;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "models/JobStatus.hpp"
+#include "repositories/JobRepository.hpp"
+#include "utils/ConfigManager.hpp"
+
+/**
+ * @class JobStatusWriter
+ * @brief Write-behind buffer for job status updates.
+ *
+ * Workers record status changes without touching the database. Only the latest status and message
+ * per job is kept, so a job that goes IN_PROGRESS and then COMPLETED before the next flush costs one
+ * UPDATE. A background thread writes the buffered updates as one batch every flush interval, as soon
+ * as the buffer holds maxPending jobs, or right away when a job reaches a terminal status (COMPLETED,
+ * FAILED, CANCELLED) so clients polling the job see the outcome without delay.
+ *
+ * Each update of a batch succeeds or fails on its own (see JobRepository::updateJobStatuses), so a
+ * single bad row cannot hold back the rest. Failed updates stay buffered and are retried after
+ * retryDelay, unless a newer status for the same job arrived in the meantime; after maxAttempts failed
+ * writes an update is logged and dropped. The destructor writes whatever is still buffered.
+ */
+class JobStatusWriter {
+public:
+    /**
+     * @brief Flush policy.
+     */
+    struct Settings {
+        std::chrono::milliseconds flushInterval{5};  ///< Longest time a non-terminal update stays buffered.
+        std::size_t maxPending = 256;                ///< Buffered jobs that trigger an early flush.
+        std::chrono::milliseconds retryDelay{1000};  ///< Pause after a failed flush before the next attempt.
+        std::size_t maxAttempts = 30;                ///< Failed writes of one update before it is dropped.
+    };
+
+    /**
+     * @brief Snapshot of the writer counters.
+     */
+    struct Metrics {
+        std::uint64_t updatesRecorded = 0;   ///< Calls to updateJobStatus.
+        std::uint64_t updatesCoalesced = 0;  ///< Updates replaced by a newer one for the same job before being written.
+        std::uint64_t updatesWritten = 0;    ///< Updates written to the repository.
+        std::uint64_t flushes = 0;           ///< Batches written in full.
+        std::uint64_t failedFlushes = 0;     ///< Batches in which some updates failed and stay buffered or were dropped.
+        std::uint64_t updatesDropped = 0;    ///< Updates given up on after maxAttempts failed writes.
+        std::uint64_t pending = 0;           ///< Jobs currently buffered.
+    };
+
+    /**
+     * @brief Starts the flush thread.
+     * @param repository Repository the updates are written to.
+     * @param settings Flush policy.
+     */
+    JobStatusWriter(std::shared_ptr<JobRepository> repository, const Settings& settings);
+
+    /**
+     * @brief Writes the buffered updates, then joins the flush thread.
+     */
+    ~JobStatusWriter();
+
+    JobStatusWriter(const JobStatusWriter&) = delete;
+    JobStatusWriter& operator=(const JobStatusWriter&) = delete;
+
+    /**
+     * @brief Records a job's new status. Never blocks on the database.
+     * @param jobId ID of the job to update.
+     * @param status New status for the job.
+     * @param message Optional message to associate with the job.
+     */
+    void updateJobStatus(int jobId, JobStatus status, const std::string& message = "");
+
+    /**
+     * @brief Writes every buffered update as one batch on the calling thread.
+     * @return True if the buffer was written; false if some updates failed and stay buffered or were dropped.
+     */
+    bool flush();
+
+    /**
+     * @brief Returns the current writer counters.
+     */
+    [[nodiscard]] Metrics getMetrics() const;
+
+    /**
+     * @brief Reads the flush policy from the "jobs.status_writer" configuration section.
+     * @param config Reference to the ConfigManager instance.
+     * @return The resulting Settings, with defaults for missing keys.
+     */
+    static Settings loadSettings(const ConfigManager& config);
+
+private:
+    /**
+     * @brief Latest buffered status of one job.
+     */
+    struct PendingUpdate {
+        std::string status;   ///< Status name as stored in the jobs table.
+        std::string message;  ///< Message to store with the status.
+        std::size_t attempts = 0;  ///< Failed writes of this status so far.
+    };
+
+    using PendingMap = std::unordered_map<int, PendingUpdate>;
+
+    /**
+     * @brief Flush thread: waits for a trigger or the interval, then writes the buffer.
+     */
+    void run();
+
+    static bool isTerminal(JobStatus status);
+
+    std::shared_ptr<JobRepository> m_repository;  ///< Destination of the buffered updates.
+    Settings m_settings;                          ///< Flush policy.
+
+    mutable std::mutex m_mutex;            ///< Guards the buffer and the flags below.
+    std::condition_variable m_condition;   ///< Wakes the flush thread early.
+    PendingMap m_pending;                  ///< Latest update per job, not yet written.
+    bool m_flushRequested = false;         ///< Set when a terminal update or a full buffer needs an immediate flush.
+    bool m_stopping = false;               ///< Set by the destructor to end the flush thread.
+    std::mutex m_writeMutex;               ///< Serializes writes so an older batch cannot overwrite a newer one.
+
+    Metrics m_metrics;                     ///< Counters, guarded by m_mutex; pending is filled in by getMetrics.
+    std::thread m_thread;                  ///< Flush thread.
+};
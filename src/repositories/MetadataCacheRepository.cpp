@@ -0,0 +1,160 @@
+#include "MetadataCacheRepository.hpp"
+#include "database/QueryBuilder.hpp"
+#include "utils/Base64.hpp"
+
+namespace {
+    /**
+     * @brief How stale last_used_at may get before a read refreshes it.
+     */
+    constexpr std::chrono::seconds kTouchInterval = std::chrono::hours(1);
+
+    int64_t secondsSinceEpoch(const std::chrono::system_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    }
+
+    std::string nowSeconds() {
+        return std::to_string(secondsSinceEpoch(std::chrono::system_clock::now()));
+    }
+}
+
+MetadataCacheRepository::MetadataCacheRepository(std::shared_ptr<IDatabase> database)
+    : m_database(std::move(database)) {}
+
+std::optional<std::string> MetadataCacheRepository::getMetadata(const std::string& cacheKey) const {
+        return lookup("metadata_cache", "metadata", cacheKey);
+}
+
+bool MetadataCacheRepository::saveMetadata(const std::string& cacheKey, const std::string& metadata) const {
+        return upsert("metadata_cache", "metadata", cacheKey, metadata);
+}
+
+void MetadataCacheRepository::saveMetadataAsync(const std::string& cacheKey, const std::string& metadata,
+                                                SaveCallback onDone) const {
+        const auto update = QueryBuilder(m_database->dialect())
+                                .update("metadata_cache")
+                                .set("metadata", metadata)
+                                .set("last_used_at", nowSeconds())
+                                .where("cache_key = ?", {cacheKey})
+                                .build();
+        auto insert = QueryBuilder(m_database->dialect())
+                          .insertInto("metadata_cache")
+                          .set("cache_key", cacheKey)
+                          .set("metadata", metadata)
+                          .set("last_used_at", nowSeconds())
+                          .build();
+
+        m_database->executeQueryAsync(
+            update.sql(), update.params,
+            [database = m_database, insert = std::move(insert), onDone = std::move(onDone)](const int updated) {
+                if (updated != 0) {
+                    onDone(updated > 0);
+                    return;
+                }
+                try {
+                    database->executeQueryAsync(insert.sql(), insert.params,
+                                                [onDone](const int inserted) { onDone(inserted > 0); });
+                } catch (const std::exception&) {
+                    onDone(false);  // Disconnected between the two statements
+                }
+            });
+}
+
+std::optional<std::string> MetadataCacheRepository::getKeyframeIndex(const std::string& cacheKey) const {
+        if (const auto encoded = lookup("keyframe_index", "data", cacheKey)) {
+            return Base64::decode(*encoded);
+        }
+        return std::nullopt;
+}
+
+bool MetadataCacheRepository::saveKeyframeIndex(const std::string& cacheKey, const std::string& index) const {
+        // Parameters are bound as text, so the binary index is stored base64-encoded
+        const std::string encoded = Base64::encode(index);
+
+        return upsert("keyframe_index", "data", cacheKey, encoded);
+}
+
+bool MetadataCacheRepository::upsert(const std::string& table, const std::string& valueColumn,
+                                     const std::string& cacheKey, const std::string& value) const {
+        // UPDATE-then-INSERT keeps the upsert portable across SQLite, PostgreSQL and MariaDB; running both
+        // on one pinned transaction makes it a single commit.
+        const auto transaction = m_database->beginTransaction();
+
+        const auto usedAt = nowSeconds();
+        const auto update = QueryBuilder(m_database->dialect())
+                                .update(table)
+                                .set(valueColumn, value)
+                                .set("last_used_at", usedAt)
+                                .where("cache_key = ?", {cacheKey})
+                                .build();
+        bool stored = transaction->executeQuery(update.sql(), update.params) > 0;
+        if (!stored) {
+            const auto insert = QueryBuilder(m_database->dialect())
+                                    .insertInto(table)
+                                    .set("cache_key", cacheKey)
+                                    .set(valueColumn, value)
+                                    .set("last_used_at", usedAt)
+                                    .build();
+            stored = transaction->executeQuery(insert.sql(), insert.params) > 0;
+        }
+
+        if (stored) {
+            transaction->commit();
+        } else {
+            transaction->rollback();
+        }
+        return stored;
+}
+
+void MetadataCacheRepository::prune(const std::chrono::system_clock::time_point unusedSince, PruneCallback onDone) const {
+        const auto cutoff = std::to_string(secondsSinceEpoch(unusedSince));
+        const auto metadata = QueryBuilder(m_database->dialect())
+                                  .deleteFrom("metadata_cache")
+                                  .where("last_used_at < ?", {cutoff})
+                                  .build();
+        auto keyframes = QueryBuilder(m_database->dialect())
+                             .deleteFrom("keyframe_index")
+                             .where("last_used_at < ?", {cutoff})
+                             .build();
+
+        m_database->executeQueryAsync(
+            metadata.sql(), metadata.params,
+            [database = m_database, keyframes = std::move(keyframes), onDone = std::move(onDone)](const int removedMetadata) {
+                if (removedMetadata < 0) {
+                    onDone(-1);
+                    return;
+                }
+                try {
+                    database->executeQueryAsync(keyframes.sql(), keyframes.params, [onDone, removedMetadata](const int removedIndexes) {
+                        onDone(removedIndexes < 0 ? -1 : removedMetadata + removedIndexes);
+                    });
+                } catch (const std::exception&) {
+                    onDone(-1);  // Disconnected between the two statements
+                }
+            });
+}
+
+std::optional<std::string> MetadataCacheRepository::lookup(const std::string& table, const std::string& valueColumn,
+                                                           const std::string& cacheKey) const {
+        const auto query = QueryBuilder(m_database->dialect())
+                               .select({valueColumn, "last_used_at"})
+                               .from(table)
+                               .where("cache_key = ?", {cacheKey})
+                               .build();
+
+        const auto result = m_database->fetchQuery(query.sql(), query.params);
+        if (result.empty() || result[0].empty()) {
+            return std::nullopt;
+        }
+
+        // A hit keeps the row from being pruned; the refresh need not hold up the lookup, nor succeed
+        const auto now = std::chrono::system_clock::now();
+        if (std::stoll(result[0][1]) < secondsSinceEpoch(now - kTouchInterval)) {
+            const auto touch = QueryBuilder(m_database->dialect())
+                                   .update(table)
+                                   .set("last_used_at", std::to_string(secondsSinceEpoch(now)))
+                                   .where("cache_key = ?", {cacheKey})
+                                   .build();
+            m_database->executeQueryAsync(touch.sql(), touch.params, [](int) {});
+        }
+        return result[0][0];
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include "database/interfaces/IDatabase.hpp"
+
+/**
+ * @class MetadataCacheRepository
+ * @brief Persists probed media metadata, keyed by a file or object identity, in the metadata_cache table,
+ * and keyframe indexes under the same keys in the keyframe_index table.
+ *
+ * Every row records when it was last stored or read in last_used_at, refreshed on reads at most once
+ * per hour so lookups rarely write. A modified or replaced file gets a new key and its old row is never
+ * read again, so prune() is what eventually removes it.
+ */
+class MetadataCacheRepository {
+public:
+    /**
+     * @brief Receives whether an asynchronous save stored the entry. Runs on the database's I/O thread.
+     */
+    using SaveCallback = std::function<void(bool stored)>;
+
+    /**
+     * @brief Receives the number of rows prune() deleted, or -1 if a delete failed. Runs on the database's I/O thread.
+     */
+    using PruneCallback = std::function<void(int removed)>;
+
+    /**
+     * @brief Constructs a MetadataCacheRepository with the specified database.
+     * @param database Shared pointer to the database interface.
+     */
+    explicit MetadataCacheRepository(std::shared_ptr<IDatabase> database);
+
+    /**
+     * @brief Looks up cached metadata.
+     * @param cacheKey Identity of the probed file or object.
+     * @return The serialized metadata if present, otherwise std::nullopt.
+     */
+    [[nodiscard]] std::optional<std::string> getMetadata(const std::string& cacheKey) const;
+
+    /**
+     * @brief Inserts or replaces cached metadata.
+     * @param cacheKey Identity of the probed file or object.
+     * @param metadata Serialized metadata.
+     * @return True if the entry was stored; otherwise, false.
+     */
+    [[nodiscard]] bool saveMetadata(const std::string& cacheKey, const std::string& metadata) const;
+
+    /**
+     * @brief Inserts or replaces cached metadata without waiting for the database.
+     *
+     * The UPDATE and the INSERT it may need are separate asynchronous statements rather than one
+     * transaction, so when two writers store a new key at once one INSERT fails; that writer reports
+     * false and the entry written by the other stays.
+     *
+     * @param cacheKey Identity of the probed file or object.
+     * @param metadata Serialized metadata.
+     * @param onDone Called once with the outcome; must not block.
+     * @throws std::runtime_error if the database is not connected.
+     */
+    void saveMetadataAsync(const std::string& cacheKey, const std::string& metadata, SaveCallback onDone) const;
+
+    /**
+     * @brief Looks up a stored keyframe index.
+     * @param cacheKey Identity of the probed file or object.
+     * @return The serialized KeyframeIndex if present, otherwise std::nullopt.
+     */
+    [[nodiscard]] std::optional<std::string> getKeyframeIndex(const std::string& cacheKey) const;
+
+    /**
+     * @brief Inserts or replaces a keyframe index.
+     * @param cacheKey Identity of the probed file or object.
+     * @param index Serialized KeyframeIndex (binary; stored base64-encoded).
+     * @return True if the entry was stored; otherwise, false.
+     */
+    [[nodiscard]] bool saveKeyframeIndex(const std::string& cacheKey, const std::string& index) const;
+
+    /**
+     * @brief Deletes, without waiting for the database, the metadata and keyframe indexes not used since a point in time.
+     * @param unusedSince Rows whose last_used_at is older are deleted.
+     * @param onDone Called once with the outcome; must not block.
+     * @throws std::runtime_error if the database is not connected.
+     */
+    void prune(std::chrono::system_clock::time_point unusedSince, PruneCallback onDone) const;
+
+private:
+    std::shared_ptr<IDatabase> m_database;
+
+    /**
+     * @brief Replaces the value stored under a key, or inserts it, in one transaction.
+     * @return True if the entry was stored; otherwise, false.
+     */
+    [[nodiscard]] bool upsert(const std::string& table, const std::string& valueColumn,
+                              const std::string& cacheKey, const std::string& value) const;
+
+    /**
+     * @brief Looks up the value stored under a key, refreshing the row's last_used_at if it is over an hour old.
+     * @return The value if present, otherwise std::nullopt.
+     */
+    [[nodiscard]] std::optional<std::string> lookup(const std::string& table, const std::string& valueColumn,
+                                                    const std::string& cacheKey) const;
+};
@@ -0,0 +1,68 @@
+#include "EdfJobQueue.hpp"
+
+#include <algorithm>
+#include <utility>
+
+EdfJobQueue::EdfJobQueue(const std::size_t parallelism, InFlightWork inFlightWork)
+    : m_parallelism(std::max<std::size_t>(1, parallelism)), m_inFlightWork(std::move(inFlightWork)), m_nextSequence(0) {}
+
+bool EdfJobQueue::push(const std::shared_ptr<Job>& job) {
+    Entry entry{job->getDeadline().value_or(std::chrono::system_clock::time_point::max()), m_nextSequence, job};
+
+    if (job->hasDeadline() && !isAdmissible(entry)) {
+        return false;
+    }
+
+    ++m_nextSequence;
+    m_entries.insert(std::move(entry));
+    return true;
+}
+
+std::shared_ptr<Job> EdfJobQueue::pop() {
+    if (m_entries.empty()) {
+        return nullptr;
+    }
+    auto job = m_entries.begin()->job;
+    m_entries.erase(m_entries.begin());
+    return job;
+}
+
+bool EdfJobQueue::isAdmissible(const Entry& candidate) const {
+    using Seconds = std::chrono::duration<double>;
+
+    const auto now = std::chrono::system_clock::now();
+    const auto parallelism = static_cast<double>(m_parallelism);
+    const double candidateWork = static_cast<double>(candidate.job->getEstimatedRuntime().count());
+
+    // Work queued ahead of a job is shared across the workers; the job itself runs on one. The running
+    // jobs finish first, since nothing preempts them.
+    double workAhead = m_inFlightWork ? m_inFlightWork().count() : 0.0;
+    auto it = m_entries.begin();
+    for (; it != m_entries.end() && *it < candidate; ++it) {
+        workAhead += static_cast<double>(it->job->getEstimatedRuntime().count());
+    }
+
+    const auto candidateFinish = now + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        Seconds(workAhead / parallelism + candidateWork));
+    if (candidateFinish > candidate.deadline) {
+        return false;
+    }
+
+    // Every later job is delayed by the candidate's share of the workers.
+    workAhead += candidateWork;
+    for (; it != m_entries.end(); ++it) {
+        if (!it->job->hasDeadline()) {
+            break;
+        }
+        const double work = static_cast<double>(it->job->getEstimatedRuntime().count());
+        const auto finishWithout = now + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            Seconds((workAhead - candidateWork) / parallelism + work));
+        const auto finishWith = now + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            Seconds(workAhead / parallelism + work));
+        if (finishWithout <= it->deadline && finishWith > it->deadline) {
+            return false;
+        }
+        workAhead += work;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include "interfaces/IJobQueue.hpp"
+
+/**
+ * @class EdfJobQueue
+ * @brief Earliest-deadline-first queue with SLA-based admission control.
+ *
+ * Jobs carrying a deadline are dispatched in deadline order, ahead of jobs without one, which
+ * keep their submission order. Admission simulates the EDF schedule using each job's estimated
+ * runtime spread across the worker parallelism, and rejects a job if it would finish after its
+ * own deadline or would push an already feasible queued job past its deadline. Jobs already running
+ * are not preempted, so the remaining work reported for them is scheduled ahead of every queued job.
+ */
+class EdfJobQueue final : public IJobQueue {
+public:
+    /**
+     * @brief Reports the estimated work left on the jobs the workers are running, in seconds.
+     *
+     * Called during push(), under the same lock as the queue itself.
+     */
+    using InFlightWork = std::function<std::chrono::duration<double>()>;
+
+    /**
+     * @brief Constructs an EdfJobQueue.
+     * @param parallelism Number of jobs the processor runs concurrently.
+     * @param inFlightWork Remaining work of the running jobs; none is assumed if empty.
+     */
+    explicit EdfJobQueue(std::size_t parallelism = 1, InFlightWork inFlightWork = {});
+
+    /**
+     * @brief Inserts the job in deadline order if the resulting schedule keeps every feasible deadline.
+     * @param job The job to admit. Its estimated runtime must already be set.
+     * @return false if the job was rejected.
+     */
+    bool push(const std::shared_ptr<Job>& job) override;
+
+    std::shared_ptr<Job> pop() override;
+
+    [[nodiscard]] bool empty() const override { return m_entries.empty(); }
+    [[nodiscard]] std::size_t size() const override { return m_entries.size(); }
+
+private:
+    struct Entry {
+        std::chrono::system_clock::time_point deadline;  ///< Job deadline, or time_point::max() if none.
+        std::uint64_t sequence;                          ///< Submission order, breaks deadline ties.
+        std::shared_ptr<Job> job;
+
+        bool operator<(const Entry& other) const {
+            return deadline != other.deadline ? deadline < other.deadline : sequence < other.sequence;
+        }
+    };
+
+    /**
+     * @brief Checks whether inserting the candidate keeps the simulated schedule within its deadlines.
+     */
+    [[nodiscard]] bool isAdmissible(const Entry& candidate) const;
+
+    std::set<Entry> m_entries;     ///< Queued jobs in EDF order.
+    std::size_t m_parallelism;     ///< Concurrent workers draining the queue.
+    InFlightWork m_inFlightWork;   ///< Remaining work of the running jobs.
+    std::uint64_t m_nextSequence;  ///< Sequence number for the next submitted job.
+};
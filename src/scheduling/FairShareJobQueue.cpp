@@ -0,0 +1,76 @@
+#include "FairShareJobQueue.hpp"
+
+#include <algorithm>
+
+FairShareJobQueue::FairShareJobQueue(QueueFactory queueFactory,
+                                     std::unordered_map<std::string, double> weights,
+                                     const double defaultWeight,
+                                     const std::chrono::seconds quantum)
+    : m_queueFactory(std::move(queueFactory)),
+      m_weights(std::move(weights)),
+      m_defaultWeight(defaultWeight > 0.0 ? defaultWeight : 1.0),
+      m_quantum(static_cast<double>(std::max<long long>(1, quantum.count()))),
+      m_creditGranted(false),
+      m_size(0) {}
+
+bool FairShareJobQueue::push(const std::shared_ptr<Job>& job) {
+    auto [it, inserted] = m_tenants.try_emplace(job->getTenant());
+    Tenant& tenant = it->second;
+    if (inserted) {
+        tenant.queue = m_queueFactory();
+        const auto weight = m_weights.find(job->getTenant());
+        tenant.weight = weight != m_weights.end() && weight->second > 0.0 ? weight->second : m_defaultWeight;
+    }
+
+    if (!tenant.queue->push(job)) {
+        if (tenant.queue->empty()) {
+            m_tenants.erase(it);
+        }
+        return false;
+    }
+
+    if (inserted) {
+        m_activeTenants.push_back(job->getTenant());
+    }
+    ++m_size;
+    return true;
+}
+
+std::shared_ptr<Job> FairShareJobQueue::pop() {
+    while (!m_activeTenants.empty()) {
+        const std::string& name = m_activeTenants.front();
+        Tenant& tenant = m_tenants.at(name);
+
+        if (!m_creditGranted) {
+            tenant.deficit += tenant.weight * m_quantum;
+            m_creditGranted = true;
+        }
+
+        if (tenant.deficit <= 0.0) {
+            advance();
+            continue;
+        }
+
+        auto job = tenant.queue->pop();
+        --m_size;
+        // Charge after dispatch so a job larger than the quantum still runs; the debt delays the tenant's next turn
+        tenant.deficit -= static_cast<double>(std::max<long long>(1, job->getEstimatedRuntime().count()));
+
+        if (tenant.queue->empty()) {
+            // Idle tenants neither bank credit nor carry debt into their next backlog
+            m_tenants.erase(name);
+            m_activeTenants.pop_front();
+            m_creditGranted = false;
+        } else if (tenant.deficit <= 0.0) {
+            advance();
+        }
+        return job;
+    }
+    return nullptr;
+}
+
+void FairShareJobQueue::advance() {
+    m_activeTenants.push_back(std::move(m_activeTenants.front()));
+    m_activeTenants.pop_front();
+    m_creditGranted = false;
+}
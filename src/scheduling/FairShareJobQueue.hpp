@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include "interfaces/IJobQueue.hpp"
+
+/**
+ * @class FairShareJobQueue
+ * @brief Weighted deficit round-robin over per-tenant sub-queues.
+ *
+ * Each tenant with queued work owns a sub-queue built by the supplied factory, so the per-tenant
+ * order can itself be FIFO or EDF. Tenants are visited in round-robin order; every visit grants a
+ * credit of weight * quantum seconds, and the tenant dispatches jobs while its credit is positive,
+ * each job costing its estimated runtime. Over time each backlogged tenant therefore receives
+ * encoder time in proportion to its weight, regardless of how many jobs other tenants queue.
+ */
+class FairShareJobQueue final : public IJobQueue {
+public:
+    using QueueFactory = std::function<std::unique_ptr<IJobQueue>()>;
+
+    /**
+     * @brief Constructs a FairShareJobQueue.
+     * @param queueFactory Creates the sub-queue for a tenant that becomes active.
+     * @param weights Configured weight per tenant.
+     * @param defaultWeight Weight for tenants without an explicit entry.
+     * @param quantum Encoder time granted per unit of weight on each round-robin visit.
+     */
+    FairShareJobQueue(QueueFactory queueFactory,
+                      std::unordered_map<std::string, double> weights,
+                      double defaultWeight = 1.0,
+                      std::chrono::seconds quantum = std::chrono::seconds(60));
+
+    /**
+     * @brief Queues the job on its tenant's sub-queue.
+     * @return false if the tenant's sub-queue rejected the job.
+     */
+    bool push(const std::shared_ptr<Job>& job) override;
+
+    /**
+     * @brief Removes the next job according to weighted deficit round-robin.
+     */
+    std::shared_ptr<Job> pop() override;
+
+    [[nodiscard]] bool empty() const override { return m_size == 0; }
+    [[nodiscard]] std::size_t size() const override { return m_size; }
+
+private:
+    struct Tenant {
+        std::unique_ptr<IJobQueue> queue;  ///< The tenant's pending jobs.
+        double weight = 1.0;               ///< Share of encoder time relative to other tenants.
+        double deficit = 0.0;              ///< Remaining credit, in seconds of encoder time.
+    };
+
+    /**
+     * @brief Moves the tenant at the head of the round-robin to the back.
+     */
+    void advance();
+
+    QueueFactory m_queueFactory;                          ///< Builds per-tenant sub-queues.
+    std::unordered_map<std::string, double> m_weights;    ///< Configured tenant weights.
+    double m_defaultWeight;                               ///< Weight for unconfigured tenants.
+    double m_quantum;                                     ///< Credit per unit of weight per visit, in seconds.
+    std::unordered_map<std::string, Tenant> m_tenants;    ///< Tenants with queued jobs.
+    std::deque<std::string> m_activeTenants;              ///< Round-robin order; the front is being served.
+    bool m_creditGranted;                                 ///< Whether the front tenant received its quantum this visit.
+    std::size_t m_size;                                   ///< Total queued jobs across tenants.
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <queue>
+#include "interfaces/IJobQueue.hpp"
+
+/**
+ * @class FifoJobQueue
+ * @brief Dispatches jobs in submission order and admits every job.
+ */
+class FifoJobQueue final : public IJobQueue {
+public:
+    bool push(const std::shared_ptr<Job>& job) override {
+        m_jobs.push(job);
+        return true;
+    }
+
+    std::shared_ptr<Job> pop() override {
+        if (m_jobs.empty()) {
+            return nullptr;
+        }
+        auto job = m_jobs.front();
+        m_jobs.pop();
+        return job;
+    }
+
+    [[nodiscard]] bool empty() const override { return m_jobs.empty(); }
+    [[nodiscard]] std::size_t size() const override { return m_jobs.size(); }
+
+private:
+    std::queue<std::shared_ptr<Job>> m_jobs;  ///< Jobs in submission order.
+};
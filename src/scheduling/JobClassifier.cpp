@@ -0,0 +1,67 @@
+#include "JobClassifier.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr long kMaxThumbnailFrames = 10;
+
+    // Options arrive as one or more command-line fragments; split them into individual arguments
+    std::vector<std::string> tokenize(const std::vector<std::string>& options) {
+        std::vector<std::string> tokens;
+        for (const auto& option : options) {
+            std::istringstream stream(option);
+            std::string token;
+            while (stream >> token) {
+                tokens.push_back(token);
+            }
+        }
+        return tokens;
+    }
+}
+
+JobClassifier::JobClassifier(const std::chrono::seconds lightRuntimeLimit)
+    : m_lightRuntimeLimit(lightRuntimeLimit) {}
+
+JobClassifier::CostClass JobClassifier::classify(const Job& job, const bool runtimeCalibrated) const {
+    if (hasLightOptions(job) || (runtimeCalibrated && job.getEstimatedRuntime() <= m_lightRuntimeLimit)) {
+        return CostClass::LIGHT;
+    }
+    return CostClass::STANDARD;
+}
+
+bool JobClassifier::hasLightOptions(const Job& job) {
+    const auto tokens = tokenize(job.getOptions());
+
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const auto& token = tokens[i];
+
+        // Audio-only output
+        if (token == "-vn") {
+            return true;
+        }
+
+        if (i + 1 >= tokens.size()) {
+            continue;
+        }
+        const auto& value = tokens[i + 1];
+
+        // Remux: the video stream is copied rather than re-encoded
+        if ((token == "-c" || token == "-codec" || token == "-c:v" || token == "-codec:v" || token == "-vcodec") && value == "copy") {
+            return true;
+        }
+
+        // Thumbnail or poster frame extraction
+        if (token == "-frames:v" || token == "-vframes") {
+            try {
+                if (std::stol(value) <= kMaxThumbnailFrames) {
+                    return true;
+                }
+            } catch (const std::exception&) {
+                // Not a frame count; ignore
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include "models/Job.hpp"
+
+/**
+ * @class JobClassifier
+ * @brief Separates cheap jobs, which can run on the fast lane, from regular encodes.
+ *
+ * A job is considered light if its options describe an audio-only transcode (-vn), a remux
+ * (video stream copy), or a thumbnail extraction (a handful of output frames), or if its
+ * estimated runtime is within the configured limit. The runtime rule only applies to estimates
+ * backed by measurements: an uncalibrated estimator or an input of unknown size yields a guess,
+ * and routing guesses to the small fast lane would let long encodes block it.
+ */
+class JobClassifier {
+public:
+    enum class CostClass {
+        STANDARD,  ///< Regular encode, served by the main worker pool.
+        LIGHT      ///< Short job, served by the fast lane.
+    };
+
+    /**
+     * @brief Constructs a JobClassifier.
+     * @param lightRuntimeLimit Jobs estimated to finish within this time are light regardless of their options.
+     */
+    explicit JobClassifier(std::chrono::seconds lightRuntimeLimit);
+
+    /**
+     * @brief Classifies a job. Its estimated runtime must already be set.
+     * @param runtimeCalibrated Whether the estimate is measured rather than a guess; see RuntimeEstimator::isCalibrated.
+     */
+    [[nodiscard]] CostClass classify(const Job& job, bool runtimeCalibrated) const;
+
+private:
+    /**
+     * @brief Checks whether the ffmpeg options describe one of the inherently cheap job kinds.
+     */
+    static bool hasLightOptions(const Job& job);
+
+    std::chrono::seconds m_lightRuntimeLimit;  ///< Runtime threshold for light jobs.
+};
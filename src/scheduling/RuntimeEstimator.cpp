@@ -0,0 +1,48 @@
+#include "RuntimeEstimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <system_error>
+
+RuntimeEstimator::RuntimeEstimator(const double initialBytesPerSecond, const std::chrono::seconds initialRuntime, const double smoothing)
+    : m_bytesPerSecond(initialBytesPerSecond),
+      m_averageSeconds(static_cast<double>(initialRuntime.count())),
+      m_smoothing(std::clamp(smoothing, 0.01, 1.0)) {}
+
+std::chrono::seconds RuntimeEstimator::estimate(const Job& job) const {
+    const auto size = inputSize(job);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const double seconds = size > 0 ? static_cast<double>(size) / m_bytesPerSecond : m_averageSeconds;
+    return std::chrono::seconds(std::max<long long>(1, std::llround(seconds)));
+}
+
+void RuntimeEstimator::record(const Job& job, const std::chrono::steady_clock::duration elapsed) {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    if (seconds <= 0.0) {
+        return;
+    }
+    const auto size = inputSize(job);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (size > 0) {
+        m_bytesPerSecond += m_smoothing * (static_cast<double>(size) / seconds - m_bytesPerSecond);
+        ++m_sizedSamples;
+    }
+    m_averageSeconds += m_smoothing * (seconds - m_averageSeconds);
+}
+
+bool RuntimeEstimator::isCalibrated(const Job& job) const {
+    if (inputSize(job) == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sizedSamples > 0;
+}
+
+std::uintmax_t RuntimeEstimator::inputSize(const Job& job) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(job.getInputFile(), ec);
+    return ec ? 0 : size;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include "models/Job.hpp"
+
+/**
+ * @class RuntimeEstimator
+ * @brief Predicts how long an encoding job will take from the throughput observed on completed jobs.
+ *
+ * The estimator keeps an exponentially weighted moving average of the encoding throughput
+ * (input bytes per second of wall time). Jobs whose input size cannot be determined, such as
+ * remote inputs, fall back to the moving average of the job runtime itself.
+ */
+class RuntimeEstimator {
+public:
+    /**
+     * @brief Constructs a RuntimeEstimator.
+     * @param initialBytesPerSecond Throughput assumed until the first job completes.
+     * @param initialRuntime Runtime assumed for jobs with an unknown input size until the first job completes.
+     * @param smoothing Weight given to each new observation, in (0, 1].
+     */
+    explicit RuntimeEstimator(double initialBytesPerSecond = 4.0 * 1024 * 1024,
+                              std::chrono::seconds initialRuntime = std::chrono::seconds(60),
+                              double smoothing = 0.2);
+
+    /**
+     * @brief Estimates the wall time needed to encode a job.
+     * @param job The job to estimate.
+     * @return The estimated runtime, never less than one second.
+     */
+    [[nodiscard]] std::chrono::seconds estimate(const Job& job) const;
+
+    /**
+     * @brief Feeds the measured runtime of a successfully completed job back into the model.
+     * @param job The completed job.
+     * @param elapsed The wall time the encode took.
+     */
+    void record(const Job& job, std::chrono::steady_clock::duration elapsed);
+
+    /**
+     * @brief Checks whether the estimate for a job is backed by measurements: its input size is known
+     * and at least one job of known size has completed. Other estimates are only the initial guesses.
+     */
+    [[nodiscard]] bool isCalibrated(const Job& job) const;
+
+private:
+    /**
+     * @brief Returns the size of the job's input file, or 0 if it is not a readable local file.
+     */
+    static std::uintmax_t inputSize(const Job& job);
+
+    double m_bytesPerSecond;        ///< Smoothed encoding throughput.
+    double m_averageSeconds;        ///< Smoothed runtime for jobs with unknown input size.
+    double m_smoothing;             ///< EWMA weight for new observations.
+    uint64_t m_sizedSamples = 0;    ///< Completed jobs of known input size fed into m_bytesPerSecond.
+    mutable std::mutex m_mutex;     ///< Guards the smoothed values.
+};
@@ -0,0 +1,36 @@
+#include "TenantResolver.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include "utils/ConfigManager.hpp"
+#include "utils/Sha256.hpp"
+
+namespace {
+    // 64 bits of the digest keep unmapped keys apart without making them recoverable
+    constexpr size_t kUnmappedDigestPrefix = 16;
+}
+
+TenantResolver::TenantResolver(std::unordered_map<std::string, std::string> tenantsByKeyDigest) {
+    for (auto& [digest, tenant] : tenantsByKeyDigest) {
+        std::string normalized = digest;
+        std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+                       [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        m_tenantsByKeyDigest.emplace(std::move(normalized), std::move(tenant));
+    }
+}
+
+TenantResolver TenantResolver::fromConfig() {
+    return TenantResolver(ConfigManager::getInstance().get<std::unordered_map<std::string, std::string>>(
+        "scheduler.fair_share.api_key_tenants", {}));
+}
+
+std::string TenantResolver::resolve(const std::string& apiKey, const std::string& clientId) const {
+    if (apiKey.empty()) {
+        return clientId;
+    }
+    const std::string digest = Sha256::hexDigest(apiKey);
+    if (const auto it = m_tenantsByKeyDigest.find(digest); it != m_tenantsByKeyDigest.end()) {
+        return it->second;
+    }
+    return "key-" + digest.substr(0, kUnmappedDigestPrefix);
+}
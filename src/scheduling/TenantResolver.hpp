@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+/**
+ * @class TenantResolver
+ * @brief Turns the credentials a request presents into the tenant name used for fair-share scheduling.
+ *
+ * API keys are secrets, so they never become tenant names themselves: a key is identified by its
+ * SHA-256 digest, which configuration maps to a tenant name. Keys without a mapping get a name derived
+ * from a prefix of the digest, so they are still scheduled apart from each other without the key
+ * appearing in scheduler state or logs.
+ */
+class TenantResolver {
+public:
+    /**
+     * @param tenantsByKeyDigest Tenant name per API key, keyed by the lowercase hex SHA-256 of the key.
+     */
+    explicit TenantResolver(std::unordered_map<std::string, std::string> tenantsByKeyDigest);
+
+    /**
+     * @brief Builds a resolver from "scheduler.fair_share.api_key_tenants".
+     */
+    static TenantResolver fromConfig();
+
+    /**
+     * @brief Returns the tenant of a request.
+     * @param apiKey Value of the `X-API-Key` header; empty if absent.
+     * @param clientId Value of the `X-Client-Id` header, used as is when there is no API key; empty if absent.
+     * @return The tenant name, or an empty string for anonymous requests.
+     */
+    [[nodiscard]] std::string resolve(const std::string& apiKey, const std::string& clientId) const;
+
+private:
+    std::unordered_map<std::string, std::string> m_tenantsByKeyDigest;  ///< Configured tenant per key digest.
+};
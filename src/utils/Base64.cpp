@@ -0,0 +1,81 @@
+#include "Base64.hpp"
+
+#include <array>
+
+namespace Base64 {
+
+namespace {
+
+ constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+ constexpr std::array<int, 256> makeReverseTable() {
+     std::array<int, 256> table{};
+     for (auto& entry : table) {
+         entry = -1;
+     }
+     for (int i = 0; i < 64; ++i) {
+         table[static_cast<unsigned char>(kAlphabet[i])] = i;
+     }
+     return table;
+ }
+
+ constexpr auto kReverse = makeReverseTable();
+
+} // namespace
+
+std::string encode(const std::string& data) {
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+
+    std::size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        const auto chunk = static_cast<unsigned char>(data[i]) << 16 | static_cast<unsigned char>(data[i + 1]) << 8 |
+                           static_cast<unsigned char>(data[i + 2]);
+        out.push_back(kAlphabet[chunk >> 18 & 0x3F]);
+        out.push_back(kAlphabet[chunk >> 12 & 0x3F]);
+        out.push_back(kAlphabet[chunk >> 6 & 0x3F]);
+        out.push_back(kAlphabet[chunk & 0x3F]);
+    }
+
+    if (const std::size_t rest = data.size() - i; rest > 0) {
+        auto chunk = static_cast<unsigned char>(data[i]) << 16;
+        if (rest == 2) {
+            chunk |= static_cast<unsigned char>(data[i + 1]) << 8;
+        }
+        out.push_back(kAlphabet[chunk >> 18 & 0x3F]);
+        out.push_back(kAlphabet[chunk >> 12 & 0x3F]);
+        out.push_back(rest == 2 ? kAlphabet[chunk >> 6 & 0x3F] : '=');
+        out.push_back('=');
+    }
+    return out;
+}
+
+std::optional<std::string> decode(const std::string& text) {
+    if (text.size() % 4 != 0) {
+        return std::nullopt;
+    }
+
+    std::string out;
+    out.reserve(text.size() / 4 * 3);
+
+    for (std::size_t i = 0; i < text.size(); i += 4) {
+        const bool last = i + 4 == text.size();
+        const int padding = last ? (text[i + 3] == '=') + (text[i + 2] == '=') : 0;
+
+        int chunk = 0;
+        for (int j = 0; j < 4 - padding; ++j) {
+            const int value = kReverse[static_cast<unsigned char>(text[i + j])];
+            if (value < 0) {
+                return std::nullopt;
+            }
+            chunk |= value << (18 - 6 * j);
+        }
+
+        out.push_back(static_cast<char>(chunk >> 16 & 0xFF));
+        if (padding < 2) out.push_back(static_cast<char>(chunk >> 8 & 0xFF));
+        if (padding < 1) out.push_back(static_cast<char>(chunk & 0xFF));
+    }
+    return out;
+}
+
+} // namespace Base64
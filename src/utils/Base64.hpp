@@ -0,0 +1,18 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+/**
+ * @brief Standard (RFC 4648) base64, used to store binary blobs through the text-only IDatabase API.
+ */
+namespace Base64 {
+
+ std::string encode(const std::string& data);
+
+ /**
+  * @return The decoded bytes, or std::nullopt if the input is not valid padded base64.
+  */
+ std::optional<std::string> decode(const std::string& text);
+
+} // namespace Base64
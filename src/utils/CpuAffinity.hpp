@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @brief Helpers for restricting worker threads, and the encoder processes they spawn, to a set of CPUs.
+ *
+ * Child processes inherit the affinity of the thread that forks them, so pinning a worker thread
+ * also pins every ffmpeg it launches. On platforms without affinity support the helpers are no-ops.
+ */
+namespace CpuAffinity {
+
+ /**
+  * @brief Lists the CPUs this process is allowed to run on.
+  * @return CPU indices in ascending order; empty if they cannot be determined.
+  */
+ std::vector<int> availableCpus();
+
+ /**
+  * @brief Restricts the calling thread to the given CPUs.
+  * @param cpus CPU indices; an empty list leaves the affinity unchanged.
+  * @return true if the affinity was applied.
+  */
+ bool pinCurrentThread(const std::vector<int>& cpus);
+
+} // namespace CpuAffinity
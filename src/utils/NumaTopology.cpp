@@ -0,0 +1,94 @@
+#include "NumaTopology.hpp"
+#include "utils/Logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // From <numaif.h>; declared here to avoid a libnuma dependency for a single syscall
+    constexpr int kMpolPreferred = 1;
+}
+
+NumaTopology NumaTopology::discover(const std::string& sysfsRoot) {
+    NumaTopology topology;
+
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(sysfsRoot, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), [](const unsigned char c) { return std::isdigit(c); })) {
+            continue;
+        }
+
+        std::ifstream cpuList(it->path() / "cpulist");
+        std::string text;
+        if (!cpuList || !std::getline(cpuList, text)) {
+            continue;
+        }
+
+        if (auto cpus = parseCpuList(text); !cpus.empty()) {
+            topology.m_nodes.push_back({std::stoi(name.substr(4)), std::move(cpus)});
+        }
+    }
+
+    std::sort(topology.m_nodes.begin(), topology.m_nodes.end(),
+              [](const Node& a, const Node& b) { return a.id < b.id; });
+    return topology;
+}
+
+std::vector<int> NumaTopology::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::istringstream stream(list);
+    std::string range;
+
+    while (std::getline(stream, range, ',')) {
+        try {
+            if (const auto dash = range.find('-'); dash == std::string::npos) {
+                cpus.push_back(std::stoi(range));
+            } else {
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+        } catch (const std::exception&) {
+            // Blank or malformed entry (e.g. the trailing newline); skip it
+        }
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+bool NumaTopology::preferNodeMemory(const int nodeId) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    constexpr int kBitsPerWord = static_cast<int>(sizeof(unsigned long) * 8);
+    if (nodeId < 0 || nodeId >= 16 * kBitsPerWord) {
+        return false;
+    }
+
+    unsigned long mask[16] = {};
+    mask[nodeId / kBitsPerWord] = 1UL << (nodeId % kBitsPerWord);
+    if (syscall(SYS_set_mempolicy, kMpolPreferred, mask, sizeof(mask) * 8) != 0) {
+        Logger::getInstance().warn("Failed to set NUMA memory policy for node " + std::to_string(nodeId) + ": " +
+                                   std::strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    (void) nodeId;
+    return false;
+#endif
+}
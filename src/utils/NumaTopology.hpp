@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @class NumaTopology
+ * @brief NUMA nodes of the host and their CPUs, as reported by sysfs.
+ *
+ * Used to keep each encode on one socket: a worker thread is pinned to a node's CPUs and given a
+ * preference for that node's memory, and every ffmpeg it spawns inherits both. Hosts with a single
+ * node, or without sysfs NUMA information, report isMultiNode() == false and need no placement.
+ */
+class NumaTopology {
+public:
+    struct Node {
+        int id;                 ///< NUMA node number.
+        std::vector<int> cpus;  ///< CPUs belonging to the node, ascending.
+    };
+
+    /**
+     * @brief Reads the topology from sysfs.
+     * @param sysfsRoot Directory containing the nodeN entries.
+     * @return The discovered topology; empty if sysfs has no NUMA information.
+     */
+    static NumaTopology discover(const std::string& sysfsRoot = "/sys/devices/system/node");
+
+    /**
+     * @brief Parses a sysfs CPU list such as "0-3,8,10-11".
+     * @param list The CPU list text.
+     * @return The listed CPU indices, ascending; malformed ranges are skipped.
+     */
+    static std::vector<int> parseCpuList(const std::string& list);
+
+    /**
+     * @brief Prefers memory from the given node for allocations made by the calling thread and its children.
+     * @param nodeId The NUMA node number.
+     * @return true if the memory policy was applied.
+     */
+    static bool preferNodeMemory(int nodeId);
+
+    [[nodiscard]] const std::vector<Node>& nodes() const { return m_nodes; }
+    [[nodiscard]] bool isMultiNode() const { return m_nodes.size() > 1; }
+
+private:
+    std::vector<Node> m_nodes;  ///< Nodes that have at least one CPU, by id.
+};
@@ -0,0 +1,186 @@
+#include "ProcessRunner.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ProcessRunner {
+
+namespace {
+
+ // Upper bound on a single poll() so that the cancel flag is noticed promptly
+ constexpr std::chrono::milliseconds kPollInterval{50};
+
+} // namespace
+
+Result run(const std::vector<std::string>& argv,
+           const std::chrono::steady_clock::time_point deadline,
+           const std::atomic<bool>* cancelled,
+           const OutputHandler& onOutput) {
+    if (argv.empty()) {
+        throw std::invalid_argument("ProcessRunner needs a program to run");
+    }
+
+    // Built before fork: the child may only call async-signal-safe functions
+    std::vector<char*> args;
+    args.reserve(argv.size() + 1);
+    for (const auto& arg : argv) {
+        args.push_back(const_cast<char*>(arg.c_str()));
+    }
+    args.push_back(nullptr);
+
+    // Close-on-exec, so children forked concurrently by other threads do not inherit the write end and
+    // hold off EOF; dup2 clears the flag on the child's own stdout
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        throw std::runtime_error("Failed to create pipe for command");
+    }
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        throw std::runtime_error("Failed to start command");
+    }
+
+    if (pid == 0) {
+        // Own process group, so a kill also reaches whatever the program spawns
+        setpgid(0, 0);
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execvp(args[0], args.data());
+        _exit(127);
+    }
+
+    setpgid(pid, pid);
+    close(fds[1]);
+
+    Result result;
+    char buffer[4096];
+    pollfd pfd{fds[0], POLLIN, 0};
+
+    while (true) {
+        if (cancelled && cancelled->load()) {
+            result.cancelled = true;
+            break;
+        }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            result.timedOut = true;
+            break;
+        }
+
+        const int ready = poll(&pfd, 1, static_cast<int>(std::min(remaining, kPollInterval).count()));
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        const ssize_t bytes = read(fds[0], buffer, sizeof(buffer));
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            break;  // EOF: the command closed stdout
+        }
+        if (onOutput) {
+            onOutput(std::string_view(buffer, static_cast<std::size_t>(bytes)));
+        } else {
+            result.output.append(buffer, static_cast<std::size_t>(bytes));
+        }
+    }
+
+    close(fds[0]);
+
+    // The command may keep running after closing stdout, so reaping is bounded by the same deadline
+    int status = 0;
+    bool killed = false;
+    while (true) {
+        if (!killed && (result.timedOut || result.cancelled)) {
+            kill(-pid, SIGKILL);
+            killed = true;
+        }
+
+        const pid_t reaped = waitpid(pid, &status, killed ? 0 : WNOHANG);
+        if (reaped == pid || (reaped < 0 && errno != EINTR)) {
+            break;
+        }
+        if (reaped == 0) {
+            if (cancelled && cancelled->load()) {
+                result.cancelled = true;
+            } else if (std::chrono::steady_clock::now() >= deadline) {
+                result.timedOut = true;
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+    }
+
+    if (!killed && WIFEXITED(status)) {
+        result.exitCode = WEXITSTATUS(status);
+    }
+
+    return result;
+}
+
+std::vector<std::string> splitArguments(const std::string& fragment) {
+    std::vector<std::string> arguments;
+    std::string current;
+    bool inArgument = false;
+    char quote = 0;
+
+    for (std::size_t i = 0; i < fragment.size(); ++i) {
+        const char c = fragment[i];
+        if (quote == '\'') {
+            if (c == '\'') {
+                quote = 0;
+            } else {
+                current += c;
+            }
+        } else if (quote == '"') {
+            if (c == '"') {
+                quote = 0;
+            } else if (c == '\\' && i + 1 < fragment.size() &&
+                       (fragment[i + 1] == '"' || fragment[i + 1] == '\\' || fragment[i + 1] == '$' || fragment[i + 1] == '`')) {
+                current += fragment[++i];
+            } else {
+                current += c;
+            }
+        } else if (c == ' ' || c == '\t' || c == '\n') {
+            if (inArgument) {
+                arguments.push_back(std::move(current));
+                current.clear();
+                inArgument = false;
+            }
+        } else {
+            inArgument = true;
+            if (c == '\'' || c == '"') {
+                quote = c;
+            } else if (c == '\\' && i + 1 < fragment.size()) {
+                current += fragment[++i];
+            } else {
+                current += c;
+            }
+        }
+    }
+
+    if (quote) {
+        throw std::invalid_argument("Unterminated quote in arguments: " + fragment);
+    }
+    if (inArgument) {
+        arguments.push_back(std::move(current));
+    }
+    return arguments;
+}
+
+} // namespace ProcessRunner
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Runs a program and captures its standard output under a deadline.
+ *
+ * The program is executed directly with its argument vector, never through a shell, so arguments
+ * such as file paths or URLs are passed verbatim whatever characters they contain. Unlike popen(),
+ * a program that outlives its deadline (or is cancelled) is killed together with any children it
+ * spawned, so a hung tool cannot block the caller indefinitely.
+ */
+namespace ProcessRunner {
+
+ /**
+  * @brief Outcome of a command run.
+  */
+ struct Result {
+  std::string output;     ///< Everything the command wrote to stdout before it exited or was killed
+  int exitCode = -1;      ///< Exit status, or -1 if the command did not exit normally
+  bool timedOut = false;  ///< The deadline passed and the command was killed
+  bool cancelled = false; ///< The cancel flag was raised and the command was killed
+ };
+
+ /**
+  * @brief Receives standard output as it arrives, in chunks of arbitrary size.
+  */
+ using OutputHandler = std::function<void(std::string_view chunk)>;
+
+ /**
+  * @brief Runs a program, looked up in PATH if its name has no slash.
+  * @param argv The program name followed by its arguments.
+  * @param deadline Point in time after which the command is killed.
+  * @param cancelled Optional flag polled while waiting; raising it kills the command.
+  * @param onOutput Optional handler given stdout as it is read, instead of collecting it in Result::output.
+  * @return The captured output and how the command ended; exit code 127 if the program could not be executed.
+  * @throws std::invalid_argument if argv is empty.
+  * @throws std::runtime_error if the process cannot be started.
+  */
+ Result run(const std::vector<std::string>& argv,
+            std::chrono::steady_clock::time_point deadline,
+            const std::atomic<bool>* cancelled = nullptr,
+            const OutputHandler& onOutput = nullptr);
+
+ /**
+  * @brief Splits a command-line fragment into arguments the way a POSIX shell splits words.
+  *
+  * Single quotes, double quotes and backslashes group and escape characters; nothing is expanded,
+  * so `$(...)`, backticks, globs and operators such as `;` are ordinary characters.
+  *
+  * @throws std::invalid_argument if a quote is not closed.
+  */
+ std::vector<std::string> splitArguments(const std::string& fragment);
+
+} // namespace ProcessRunner
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @brief SHA-256 (FIPS 180-4), used to refer to secrets such as API keys without storing them.
+ */
+namespace Sha256 {
+
+ /**
+  * @return The 32-byte digest of `data` as 64 lowercase hex characters.
+  */
+ std::string hexDigest(const std::string& data);
+
+} // namespace Sha256
@@ -0,0 +1,54 @@
+#include "ThreadPool.hpp"
+#include "utils/Logger.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(const std::size_t threadCount) {
+    const std::size_t count = std::max<std::size_t>(1, threadCount);
+    m_workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return;  // Stopping and drained
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            Logger::getInstance().error("Thread pool task failed: " + std::string(e.what()));
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads draining a FIFO task queue.
+ *
+ * The pool bounds how many tasks run at once; submitted tasks wait in the queue until a worker is free.
+ * Tasks must not throw; exceptions escaping a task are logged and swallowed.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threadCount Number of workers; at least one is started.
+     */
+    explicit ThreadPool(std::size_t threadCount);
+
+    /**
+     * @brief Runs the tasks already queued, then joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task for execution on a worker thread.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @return Number of worker threads.
+     */
+    [[nodiscard]] std::size_t size() const { return m_workers.size(); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
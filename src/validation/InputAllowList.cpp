@@ -0,0 +1,141 @@
+#include "InputAllowList.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include "utils/ConfigManager.hpp"
+#include "validation/ValidationUtils.hpp"
+
+namespace {
+    std::string toLower(std::string value) {
+        std::transform(value.begin(), value.end(), value.begin(),
+                       [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return value;
+    }
+
+    std::vector<std::string> toLower(std::vector<std::string> values) {
+        for (auto& value : values) {
+            value = toLower(std::move(value));
+        }
+        return values;
+    }
+
+    // RFC 3986 scheme: a letter followed by letters, digits, '+', '-' or '.'
+    bool isScheme(const std::string& value) {
+        return !value.empty() && std::isalpha(static_cast<unsigned char>(value.front())) &&
+               std::all_of(value.begin(), value.end(), [](const unsigned char c) {
+                   return std::isalnum(c) || c == '+' || c == '-' || c == '.';
+               });
+    }
+
+    // True if path is root or lies below it; both must be normalized
+    bool isWithin(const std::filesystem::path& path, const std::filesystem::path& root) {
+        auto rootIt = root.begin();
+        auto pathIt = path.begin();
+        for (; rootIt != root.end(); ++rootIt, ++pathIt) {
+            if (rootIt->empty()) {
+                continue;  // Trailing separator of the root
+            }
+            if (pathIt == path.end() || *pathIt != *rootIt) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+namespace Validation {
+
+InputAllowList::InputAllowList(const std::vector<std::string>& roots, std::vector<std::string> schemes,
+                               std::vector<std::string> hosts)
+    : m_schemes(toLower(std::move(schemes))), m_hosts(toLower(std::move(hosts))) {
+    for (const auto& root : roots) {
+        std::error_code error;
+        auto canonical = std::filesystem::weakly_canonical(root, error);
+        if (error || !canonical.is_absolute()) {
+            throw std::invalid_argument("Allowed input root must be an absolute path: " + root);
+        }
+        m_roots.push_back(std::move(canonical));
+    }
+}
+
+InputAllowList InputAllowList::fromConfig() {
+    const auto& config = ConfigManager::getInstance();
+    return InputAllowList(config.get<std::vector<std::string>>("metadata.inputs.allowed_roots", {}),
+                          config.get<std::vector<std::string>>("metadata.inputs.allowed_schemes", {"http", "https"}),
+                          config.get<std::vector<std::string>>("metadata.inputs.allowed_hosts", {}));
+}
+
+void InputAllowList::check(const std::string& input) const {
+    if (input.empty()) {
+        throw ValidationException("input is empty");
+    }
+    if (input.front() == '-') {
+        throw ValidationException("input must not start with '-'");
+    }
+    if (const auto schemeEnd = input.find("://");
+        schemeEnd != std::string::npos && isScheme(input.substr(0, schemeEnd))) {
+        checkUrl(input, schemeEnd);
+    } else {
+        checkPath(input);
+    }
+}
+
+void InputAllowList::checkUrl(const std::string& input, const std::size_t schemeEnd) const {
+    const std::string scheme = toLower(input.substr(0, schemeEnd));
+    if (std::find(m_schemes.begin(), m_schemes.end(), scheme) == m_schemes.end()) {
+        throw ValidationException("URL scheme is not allowed");
+    }
+
+    // Parsers disagree on where such URLs' hosts end
+    if (std::any_of(input.begin(), input.end(), [](const unsigned char c) { return c <= ' ' || c == '\\' || c == 0x7F; })) {
+        throw ValidationException("URL contains whitespace, control characters or backslashes");
+    }
+
+    // Authority is everything up to the path, query or fragment; drop credentials and port
+    const auto authorityStart = schemeEnd + 3;
+    const auto authorityEnd = input.find_first_of("/?#", authorityStart);
+    std::string host = input.substr(authorityStart, authorityEnd == std::string::npos ? std::string::npos
+                                                                                     : authorityEnd - authorityStart);
+    if (const auto at = host.rfind('@'); at != std::string::npos) {
+        host.erase(0, at + 1);
+    }
+    if (!host.empty() && host.front() == '[') {
+        host = host.substr(0, host.find(']') + 1);  // IPv6 literal keeps its brackets
+    } else if (const auto colon = host.find(':'); colon != std::string::npos) {
+        host.erase(colon);
+    }
+    host = toLower(std::move(host));
+    if (host.empty()) {
+        throw ValidationException("URL has no host");
+    }
+
+    const bool allowed = std::any_of(m_hosts.begin(), m_hosts.end(), [&host](const std::string& pattern) {
+        if (pattern.rfind("*.", 0) == 0) {
+            const auto suffix = pattern.substr(1);
+            return host.size() > suffix.size() && host.compare(host.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+        return host == pattern;
+    });
+    if (!allowed) {
+        throw ValidationException("URL host is not allowed");
+    }
+}
+
+void InputAllowList::checkPath(const std::string& input) const {
+    if (input.front() != '/') {
+        throw ValidationException("local input must be an absolute path");
+    }
+    std::error_code error;
+    const auto resolved = std::filesystem::weakly_canonical(input, error);
+    if (error) {
+        throw ValidationException("local input path cannot be resolved");
+    }
+    const bool allowed = std::any_of(m_roots.begin(), m_roots.end(),
+                                     [&resolved](const std::filesystem::path& root) { return isWithin(resolved, root); });
+    if (!allowed) {
+        throw ValidationException("local input is outside the allowed directories");
+    }
+}
+
+} // namespace Validation
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Validation {
+
+ /**
+  * @class InputAllowList
+  * @brief Decides which client-supplied inputs the server may open.
+  *
+  * Local inputs must be absolute paths that resolve, symlinks included, inside one of the configured
+  * roots. Remote inputs must be URLs whose scheme and host are both listed. Anything else, such as a
+  * relative path, an ffmpeg protocol prefix (`concat:`, `pipe:`) or a value starting with '-' that a
+  * tool would read as an option, is rejected. An empty root or host list rejects every local or
+  * remote input respectively.
+  */
+ class InputAllowList {
+ public:
+  /**
+   * @param roots Directories local inputs must lie in.
+   * @param schemes URL schemes remote inputs may use, e.g. "https".
+   * @param hosts Hosts remote inputs may name; "*.example.com" also matches any subdomain.
+   */
+  InputAllowList(const std::vector<std::string>& roots, std::vector<std::string> schemes,
+                 std::vector<std::string> hosts);
+
+  /**
+   * @brief Builds an allow-list from "metadata.inputs.allowed_roots", "allowed_schemes" and "allowed_hosts".
+   */
+  static InputAllowList fromConfig();
+
+  /**
+   * @brief Checks one input.
+   * @throws ValidationException naming the rule the input breaks.
+   */
+  void check(const std::string& input) const;
+
+ private:
+  void checkUrl(const std::string& input, std::size_t schemeEnd) const;
+  void checkPath(const std::string& input) const;
+
+  std::vector<std::filesystem::path> m_roots;  ///< Canonical allowed directories.
+  std::vector<std::string> m_schemes;          ///< Lowercase allowed URL schemes.
+  std::vector<std::string> m_hosts;            ///< Lowercase allowed hosts and "*." wildcards.
+ };
+
+} // namespace Validation